@@ -27,6 +27,7 @@
 #include "Galois/config.h"
 #include "Galois/Galois.h"
 #include "Galois/Accumulator.h"
+#include "Galois/NoDerefIterator.h"
 #include "Galois/Timer.h"
 #include "Galois/Statistic.h"
 #include "Galois/Graph/LCGraph.h"
@@ -55,6 +56,7 @@ static cll::opt<std::string> filename(cll::Positional, cll::desc("<input graph>"
 static cll::opt<std::string> transposeGraphName("graphTranspose", cll::desc("Transpose of input graph"));
 static cll::opt<bool> symmetricGraph("symmetricGraph", cll::desc("Input graph is symmetric"));
 static cll::opt<unsigned int> startNode("startNode", cll::desc("Node to start search from"), cll::init(0));
+static cll::opt<int> nestedDegree("nestedDegree", cll::desc("Expand nodes with more out-edges than this in parallel"), cll::init(1024));
 static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
     cll::values(
       clEnumValN(Algo::async, "async", "Async Algorithm"),
@@ -85,10 +87,9 @@ void readInOutGraph(Graph& graph) {
   using namespace Galois::Graph;
   if (symmetricGraph) {
     Galois::Graph::readGraph(graph, filename);
-  } else if (transposeGraphName.size()) {
-    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   } else {
-    GALOIS_DIE("Graph type not supported");
+    // Without a transpose file, in-edges are computed in memory
+    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   }
 }
 
@@ -328,22 +329,39 @@ struct LeveledAlgo {
     Bag& b;
     BFS(Graph& g, Bag& b) :g(g), b(b) {}
 
+    void visit(SNode& sdata, Graph::edge_iterator ii) const {
+      GNode dst = g.getEdgeDst(ii);
+      SNode& ddata = g.getData(dst, Galois::MethodFlag::NONE);
+      if (ddata.dist.load(std::memory_order_relaxed) == std::numeric_limits<int>::max()) {
+        if (std::numeric_limits<int>::max() == ddata.dist.exchange(sdata.dist + 1))
+          b.push_back(dst);
+        if (doCount)
+          ddata.numPaths = ddata.numPaths + sdata.numPaths;
+      } else if (ddata.dist == sdata.dist + 1) {
+        if (doCount)
+          ddata.numPaths = ddata.numPaths + sdata.numPaths;
+      }
+    }
+
+    //! Visits the edges of a high-degree node in parallel
+    struct Expand {
+      const BFS& bfs;
+      SNode& sdata;
+      Expand(const BFS& bfs, SNode& sdata) :bfs(bfs), sdata(sdata) {}
+      void operator()(Graph::edge_iterator ii) const { bfs.visit(sdata, ii); }
+    };
+
     void operator()(GNode& n) const {
       auto& sdata = g.getData(n, Galois::MethodFlag::NONE);
-      for (Graph::edge_iterator ii = g.edge_begin(n, Galois::MethodFlag::NONE),
-             ei = g.edge_end(n, Galois::MethodFlag::NONE); ii != ei; ++ii) {
-        GNode dst = g.getEdgeDst(ii);
-        SNode& ddata = g.getData(dst, Galois::MethodFlag::NONE);
-        if (ddata.dist.load(std::memory_order_relaxed) == std::numeric_limits<int>::max()) {
-          if (std::numeric_limits<int>::max() == ddata.dist.exchange(sdata.dist + 1))
-            b.push_back(dst);
-          if (doCount)
-            ddata.numPaths = ddata.numPaths + sdata.numPaths;
-        } else if (ddata.dist == sdata.dist + 1) {
-          if (doCount)
-            ddata.numPaths = ddata.numPaths + sdata.numPaths;
-        }
+      Graph::edge_iterator ii = g.edge_begin(n, Galois::MethodFlag::NONE);
+      Graph::edge_iterator ei = g.edge_end(n, Galois::MethodFlag::NONE);
+      if (std::distance(ii, ei) > nestedDegree) {
+        Galois::do_all(Galois::make_no_deref_iterator(ii), Galois::make_no_deref_iterator(ei),
+            Expand(*this, sdata), Galois::do_all_nested(true));
+        return;
       }
+      for (; ii != ei; ++ii)
+        visit(sdata, ii);
       // for (Graph::in_edge_iterator ii = g.in_edge_begin(n, Galois::MethodFlag::NONE),
       //        ee = g.in_edge_end(n, Galois::MethodFlag::NONE); ii != ee; ++ii) {
       //   GNode dst = g.getInEdgeDst(ii);
@@ -176,10 +176,9 @@ void readInOutGraph(Graph& graph) {
   using namespace Galois::Graph;
   if (symmetricGraph) {
     Galois::Graph::readGraph(graph, filename);
-  } else if (transposeGraphName.size()) {
-    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   } else {
-    GALOIS_DIE("Graph type not supported");
+    // Without a transpose file, in-edges are computed in memory
+    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   }
 }
 
@@ -64,6 +64,7 @@ enum Algo {
   barrier,
   barrierWithCas,
   barrierWithInline,
+  barrierCompressed,
   deterministic,
   deterministicDisjoint,
   graphlab,
@@ -95,6 +96,7 @@ static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
       clEnumValN(Algo::async, "async", "Asynchronous"),
       clEnumValN(Algo::barrier, "barrier", "Parallel optimized with barrier (default)"),
       clEnumValN(Algo::barrierWithCas, "barrierWithCas", "Use compare-and-swap to update nodes"),
+      clEnumValN(Algo::barrierCompressed, "barrierCompressed", "Barrier with compressed graph representation"),
       clEnumValN(Algo::deterministic, "detBase", "Deterministic"),
       clEnumValN(Algo::deterministicDisjoint, "detDisjoint", "Deterministic with disjoint optimization"),
       clEnumValN(Algo::highCentrality, "highCentrality", "Optimization for graphs with many shortest paths"),
@@ -226,10 +228,9 @@ void readInOutGraph(Graph& graph) {
   using namespace Galois::Graph;
   if (symmetricGraph) {
     Galois::Graph::readGraph(graph, filename);
-  } else if (transposeGraphName.size()) {
-    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   } else {
-    GALOIS_DIE("Graph type not supported");
+    // Without a transpose file, in-edges are computed in memory
+    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   }
 }
 
@@ -321,7 +322,9 @@ struct AsyncAlgo {
     using namespace Galois::WorkList;
     typedef dChunkedFIFO<64> dChunk;
     //typedef ChunkedFIFO<64> Chunk;
-    typedef OrderedByIntegerMetric<Indexer,dChunk> OBIM;
+    // Coarser levels only cost redundant work since Process never lowers a
+    // distance below a correct one
+    typedef OrderedByIntegerMetric<Indexer,dChunk>::with_max_bins<1024>::type OBIM;
     
     graph.getData(source).dist = 0;
 
@@ -459,20 +462,20 @@ struct HighCentralityAlgo {
       if (nextSize > graph.sizeEdges() / 20)
         Galois::do_all_local(graph, BackwardProcess(graph, &bags[next], newDist));
       else
-        Galois::for_each_local(bags[cur].wl, ForwardProcess(graph, &bags[next], newDist), Galois::wl<WL>());
+        Galois::for_each_chunked(bags[cur].wl, ForwardProcess(graph, &bags[next], newDist), Galois::wl<WL>());
       bags[cur].clear();
     }
   }
 };
 
 //! BFS using optimized flags and barrier scheduling 
-template<typename WL, bool useCas>
+template<typename WL, bool useCas, typename BaseGraph = Galois::Graph::LC_CSR_Graph<SNode,void> >
 struct BarrierAlgo {
-  typedef Galois::Graph::LC_CSR_Graph<SNode,void>
+  typedef typename BaseGraph
     ::template with_numa_alloc<true>::type
     ::template with_no_lockable<true>::type
     Graph;
-  typedef Graph::GraphNode GNode;
+  typedef typename Graph::GraphNode GNode;
   typedef std::pair<GNode,Dist> WorkItem;
 
   std::string name() const { return "Barrier"; }
@@ -489,7 +492,7 @@ struct BarrierAlgo {
 
       Dist newDist = item.second;
 
-      for (Graph::edge_iterator ii = graph.edge_begin(n, Galois::MethodFlag::NONE),
+      for (typename Graph::edge_iterator ii = graph.edge_begin(n, Galois::MethodFlag::NONE),
             ei = graph.edge_end(n, Galois::MethodFlag::NONE); ii != ei; ++ii) {
         GNode dst = graph.getEdgeDst(ii);
         SNode& ddata = graph.getData(dst, Galois::MethodFlag::NONE);
@@ -516,6 +519,18 @@ struct BarrierAlgo {
   }
 };
 
+//! Barrier BFS over a graph with compressed adjacency lists
+template<typename WL>
+struct CompressedBarrierAlgo: public BarrierAlgo<WL,false,Galois::Graph::LC_Compressed_Graph<SNode,void> > {
+  typedef typename CompressedBarrierAlgo::Graph Graph;
+
+  std::string name() const { return "Barrier (compressed graph)"; }
+  void readGraph(Graph& graph) {
+    Galois::Graph::readGraph(graph, filename);
+    std::cout << "Edge bytes per edge: " << graph.sizeEdgeBytes() / (double) graph.sizeEdges() << "\n";
+  }
+};
+
 struct HybridAlgo: public HybridBFS<SNode,Dist> {
   std::string name() const { return "Hybrid"; }
 
@@ -701,6 +716,7 @@ int main(int argc, char **argv) {
     case Algo::barrier: run<BarrierAlgo<BSWL,false> >(); break;
     case Algo::barrierWithCas: run<BarrierAlgo<BSWL,true> >(); break;
     case Algo::barrierWithInline: run<BarrierAlgo<BSInline,false> >(); break;
+    case Algo::barrierCompressed: run<CompressedBarrierAlgo<BSWL> >(); break;
     case Algo::highCentrality: run<HighCentralityAlgo>(); break;
     case Algo::hybrid: run<HybridAlgo>(); break;
 #ifdef GALOIS_USE_EXP
@@ -55,8 +55,10 @@ const char* url = 0;
 
 enum Algo {
   async,
+  asyncCompressed,
   asyncOc,
   blockedasync,
+  edgeMerge,
   graphchi,
   graphlab,
   labelProp,
@@ -87,7 +89,9 @@ static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
     cll::values(
       clEnumValN(Algo::async, "async", "Asynchronous (default)"),
       clEnumValN(Algo::blockedasync, "blockedasync", "Blocked asynchronous"),
+      clEnumValN(Algo::asyncCompressed, "asyncCompressed", "Asynchronous with compressed graph representation"),
       clEnumValN(Algo::asyncOc, "asyncOc", "Asynchronous out-of-core memory"),
+      clEnumValN(Algo::edgeMerge, "edgeMerge", "Batched union-find over node ids"),
       clEnumValN(Algo::labelProp, "labelProp", "Using label propagation algorithm"),
       clEnumValN(Algo::serial, "serial", "Serial"),
       clEnumValN(Algo::synchronous, "sync", "Synchronous"),
@@ -104,6 +108,9 @@ struct Node: public Galois::UnionFindNode<Node> {
   unsigned int id;
 
   component_type component() { return this->findAndCompress(); }
+
+  //! Points node at its representative when components are found elsewhere
+  void setComponent(Node* rep) { this->m_component = rep; }
 };
 
 template<typename Graph>
@@ -111,10 +118,9 @@ void readInOutGraph(Graph& graph) {
   using namespace Galois::Graph;
   if (symmetricGraph) {
     Galois::Graph::readGraph(graph, inputFilename);
-  } else if (transposeGraphName.size()) {
-    Galois::Graph::readGraph(graph, inputFilename, transposeGraphName);
   } else {
-    GALOIS_DIE("Graph type not supported");
+    // Without a transpose file, in-edges are computed in memory
+    Galois::Graph::readGraph(graph, inputFilename, transposeGraphName);
   }
 }
 
@@ -402,12 +408,13 @@ struct AsyncOCAlgo {
  * Like synchronous algorithm, but if we restrict path compression (as done is
  * @link{UnionFindNode}), we can perform unions and finds concurrently.
  */
+template<typename BaseGraph = Galois::Graph::LC_CSR_Graph<Node,void> >
 struct AsyncAlgo {
-  typedef Galois::Graph::LC_CSR_Graph<Node,void>
-    ::with_numa_alloc<true>::type
-    ::with_no_lockable<true>::type
+  typedef typename BaseGraph
+    ::template with_numa_alloc<true>::type
+    ::template with_no_lockable<true>::type
     Graph;
-  typedef Graph::GraphNode GNode;
+  typedef typename Graph::GraphNode GNode;
 
   void readGraph(Graph& graph) { Galois::Graph::readGraph(graph, inputFilename); }
 
@@ -427,7 +434,7 @@ struct AsyncAlgo {
     void operator()(const GNode& src) const {
       Node& sdata = graph.getData(src, Galois::MethodFlag::NONE);
 
-      for (Graph::edge_iterator ii = graph.edge_begin(src, Galois::MethodFlag::NONE),
+      for (typename Graph::edge_iterator ii = graph.edge_begin(src, Galois::MethodFlag::NONE),
           ei = graph.edge_end(src, Galois::MethodFlag::NONE); ii != ei; ++ii) {
         GNode dst = graph.getEdgeDst(ii);
         Node& ddata = graph.getData(dst, Galois::MethodFlag::NONE);
@@ -447,6 +454,69 @@ struct AsyncAlgo {
   }
 };
 
+//! Async algorithm over a graph with compressed adjacency lists
+struct AsyncCompressedAlgo: public AsyncAlgo<Galois::Graph::LC_Compressed_Graph<Node,void> > {
+  void readGraph(Graph& graph) {
+    Galois::Graph::readGraph(graph, inputFilename);
+    std::cout << "Edge bytes per edge: " << graph.sizeEdgeBytes() / (double) graph.sizeEdges() << "\n";
+  }
+};
+
+/**
+ * Union-find over node ids instead of over the node data. All edges are
+ * merged in one batch, which skips edges within a component without any
+ * atomic operations, and the components are then copied to the nodes.
+ */
+struct EdgeMergeAlgo {
+  typedef Galois::Graph::LC_CSR_Graph<Node,void>
+    ::with_numa_alloc<true>::type
+    ::with_no_lockable<true>::type
+    Graph;
+  typedef Graph::GraphNode GNode;
+  typedef Galois::UnionFind<> UnionFind;
+  typedef std::vector<UnionFind::Edge> Edges;
+
+  void readGraph(Graph& graph) { Galois::Graph::readGraph(graph, inputFilename); }
+
+  struct Collect {
+    Graph& graph;
+    Edges& edges;
+    Collect(Graph& g, Edges& e): graph(g), edges(e) { }
+
+    void operator()(const GNode& src) const {
+      for (Graph::edge_iterator ii = graph.edge_begin(src, Galois::MethodFlag::NONE),
+          ei = graph.edge_end(src, Galois::MethodFlag::NONE); ii != ei; ++ii) {
+        GNode dst = graph.getEdgeDst(ii);
+        // Self edges are dropped by mergeEdges
+        if (symmetricGraph && src >= dst)
+          dst = src;
+        edges[*ii] = UnionFind::Edge(graph.idFromNode(src), graph.idFromNode(dst));
+      }
+    }
+  };
+
+  struct Link {
+    Graph& graph;
+    UnionFind& uf;
+    Link(Graph& g, UnionFind& u): graph(g), uf(u) { }
+
+    void operator()(const GNode& src) const {
+      // Nodes of LC_CSR_Graph are their ids
+      GNode rep = uf.find(graph.idFromNode(src));
+      graph.getData(src, Galois::MethodFlag::NONE).setComponent(&graph.getData(rep, Galois::MethodFlag::NONE));
+    }
+  };
+
+  void operator()(Graph& graph) {
+    UnionFind uf(graph.size());
+    Edges edges(graph.sizeEdges());
+    Galois::do_all_local(graph, Collect(graph, edges));
+    Galois::Statistic merges("Merges");
+    merges += uf.mergeEdges(edges.begin(), edges.end());
+    Galois::do_all_local(graph, Link(graph, uf));
+  }
+};
+
 /**
  * Improve performance of async algorithm by following machine topology.
  */
@@ -773,8 +843,10 @@ int main(int argc, char** argv) {
   T.start();
   switch (algo) {
     case Algo::asyncOc: run<AsyncOCAlgo>(); break;
-    case Algo::async: run<AsyncAlgo>(); break;
+    case Algo::async: run<AsyncAlgo<> >(); break;
+    case Algo::asyncCompressed: run<AsyncCompressedAlgo>(); break;
     case Algo::blockedasync: run<BlockedAsyncAlgo>(); break;
+    case Algo::edgeMerge: run<EdgeMergeAlgo>(); break;
     case Algo::labelProp: run<LabelPropAlgo>(); break;
     case Algo::serial: run<SerialAlgo>(); break;
     case Algo::synchronous: run<SynchronousAlgo>(); break;
@@ -49,8 +49,11 @@ class Cavity {
     Element& element = graph->getData(node, Galois::MethodFlag::ALL);
     Tuple elementTuple = element.getObtuse();
     Edge ObtuseEdge = element.getOppositeObtuse();
-    for (Graph::edge_iterator ii = graph->edge_begin(node, Galois::MethodFlag::ALL),
-        ee = graph->edge_end(node, Galois::MethodFlag::ALL); ii != ee; ++ii) {
+    Graph::edge_iterator ii = graph->edge_begin(node, Galois::MethodFlag::ALL);
+    // The caller checks for the conflict
+    if (Galois::Runtime::isConflicted())
+      return node;
+    for (Graph::edge_iterator ee = graph->edge_end(node, Galois::MethodFlag::ALL); ii != ee; ++ii) {
       GNode neighbor = graph->getEdgeDst(ii);
       //Edge& edgeData = graph->getEdgeData(node, neighbor);
       Edge edgeData = element.getRelatedEdge(graph->getData(neighbor, Galois::MethodFlag::ALL));
@@ -105,9 +108,14 @@ public:
     frontier.clear();
     centerNode = node;
     centerElement = &graph->getData(centerNode, Galois::MethodFlag::ALL);
-    while (graph->containsNode(centerNode, Galois::MethodFlag::ALL) && centerElement->isObtuse()) {
+    // The data of a node we failed to acquire may be changing
+    if (Galois::Runtime::isConflicted())
+      return;
+    while (graph->containsNode(centerNode, Galois::MethodFlag::NONE) && centerElement->isObtuse()) {
       centerNode = getOpposite(centerNode);
       centerElement = &graph->getData(centerNode, Galois::MethodFlag::ALL);
+      if (Galois::Runtime::isConflicted())
+        return;
     }
     center = centerElement->getCenter();
     dim = centerElement->dim();
@@ -119,9 +127,11 @@ public:
     while (!frontier.empty()) {
       GNode curr = frontier.back();
       frontier.pop_back();
-      for (Graph::edge_iterator ii = graph->edge_begin(curr, Galois::MethodFlag::ALL), 
-	     ee = graph->edge_end(curr, Galois::MethodFlag::ALL); 
-	   ii != ee; ++ii) {
+      // Acquires curr, which is already held, and its neighbors
+      Graph::edge_iterator ii = graph->edge_begin(curr, Galois::MethodFlag::ALL);
+      if (Galois::Runtime::isConflicted())
+        return;
+      for (Graph::edge_iterator ee = graph->edge_end(curr, Galois::MethodFlag::ALL); ii != ee; ++ii) {
 	GNode neighbor = graph->getEdgeDst(ii);
 	expand(curr, neighbor);
       }
@@ -132,6 +142,8 @@ public:
    * Create the new cavity based on the data of the old one
    */
   void computePost() {
+    if (Galois::Runtime::isConflicted())
+      return;
     if (centerElement->dim() == 2) { // we built around a segment
       GNode n1 = graph->createNode(Element(center, centerElement->getPoint(0)));
       GNode n2 = graph->createNode(Element(center, centerElement->getPoint(1)));
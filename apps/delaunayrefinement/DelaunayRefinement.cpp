@@ -70,6 +70,7 @@ static cll::opt<DetAlgo> detAlgo(cll::desc("Deterministic algorithm:"),
 template<int Version=detBase>
 struct Process {
   typedef int tt_needs_per_iter_alloc;
+  typedef int tt_needs_cooperative_aborts;
 
   struct LocalState {
     Cavity cav;
@@ -104,7 +105,7 @@ struct Process {
       cav.initialize(item);
       cav.build();
       cav.computePost();
-      if (Version == detPrefix)
+      if (Version == detPrefix || ctx.isConflicted())
         return;
       cav.update(item, ctx);
     }
@@ -171,7 +172,7 @@ int main(int argc, char** argv) {
   
   switch (detAlgo) {
     case nondet: 
-      Galois::for_each_local(initialBad, Process<>(), Galois::loopname("refine"), Galois::wl<Chunked>());
+      Galois::for_each_chunked(initialBad, Process<>(), Galois::loopname("refine"), Galois::wl<Chunked>());
     case detBase:
       Galois::for_each_det(initialBad.begin(), initialBad.end(), Process<>()); break;
     case detPrefix:
@@ -26,6 +26,7 @@
 #include "Galois/Bag.h"
 #include "Galois/Statistic.h"
 #include "Galois/Graph/LCGraph.h"
+#include "Galois/Graph/PropertyMap.h"
 #include "Galois/Graph/TypeTraits.h"
 #include "Lonestar/BoilerPlate.h"
 
@@ -58,7 +59,7 @@ enum Algo {
 };
 
 cll::opt<std::string> filename(cll::Positional, cll::desc("<input graph>"), cll::Required);
-static cll::opt<std::string> transposeGraphName("graphTranspose", cll::desc("Transpose of input graph"));
+static cll::opt<std::string> transposeGraphName("graphTranspose", cll::desc("Precomputed data for Pull algorithm (computed in memory if not given)"));
 static cll::opt<bool> symmetricGraph("symmetricGraph", cll::desc("Input graph is symmetric"));
 static cll::opt<std::string> outputPullFilename("outputPull", cll::desc("Precompute data for Pull algorithm to file"));
 cll::opt<unsigned int> maxIterations("maxIterations", cll::desc("Maximum iterations"), cll::init(100));
@@ -145,23 +146,41 @@ struct SerialAlgo {
   }
 };
 
-struct PullAlgo {
-  struct LNode {
-    float value[2];
+//! Sets the weight of each edge to 1 / out-degree of its source
+struct InitializePullWeights {
+  Galois::Graph::FileGraph* g;
+  float* weights;
+  void operator()(Galois::Graph::FileGraph::GraphNode src, Galois::Graph::FileGraph::edge_iterator jj) {
+    weights[*jj] = 1.0 / std::distance(g->edge_begin(src), g->edge_end(src));
+  }
+};
 
-    float getPageRank() { return value[1]; }
-    float getPageRank(unsigned int it) { return value[it & 1]; }
-    void setPageRank(unsigned it, float v) { value[(it+1) & 1] = v; }
-  };
-  typedef Galois::Graph::LC_InlineEdge_Graph<LNode,float>
+//! Makes the input of the Pull algorithm in parallel: the transpose of the
+//! input graph with edges weighted by the out-degree of their original source
+static void makePullGraph(Galois::Graph::FileGraph& out) {
+  Galois::Graph::FileGraph input, weighted;
+  input.structureFromFile(filename);
+  float* weights = weighted.structureFromGraph<float>(input);
+  InitializePullWeights fn = { &weighted, weights };
+  Galois::Graph::detail::forEachFileGraphEdge(weighted, fn);
+  Galois::Graph::transpose<float>(weighted, out);
+}
+
+struct PullAlgo {
+  //! Ranks are kept in property maps, so the graph only holds topology
+  typedef Galois::Graph::LC_InlineEdge_Graph<void,float>
     ::with_compressed_node_ptr<true>::type
     ::with_no_lockable<true>::type
     ::with_numa_alloc<true>::type
     Graph;
   typedef Graph::GraphNode GNode;
+  typedef Galois::Graph::NodePropertyMap<Graph,float> RankMap;
 
   std::string name() const { return "Pull"; }
 
+  //! Ranks of even and odd iterations
+  RankMap value[2];
+
   Galois::GReduceMax<double> max_delta;
   Galois::GAccumulator<unsigned int> small_delta;
 
@@ -169,60 +188,57 @@ struct PullAlgo {
     if (transposeGraphName.size()) {
       Galois::Graph::readGraph(graph, transposeGraphName); 
     } else {
-      std::cerr << "Need to pass precomputed graph through -graphTranspose option\n";
-      abort();
+      Galois::Graph::FileGraph pull;
+      makePullGraph(pull);
+      Galois::Graph::readGraph(graph, pull);
     }
   }
 
-  struct Initialize {
-    Graph& g;
-    Initialize(Graph& g): g(g) { }
-    void operator()(Graph::GraphNode n) {
-      LNode& data = g.getData(n, Galois::MethodFlag::NONE);
-      data.value[0] = 1.0;
-      data.value[1] = 1.0;
-    }
-  };
+  void initialize(Graph& graph) {
+    value[0].attach(graph, 1.0);
+    value[1].attach(graph, 1.0);
+  }
+
+  float getPageRank(GNode n) { return value[1][n]; }
 
   struct Copy {
-    Graph& g;
-    Copy(Graph& g): g(g) { }
+    PullAlgo* self;
+    Copy(PullAlgo* s): self(s) { }
     void operator()(Graph::GraphNode n) {
-      LNode& data = g.getData(n, Galois::MethodFlag::NONE);
-      data.value[1] = data.value[0];
+      self->value[1][n] = self->value[0][n];
     }
   };
 
   struct Process {
     PullAlgo* self;
     Graph& graph;
-    unsigned int iteration;
+    RankMap& cur;
+    RankMap& next;
 
-    Process(PullAlgo* s, Graph& g, unsigned int i): self(s), graph(g), iteration(i) { }
+    Process(PullAlgo* s, Graph& g, unsigned int i):
+      self(s), graph(g), cur(s->value[i & 1]), next(s->value[(i+1) & 1]) { }
 
     void operator()(const GNode& src, Galois::UserContext<GNode>& ctx) {
       (*this)(src);
     }
 
     void operator()(const GNode& src) {
-      LNode& sdata = graph.getData(src, Galois::MethodFlag::NONE);
       double sum = 0;
 
       for (auto jj = graph.edge_begin(src, Galois::MethodFlag::NONE), ej = graph.edge_end(src, Galois::MethodFlag::NONE); jj != ej; ++jj) {
         GNode dst = graph.getEdgeDst(jj);
         float w = graph.getEdgeData(jj);
 
-        LNode& ddata = graph.getData(dst, Galois::MethodFlag::NONE);
-        sum += ddata.getPageRank(iteration) * w;
+        sum += cur[dst] * w;
       }
 
       float value = sum * (1.0 - alpha) + alpha;
-      float diff = std::fabs(value - sdata.getPageRank(iteration));
+      float diff = std::fabs(value - cur[src]);
        
       if (diff <= tolerance)
         self->small_delta += 1;
       self->max_delta.update(diff);
-      sdata.setPageRank(iteration, value);
+      next[src] = value;
     }
   };
 
@@ -230,7 +246,7 @@ struct PullAlgo {
     unsigned int iteration = 0;
     
     while (true) {
-      Galois::for_each_local(graph, Process(this, graph, iteration));
+      Galois::do_all_balanced(graph, Process(this, graph, iteration));
       iteration += 1;
 
       float delta = max_delta.reduce();
@@ -255,75 +271,15 @@ struct PullAlgo {
     if (iteration & 1) {
       // Result already in right place
     } else {
-      Galois::do_all_local(graph, Copy(graph));
+      Galois::do_all_local(graph, Copy(this));
     }
   }
 };
 
 //! Transpose in-edges to out-edges
 static void precomputePullData() {
-  typedef Galois::Graph::LC_CSR_Graph<size_t, void>
-    ::with_no_lockable<true>::type InputGraph;
-  typedef InputGraph::GraphNode InputNode;
-  typedef Galois::Graph::FileGraphWriter OutputGraph;
-  //typedef OutputGraph::GraphNode OutputNode;
-
-  InputGraph input;
-  OutputGraph output;
-  Galois::Graph::readGraph(input, filename); 
-
-  size_t node_id = 0;
-  for (auto ii = input.begin(), ei = input.end(); ii != ei; ++ii) {
-    InputNode src = *ii;
-    input.getData(src) = node_id++;
-  }
-
-  output.setNumNodes(input.size());
-  output.setNumEdges(input.sizeEdges());
-  output.setSizeofEdgeData(sizeof(float));
-  output.phase1();
-
-  for (auto ii = input.begin(), ei = input.end(); ii != ei; ++ii) {
-    InputNode src = *ii;
-    size_t sid = input.getData(src);
-    assert(sid < input.size());
-
-    //size_t num_neighbors = std::distance(input.edge_begin(src), input.edge_end(src));
-
-    for (auto jj = input.edge_begin(src), ej = input.edge_end(src); jj != ej; ++jj) {
-      InputNode dst = input.getEdgeDst(jj);
-      size_t did = input.getData(dst);
-      assert(did < input.size());
-
-      output.incrementDegree(did);
-    }
-  }
-
-  output.phase2();
-  std::vector<float> edgeData;
-  edgeData.resize(input.sizeEdges());
-
-  for (auto ii = input.begin(), ei = input.end(); ii != ei; ++ii) {
-    InputNode src = *ii;
-    size_t sid = input.getData(src);
-    assert(sid < input.size());
-
-    size_t num_neighbors = std::distance(input.edge_begin(src), input.edge_end(src));
-
-    float w = 1.0/num_neighbors;
-    for (auto jj = input.edge_begin(src), ej = input.edge_end(src); jj != ej; ++jj) {
-      InputNode dst = input.getEdgeDst(jj);
-      size_t did = input.getData(dst);
-      assert(did < input.size());
-
-      size_t idx = output.addNeighbor(did, sid);
-      edgeData[idx] = w;
-    }
-  }
-
-  float* t = output.finish<float>();
-  memcpy(t, &edgeData[0], sizeof(edgeData[0]) * edgeData.size());
-  
+  Galois::Graph::FileGraph output;
+  makePullGraph(output);
   output.structureToFile(outputPullFilename);
   std::cout << "Wrote " << outputPullFilename << "\n";
 }
@@ -343,10 +299,42 @@ struct TopPair {
   }
 };
 
-template<typename Graph>
-static void printTop(Graph& graph, int topn) {
+//! Rank stored in the node data of the graph
+template<typename Algo, typename Graph>
+static void initialize(Algo&, Graph& graph) {
+  Galois::do_all_local(graph, typename Algo::Initialize(graph));
+}
+
+//! Rank stored in property maps
+static void initialize(PullAlgo& algo, PullAlgo::Graph& graph) {
+  algo.initialize(graph);
+}
+
+//! Bytes per node of rank storage
+template<typename Algo>
+static size_t rankBytesPerNode(Algo&) {
+  return Galois::LargeArray<typename Algo::Graph::node_data_type>::size_of::value;
+}
+
+//! Both property maps of ranks
+static size_t rankBytesPerNode(PullAlgo&) {
+  return 2 * Galois::LargeArray<float>::size_of::value;
+}
+
+//! Rank stored in the node data of the graph
+template<typename Algo, typename Graph>
+static float getPageRank(Algo&, Graph& graph, typename Graph::GraphNode n) {
+  return graph.getData(n).getPageRank();
+}
+
+//! Rank stored in property maps
+static float getPageRank(PullAlgo& algo, PullAlgo::Graph&, PullAlgo::GNode n) {
+  return algo.getPageRank(n);
+}
+
+template<typename Algo, typename Graph>
+static void printTop(Algo& algo, Graph& graph, int topn) {
   typedef typename Graph::GraphNode GNode;
-  typedef typename Graph::node_data_reference node_data_reference;
   typedef TopPair<GNode> Pair;
   typedef std::map<Pair,GNode> Top;
 
@@ -354,8 +342,7 @@ static void printTop(Graph& graph, int topn) {
 
   for (auto ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
     GNode src = *ii;
-    node_data_reference n = graph.getData(src);
-    float value = n.getPageRank();
+    float value = getPageRank(algo, graph, src);
     Pair key(value, src);
 
     if ((int) top.size() < topn) {
@@ -385,21 +372,21 @@ void run() {
 
   algo.readGraph(graph);
 
-  Galois::preAlloc(numThreads + (graph.size() * sizeof(typename Graph::node_data_type)) / Galois::Runtime::MM::pageSize);
+  Galois::preAlloc(numThreads + (graph.size() * rankBytesPerNode(algo)) / Galois::Runtime::MM::pageSize);
   Galois::reportPageAlloc("MeminfoPre");
 
   Galois::StatTimer T;
   std::cout << "Running " << algo.name() << " version\n";
   std::cout << "Target max delta: " << tolerance << "\n";
   T.start();
-  Galois::do_all_local(graph, typename Algo::Initialize(graph));
+  initialize(algo, graph);
   algo(graph);
   T.stop();
   
   Galois::reportPageAlloc("MeminfoPost");
 
   if (!skipVerify)
-    printTop(graph, 10);
+    printTop(algo, graph, 10);
 }
 
 int main(int argc, char **argv) {
@@ -394,14 +394,19 @@ void globalRelabel(IncomingWL& incoming) {
   T2.stop();
 }
 
+//! Acquires src and its neighbors, stopping at the first recorded conflict.
+//! Only the read-only graph structure is read before the locks are held.
 void acquire(const GNode& src) {
   // LC Graphs have a different idea of locking
-  for (Graph::edge_iterator 
-      ii = app.graph.edge_begin(src, Galois::MethodFlag::CHECK_CONFLICT),
-      ee = app.graph.edge_end(src, Galois::MethodFlag::CHECK_CONFLICT);
+  Graph::edge_iterator ii = app.graph.edge_begin(src, Galois::MethodFlag::CHECK_CONFLICT);
+  if (Galois::Runtime::isConflicted())
+    return;
+  for (Graph::edge_iterator ee = app.graph.edge_end(src, Galois::MethodFlag::CHECK_CONFLICT);
       ii != ee; ++ii) {
     GNode dst = app.graph.getEdgeDst(ii);
     app.graph.getData(dst, Galois::MethodFlag::CHECK_CONFLICT);
+    if (Galois::Runtime::isConflicted())
+      return;
   }
 }
 
@@ -562,6 +567,7 @@ struct Process {
 template<>
 struct Process<nondet> {
   typedef int tt_needs_parallel_break;
+  typedef int tt_needs_cooperative_aborts;
 
   Counter& counter;
   int limit;
@@ -572,6 +578,8 @@ struct Process<nondet> {
   void operator()(GNode& src, Galois::UserContext<GNode>& ctx) {
     int increment = 1;
     acquire(src);
+    if (ctx.isConflicted())
+      return;
     if (discharge(src, ctx)) {
       increment += BETA;
     }
@@ -10,6 +10,7 @@
 
 #include "SSSP.h"
 
+template<bool UseAsync>
 struct GraphLabAlgo {
   typedef Galois::Graph::LC_CSR_Graph<SNode,uint32_t>
     ::with_no_lockable<true>::type
@@ -17,7 +18,7 @@ struct GraphLabAlgo {
   typedef Galois::Graph::LC_InOut_Graph<InnerGraph> Graph;
   typedef Graph::GraphNode GNode;
 
-  std::string name() const { return "GraphLab"; }
+  std::string name() const { return UseAsync ? "GraphLab (asynchronous)" : "GraphLab"; }
 
   void readGraph(Graph& graph) { readInOutGraph(graph); }
 
@@ -77,8 +78,11 @@ struct GraphLabAlgo {
   };
 
   void operator()(Graph& graph, const GNode& source) {
-    Galois::GraphLab::SyncEngine<Graph,Program> engine(graph, Program());
-    engine.signal(source, Program::message_type(0));
+    typedef typename boost::mpl::if_c<UseAsync,
+            Galois::GraphLab::AsyncEngine<Graph,Program>,
+            Galois::GraphLab::SyncEngine<Graph,Program> >::type Engine;
+    Engine engine(graph, Program());
+    engine.signal(source, typename Program::message_type(0));
     engine.execute();
   }
 };
@@ -54,7 +54,9 @@ enum Algo {
   async,
   asyncWithCas,
   asyncPP,
+  asyncMultiQueue,
   graphlab,
+  graphlabAsync,
   ligra,
   ligraChi,
   serial
@@ -68,18 +70,28 @@ static cll::opt<unsigned int> reportNode("reportNode", cll::desc("Node to report
 static cll::opt<int> stepShift("delta", cll::desc("Shift value for the deltastep"), cll::init(10));
 cll::opt<unsigned int> memoryLimit("memoryLimit",
     cll::desc("Memory limit for out-of-core algorithms (in MB)"), cll::init(~0U));
+static cll::opt<unsigned int> edgeMapAlpha("edgeMapAlpha",
+    cll::desc("Ligra: switch to dense rounds when frontier edges exceed |E|/alpha"), cll::init(20));
+static cll::opt<unsigned int> edgeMapBeta("edgeMapBeta",
+    cll::desc("Ligra: switch back to sparse rounds when frontier nodes fall below |V|/beta"), cll::init(24));
+static cll::opt<bool> edgeMapVerbose("edgeMapVerbose", cll::desc("Ligra: print statistics of every round"));
+static cll::opt<bool> autoTune("autoTune", cll::desc("Async: choose worklist from previous runs (see GALOIS_AUTOTUNE_FILE)"));
 static cll::opt<Algo> algo("algo", cll::desc("Choose an algorithm:"),
     cll::values(
       clEnumValN(Algo::async, "async", "Asynchronous"),
       clEnumValN(Algo::asyncPP, "asyncPP", "Async, CAS, push-pull"),
       clEnumValN(Algo::asyncWithCas, "asyncWithCas", "Use compare-and-swap to update nodes"),
+      clEnumValN(Algo::asyncMultiQueue, "asyncMultiQueue", "Use compare-and-swap and a relaxed priority queue"),
       clEnumValN(Algo::serial, "serial", "Serial"),
       clEnumValN(Algo::graphlab, "graphlab", "Use GraphLab programming model"),
+      clEnumValN(Algo::graphlabAsync, "graphlabAsync", "Use GraphLab-Asynchronous programming model"),
       clEnumValN(Algo::ligraChi, "ligraChi", "Use Ligra and GraphChi programming model"),
       clEnumValN(Algo::ligra, "ligra", "Use Ligra programming model"),
       clEnumValEnd), cll::init(Algo::asyncWithCas));
 
 static const bool trackWork = true;
+//! Live OBIM bins beyond which the delta step is widened, as in adaptive delta-stepping
+static const unsigned obimMaxBins = 1024;
 static Galois::Statistic* BadWork;
 static Galois::Statistic* WLEmptyWork;
 
@@ -203,10 +215,9 @@ void readInOutGraph(Graph& graph) {
   using namespace Galois::Graph;
   if (symmetricGraph) {
     Galois::Graph::readGraph(graph, filename);
-  } else if (transposeGraphName.size()) {
-    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   } else {
-    GALOIS_DIE("Graph type not supported");
+    // Without a transpose file, in-edges are computed in memory
+    Galois::Graph::readGraph(graph, filename, transposeGraphName);
   }
 }
 
@@ -258,7 +269,7 @@ struct SerialAlgo {
   }
 };
 
-template<bool UseCas>
+template<bool UseCas, bool UseMultiQueue = false>
 struct AsyncAlgo {
   typedef SNode Node;
 
@@ -271,6 +282,8 @@ struct AsyncAlgo {
   typedef UpdateRequestCommon<GNode> UpdateRequest;
 
   std::string name() const {
+    if (UseMultiQueue)
+      return "Asynchronous with CAS and MultiQueue";
     return UseCas ? "Asynchronous with CAS" : "Asynchronous"; 
   }
 
@@ -350,11 +363,19 @@ struct AsyncAlgo {
   void operator()(Graph& graph, GNode source) {
     using namespace Galois::WorkList;
     typedef dChunkedFIFO<64> Chunk;
-    typedef OrderedByIntegerMetric<UpdateRequestIndexer<UpdateRequest>, Chunk, 10> OBIM;
-
-    std::cout << "INFO: Using delta-step of " << (1 << stepShift) << "\n";
-    std::cout << "WARNING: Performance varies considerably due to delta parameter.\n";
-    std::cout << "WARNING: Do not expect the default to be good for your graph.\n";
+    typedef OrderedByIntegerMetric<UpdateRequestIndexer<UpdateRequest>, Chunk, 10>::with_max_bins<obimMaxBins>::type OBIM;
+    typedef MultiQueue<std::less<UpdateRequest>, UpdateRequest> MQ;
+    typedef AutoTune<
+      OrderedByIntegerMetric<UpdateRequestIndexer<UpdateRequest>, dChunkedFIFO<16>, 10>::with_max_bins<obimMaxBins>::type,
+      OBIM,
+      OrderedByIntegerMetric<UpdateRequestIndexer<UpdateRequest>, dChunkedFIFO<256>, 10>::with_max_bins<obimMaxBins>::type,
+      MQ> Tuned;
+
+    if (!UseMultiQueue) {
+      std::cout << "INFO: Using delta-step of " << (1 << stepShift) << "\n";
+      std::cout << "WARNING: Performance varies considerably due to delta parameter.\n";
+      std::cout << "WARNING: Do not expect the default to be good for your graph.\n";
+    }
 
     Bag initial;
     graph.getData(source).dist = 0;
@@ -362,7 +383,12 @@ struct AsyncAlgo {
         graph.out_edges(source, Galois::MethodFlag::NONE).begin(),
         graph.out_edges(source, Galois::MethodFlag::NONE).end(),
         InitialProcess(this, graph, initial, graph.getData(source)));
-    Galois::for_each_local(initial, Process(this, graph), Galois::wl<OBIM>());
+    if (UseMultiQueue)
+      Galois::for_each_local(initial, Process(this, graph), Galois::wl<MQ>());
+    else if (autoTune)
+      Galois::for_each_local(initial, Process(this, graph), Galois::wl<Tuned>(), Galois::loopname("SSSP"));
+    else
+      Galois::for_each_local(initial, Process(this, graph), Galois::wl<OBIM>());
   }
 };
 
@@ -460,7 +486,7 @@ struct AsyncAlgoPP {
   void operator()(Graph& graph, GNode source) {
     using namespace Galois::WorkList;
     typedef dChunkedFIFO<64> Chunk;
-    typedef OrderedByIntegerMetric<UpdateRequestIndexer<UpdateRequest>, Chunk, 10> OBIM;
+    typedef OrderedByIntegerMetric<UpdateRequestIndexer<UpdateRequest>, Chunk, 10>::with_max_bins<obimMaxBins>::type OBIM;
 
     std::cout << "INFO: Using delta-step of " << (1 << stepShift) << "\n";
     std::cout << "WARNING: Performance varies considerably due to delta parameter.\n";
@@ -532,6 +558,14 @@ int main(int argc, char **argv) {
     WLEmptyWork = new Galois::Statistic("EmptyWork");
   }
 
+#if defined(__IBMCPP__) && __IBMCPP__ <= 1210
+#else
+  Galois::Ligra::EdgeMapConfig& config = Galois::Ligra::getEdgeMapConfig();
+  config.alpha = edgeMapAlpha;
+  config.beta = edgeMapBeta;
+  config.verbose = edgeMapVerbose;
+#endif
+
   Galois::StatTimer T("TotalTime");
   T.start();
   switch (algo) {
@@ -539,11 +573,13 @@ int main(int argc, char **argv) {
     case Algo::async: run<AsyncAlgo<false> >(); break;
     case Algo::asyncWithCas: run<AsyncAlgo<true> >(); break;
     case Algo::asyncPP: run<AsyncAlgoPP>(); break;
+    case Algo::asyncMultiQueue: run<AsyncAlgo<true,true> >(); break;
 #if defined(__IBMCPP__) && __IBMCPP__ <= 1210
 #else
     case Algo::ligra: run<LigraAlgo<false> >(); break;
     case Algo::ligraChi: run<LigraAlgo<true> >(false); break;
-    case Algo::graphlab: run<GraphLabAlgo>(); break;
+    case Algo::graphlab: run<GraphLabAlgo<false> >(); break;
+    case Algo::graphlabAsync: run<GraphLabAlgo<true> >(); break;
 #endif
     default: std::cerr << "Unknown algorithm\n"; abort();
   }
@@ -24,9 +24,13 @@
 #ifndef GALOIS_ACCUMULATOR_H
 #define GALOIS_ACCUMULATOR_H
 
+#include "Galois/Runtime/OnEach.h"
 #include "Galois/Runtime/PerThreadStorage.h"
+#include "Galois/Runtime/ReduceTree.h"
+#include "Galois/Runtime/ll/HWTopo.h"
 
 #include <limits>
+#include <type_traits>
 
 namespace Galois {
 
@@ -47,6 +51,33 @@ protected:
   BinFunc m_func;
   Galois::Runtime::PerThreadStorage<T> m_data;
   const T m_initial;
+  Galois::Runtime::TreeCombiner<T> m_combiner;
+
+  //! Folds rhs into lhs and resets rhs
+  struct CombineAndReset {
+    GReducible* self;
+    void operator()(T& lhs, T& rhs) {
+      self->m_func(lhs, rhs);
+      rhs = self->m_initial;
+    }
+  };
+
+  struct ReduceOnEach {
+    GReducible* self;
+    void operator()(unsigned, unsigned num) {
+      CombineAndReset fn = { self };
+      self->m_combiner.combine(*self->m_data.getLocal(), fn, num);
+    }
+  };
+
+  //! A parallel reduction costs a round trip through the thread pool, which
+  //! only pays off when combining is expensive or values have to be pulled
+  //! from other packages
+  bool useTree() const {
+    unsigned num = Galois::Runtime::activeThreads;
+    return num > 1 && !Galois::Runtime::inGaloisForEach
+      && (!std::is_scalar<T>::value || Galois::Runtime::LL::getMaxPackageForThread(num - 1) > 0);
+  }
 
   explicit GReducible(const BinFunc& f, const T& initial): m_func(f), m_initial(initial) { }
 
@@ -69,6 +100,15 @@ public:
    * Returns the final reduction value. Only valid outside the parallel region.
    */
   T& reduce() {
+    if (useTree())
+      return reduceParallel();
+    return reduceSerial();
+  }
+
+  /**
+   * Reduces values with a serial loop over all threads.
+   */
+  T& reduceSerial() {
     T& d0 = *m_data.getLocal();
     for (unsigned int i = 1; i < m_data.size(); ++i) {
       T& d = *m_data.getRemote(i);
@@ -78,6 +118,21 @@ public:
     return d0;
   }
 
+  /**
+   * Reduces values of active threads in parallel along a package-aware
+   * {@link Galois::Runtime::ReduceTree}. Values of inactive threads are
+   * folded in serially afterwards.
+   */
+  T& reduceParallel() {
+    ReduceOnEach fn = { this };
+    Galois::Runtime::on_each_impl(fn);
+    T& d0 = *m_data.getLocal();
+    CombineAndReset combine = { this };
+    for (unsigned int i = Galois::Runtime::activeThreads; i < m_data.size(); ++i)
+      combine(d0, *m_data.getRemote(i));
+    return d0;
+  }
+
   /**
    * reset value 
    */
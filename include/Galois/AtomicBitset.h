@@ -0,0 +1,152 @@
+/** Concurrent bitset -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Fixed-size bitset whose bits can be set and reset concurrently.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_ATOMICBITSET_H
+#define GALOIS_ATOMICBITSET_H
+
+#include "Galois/Accumulator.h"
+#include "Galois/Galois.h"
+#include "Galois/LargeArray.h"
+#include "Galois/gstl.h"
+
+#include <algorithm>
+#include <stdint.h>
+
+namespace Galois {
+
+/**
+ * Bitset of a fixed number of bits stored as 64-bit words. Setting and
+ * resetting bits is atomic at word granularity, so concurrent updates to
+ * different bits of the same word do not interfere.
+ */
+class AtomicBitset {
+public:
+  typedef uint64_t word_type;
+  static const unsigned bitsPerWord = 64;
+
+private:
+  LargeArray<word_type> words;
+  size_t numBits;
+
+  struct Clear {
+    AtomicBitset* self;
+    void operator()(unsigned id, unsigned total) {
+      typedef LargeArray<word_type>::iterator It;
+      std::pair<It,It> p = Galois::block_range(self->words.begin(), self->words.end(), id, total);
+      std::fill(p.first, p.second, 0);
+    }
+  };
+
+  struct Count {
+    AtomicBitset* self;
+    Galois::GAccumulator<size_t>& count;
+    void operator()(unsigned id, unsigned total) {
+      typedef LargeArray<word_type>::iterator It;
+      std::pair<It,It> p = Galois::block_range(self->words.begin(), self->words.end(), id, total);
+      size_t c = 0;
+      for (; p.first != p.second; ++p.first)
+        c += popcount(*p.first);
+      count += c;
+    }
+  };
+
+public:
+  AtomicBitset(): numBits(0) { }
+
+  static unsigned popcount(word_type w) { return __builtin_popcountll(w); }
+
+  //! Allocates n bits, all reset
+  void create(size_t n) {
+    numBits = n;
+    words.create((n + bitsPerWord - 1) / bitsPerWord);
+  }
+
+  size_t size() const { return numBits; }
+  size_t numWords() const { return words.size(); }
+
+  bool test(size_t i) {
+    return words[i / bitsPerWord] & (word_type(1) << (i % bitsPerWord));
+  }
+
+  //! Sets bit i and returns true if this call changed it
+  bool set(size_t i) {
+    word_type mask = word_type(1) << (i % bitsPerWord);
+    word_type& w = words[i / bitsPerWord];
+    // Test first to avoid taking the cache line exclusively in the common
+    // case of an already set bit
+    if (w & mask)
+      return false;
+    return !(__sync_fetch_and_or(&w, mask) & mask);
+  }
+
+  //! Resets bit i and returns true if this call changed it
+  bool reset(size_t i) {
+    word_type mask = word_type(1) << (i % bitsPerWord);
+    word_type& w = words[i / bitsPerWord];
+    if (!(w & mask))
+      return false;
+    return __sync_fetch_and_and(&w, ~mask) & mask;
+  }
+
+  //! Resets all bits in parallel
+  void clear() {
+    Clear fn = { this };
+    Galois::on_each(fn);
+  }
+
+  //! Returns number of set bits, counted in parallel
+  size_t count() {
+    Galois::GAccumulator<size_t> c;
+    Count fn = { this, c };
+    Galois::on_each(fn);
+    return c.reduce();
+  }
+
+  /**
+   * Applies fn(i) to each set bit i in the id-th of total equal blocks of
+   * words and returns the number of such bits. The words are read without
+   * synchronization, so concurrent updates may or may not be observed.
+   */
+  template<typename FnTy>
+  size_t forEachSet(unsigned id, unsigned total, FnTy& fn) {
+    typedef LargeArray<word_type>::iterator It;
+    std::pair<It,It> p = Galois::block_range(words.begin(), words.end(), id, total);
+    size_t c = 0;
+    for (It ii = p.first; ii != p.second; ++ii) {
+      word_type w = *ii;
+      size_t base = (ii - words.begin()) * bitsPerWord;
+      c += popcount(w);
+      while (w) {
+        fn(base + __builtin_ctzll(w));
+        w &= w - 1;
+      }
+    }
+    return c;
+  }
+};
+
+}
+#endif
@@ -28,6 +28,7 @@
 
 #include "Galois/config.h"
 #include "Galois/gstl.h"
+#include "Galois/Runtime/ActiveThreads.h"
 #include "Galois/Runtime/PerThreadStorage.h"
 #include "Galois/Runtime/ll/gio.h"
 #include "Galois/Runtime/mm/Mem.h"
@@ -35,6 +36,7 @@
 #include <boost/iterator/iterator_facade.hpp>
 
 #include GALOIS_CXX11_STD_HEADER(algorithm)
+#include <vector>
 
 namespace Galois {
 
@@ -45,7 +47,8 @@ namespace Galois {
  */
 template<typename T, unsigned int BlockSize = 0>
 class InsertBag: private boost::noncopyable {
-
+public:
+  //! Contiguous run of elements pushed by one thread
   struct header {
     header* next;
     T* dbegin; //start of interesting data
@@ -53,7 +56,9 @@ class InsertBag: private boost::noncopyable {
     T* dlast; //end of storage
   };
 
-public:
+  //! Chunks of a bag in iteration order
+  typedef std::vector<header*> ChunkIndex;
+
   template<typename U>
   class Iterator: public boost::iterator_facade<Iterator<U>, U, boost::forward_traversal_tag> {
     friend class boost::iterator_core_access;
@@ -120,10 +125,101 @@ public:
         advance_thread();
     }
   };
+
+  //! Iterator over the elements of a contiguous part of a chunk index
+  template<typename U>
+  class ChunkIterator: public boost::iterator_facade<ChunkIterator<U>, U, boost::forward_traversal_tag> {
+    friend class boost::iterator_core_access;
+    template<typename> friend class ChunkIterator;
+
+    header* const* c;
+    header* const* ce;
+    U* v;
+
+    void skip_empty() {
+      while (c != ce && (*c)->dbegin == (*c)->dend)
+        ++c;
+      v = c != ce ? (*c)->dbegin : 0;
+    }
+
+    void increment() {
+      if (++v != (*c)->dend)
+        return;
+      ++c;
+      skip_empty();
+    }
+
+    template<typename OtherTy>
+    bool equal(const ChunkIterator<OtherTy>& o) const {
+      return c == o.c && v == o.v;
+    }
+
+    U& dereference() const { return *v; }
+
+  public:
+    ChunkIterator(): c(0), ce(0), v(0) { }
+
+    template<typename OtherTy>
+    ChunkIterator(const ChunkIterator<OtherTy>& o): c(o.c), ce(o.ce), v(o.v) { }
+
+    //! Iterates over chunks [b, e)
+    ChunkIterator(header* const* b, header* const* e): c(b), ce(e) {
+      skip_empty();
+    }
+  };
+
+  /**
+   * Range over the elements of a bag that is divided among threads by chunk
+   * rather than by the thread that pushed each element. Thread i of n gets
+   * the i-th of n equal parts of the chunk index, so loops over bags filled
+   * unevenly are balanced to within a chunk per thread. Made by {@link
+   * InsertBag::chunked_range()}; the bag must not be modified while the
+   * range is in use.
+   */
+  class ChunkedRange {
+    const ChunkIndex* index;
+
+    header* const* chunk(size_t i) const { return index->empty() ? 0 : &(*index)[0] + i; }
+
+  public:
+    typedef ChunkIterator<T> iterator;
+    typedef iterator local_iterator;
+    typedef iterator block_iterator;
+    typedef T value_type;
+
+    explicit ChunkedRange(const ChunkIndex& idx): index(&idx) { }
+
+    iterator begin() const { return iterator(chunk(0), chunk(index->size())); }
+    iterator end() const { return iterator(chunk(index->size()), chunk(index->size())); }
+
+    size_t num_chunks() const { return index->size(); }
+
+    //! Returns the part of the range for thread tid of total threads
+    std::pair<iterator, iterator> thread_pair(unsigned tid, unsigned total) const {
+      size_t b = index->size() * tid / total;
+      size_t e = index->size() * (tid + 1) / total;
+      return std::make_pair(iterator(chunk(b), chunk(e)), iterator(chunk(e), chunk(e)));
+    }
+
+    std::pair<block_iterator, block_iterator> block_pair() const {
+      return thread_pair(Galois::Runtime::LL::getTID(), Galois::Runtime::activeThreads);
+    }
+
+    std::pair<local_iterator, local_iterator> local_pair() const {
+      return block_pair();
+    }
+
+    local_iterator local_begin() const { return block_begin(); }
+    local_iterator local_end() const { return block_end(); }
+
+    block_iterator block_begin() const { return block_pair().first; }
+    block_iterator block_end() const { return block_pair().second; }
+  };
   
 private:
   Galois::Runtime::MM::FixedSizeAllocator heap;
   Galois::Runtime::PerThreadStorage<std::pair<header*,header*> > heads;
+  ChunkIndex chunks;
 
   void insHeader(header* h) {
     std::pair<header*,header*>& H = *heads.getLocal();
@@ -171,6 +267,7 @@ private:
       }
       hpair.second = 0;
     }
+    chunks.clear();
   }
 
 public:
@@ -202,6 +299,20 @@ public:
   local_iterator local_begin() { return local_iterator(&heads, Galois::Runtime::LL::getTID()); }
   local_iterator local_end() { return local_iterator(&heads, Galois::Runtime::LL::getTID() + 1); }
 
+  /**
+   * Indexes the chunks of the bag and returns a range over them that
+   * divides work evenly among threads. Not thread safe; call again after
+   * more elements are pushed.
+   */
+  ChunkedRange chunked_range() {
+    chunks.clear();
+    for (unsigned x = 0; x < heads.size(); ++x) {
+      for (header* h = heads.getRemote(x)->first; h; h = h->next)
+        chunks.push_back(h);
+    }
+    return ChunkedRange(chunks);
+  }
+
   bool empty() const {
     for (unsigned x = 0; x < heads.size(); ++x) {
       header* h = heads.getRemote(x)->first;
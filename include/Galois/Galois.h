@@ -64,6 +64,20 @@ struct do_all_steal {
   do_all_steal(bool b = false) :b(b) {}
 };
 
+/**
+ * Specify whether a {@link do_all()} loop called from inside another parallel
+ * loop should run in parallel. The calling thread publishes the loop and
+ * threads of the enclosing loop help with it once they run out of their own
+ * work; otherwise the loop runs serially on the calling thread. The operator
+ * runs without conflict detection, and as with any do_all, state kept in the
+ * copies of the operator made for each thread is discarded. Optional argument
+ * to {@link do_all()} loops; has no effect on loops that are not nested.
+ */
+struct do_all_nested {
+  bool b;
+  do_all_nested(bool b = false) :b(b) {}
+};
+
 struct wl_tag {};
 
 /**
@@ -119,11 +133,31 @@ FunctionTy do_all_gen(RangeTy r, FunctionTy fn, Tuple tpl) {
   //           << tuple_index<tupleType, char const*>::value << "\n";
   constexpr unsigned iloopname = tuple_index<tupleType, loopname>::value;
   constexpr unsigned isteal = tuple_index<tupleType, do_all_steal>::value;
+  constexpr unsigned inested = tuple_index<tupleType, do_all_nested>::value;
   const char* ln = std::get<iloopname>(tpl).n;
   bool steal = std::get<isteal>(tpl).b;
-  return Runtime::do_all_impl(r, fn, ln, steal);
+  bool nested = std::get<inested>(tpl).b;
+  return Runtime::do_all_impl(r, fn, ln, steal, nested);
 }
 
+//! Applies a node operator to an {@link Runtime::EdgeRangeItem}
+template<typename FunctionTy>
+struct EdgeRangeNodeFn {
+  FunctionTy fn;
+  EdgeRangeNodeFn(const FunctionTy& f): fn(f) { }
+  template<typename ItemTy>
+  void operator()(const ItemTy& item) { fn(item.node); }
+};
+
+//! Applies a node and edge range operator to an {@link Runtime::EdgeRangeItem}
+template<typename FunctionTy>
+struct EdgeRangeEdgesFn {
+  FunctionTy fn;
+  EdgeRangeEdgesFn(const FunctionTy& f): fn(f) { }
+  template<typename ItemTy>
+  void operator()(const ItemTy& item) { fn(item.node, item.begin, item.end); }
+};
+
 } // namespace HIDDEN
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -135,6 +169,11 @@ FunctionTy do_all_gen(RangeTy r, FunctionTy fn, Tuple tpl) {
  * Operator should conform to <code>fn(item, UserContext<T>&)</code> where item is a value from the iteration
  * range and T is the type of item.
  *
+ * A for_each called from inside another parallel loop is shared with idle
+ * threads of the enclosing loop, ignoring the worklist policy. Its operator
+ * runs without conflict detection, so it must be marked with
+ * {@link does_not_need_aborts} and must not need {@link needs_parallel_break}.
+ *
  * @tparam WLTy Worklist policy {@see Galois::WorkList}
  * @param b begining of range of initial items
  * @param e end of range of initial items
@@ -177,6 +216,21 @@ void for_each_local(ConTy& c, FunctionTy fn, Args... args) {
   HIDDEN::for_each_gen(Runtime::makeLocalRange(c), fn, std::make_tuple(loopname(), wl<HIDDEN::defaultWL>(), args...));
 }
 
+/**
+ * Galois unordered set iterator over a bag whose initial items are divided
+ * evenly among threads by chunk rather than by the thread that pushed them.
+ * Operator should conform to <code>fn(item, UserContext<T>&)</code> where
+ * item is an element of c and T is the type of item.
+ *
+ * @param c bag with a chunked_range() (e.g., {@link InsertBag})
+ * @param fn operator
+ * @param args optional arguments to loop
+ */
+template<typename ConTy, typename FunctionTy, typename... Args>
+void for_each_chunked(ConTy& c, FunctionTy fn, Args... args) {
+  HIDDEN::for_each_gen(c.chunked_range(), fn, std::make_tuple(loopname(), wl<HIDDEN::defaultWL>(), args...));
+}
+
 /**
  * Standard do-all loop. All iterations should be independent.
  * Operator should conform to <code>fn(item)</code> where item is a value from the iteration range.
@@ -189,7 +243,7 @@ void for_each_local(ConTy& c, FunctionTy fn, Args... args) {
  */
 template<typename IterTy,typename FunctionTy, typename... Args>
 FunctionTy do_all(const IterTy& b, const IterTy& e, FunctionTy fn, Args... args) {
-  return HIDDEN::do_all_gen(Runtime::makeStandardRange(b, e), fn, std::make_tuple(loopname(), do_all_steal(), args...));
+  return HIDDEN::do_all_gen(Runtime::makeStandardRange(b, e), fn, std::make_tuple(loopname(), do_all_steal(), do_all_nested(), args...));
 }
 
 /**
@@ -203,7 +257,60 @@ FunctionTy do_all(const IterTy& b, const IterTy& e, FunctionTy fn, Args... args)
  */
 template<typename ConTy,typename FunctionTy, typename... Args>
 FunctionTy do_all_local(ConTy& c, FunctionTy fn, Args... args) {
-  return HIDDEN::do_all_gen(Runtime::makeLocalRange(c), fn, std::make_tuple(loopname(), do_all_steal(), args...));
+  return HIDDEN::do_all_gen(Runtime::makeLocalRange(c), fn, std::make_tuple(loopname(), do_all_steal(), do_all_nested(), args...));
+}
+
+/**
+ * Do-all loop over a bag whose items are divided evenly among threads by
+ * chunk rather than by the thread that pushed them. All iterations should
+ * be independent. Operator should conform to <code>fn(item)</code> where
+ * item is an element of c.
+ *
+ * @param c bag with a chunked_range() (e.g., {@link InsertBag})
+ * @param fn operator
+ * @param args optional arguments to loop
+ * @returns fn
+ */
+template<typename ConTy,typename FunctionTy, typename... Args>
+FunctionTy do_all_chunked(ConTy& c, FunctionTy fn, Args... args) {
+  return HIDDEN::do_all_gen(c.chunked_range(), fn, std::make_tuple(loopname(), do_all_steal(), do_all_nested(), args...));
+}
+
+/**
+ * Do-all loop over the nodes of a graph where work is divided among threads
+ * by cumulative out-degree rather than by number of nodes. All iterations
+ * should be independent. Operator should conform to <code>fn(n)</code> where
+ * n is a node of g.
+ *
+ * @param g graph with random access node and edge iterators, e.g., {@link Graph::LC_CSR_Graph}
+ * @param fn operator
+ * @param args optional arguments to loop
+ * @returns fn
+ */
+template<typename GraphTy,typename FunctionTy, typename... Args>
+FunctionTy do_all_balanced(GraphTy& g, FunctionTy fn, Args... args) {
+  return HIDDEN::do_all_gen(Runtime::makeEdgeBalancedRange(g, false),
+      HIDDEN::EdgeRangeNodeFn<FunctionTy>(fn), std::make_tuple(loopname(), do_all_steal(), do_all_nested(), args...)).fn;
+}
+
+/**
+ * Do-all loop over the out-edges of a graph where work is divided among
+ * threads by cumulative out-degree and the edges of high-degree nodes may be
+ * processed by several threads at once. Operator should conform to
+ * <code>fn(n, ii, ei)</code> where [ii, ei) is a range of out-edges of node n.
+ * A node may be passed to the operator several times, possibly concurrently,
+ * with disjoint edge ranges whose union is all its out-edges. Nodes without
+ * out-edges are passed once with an empty range.
+ *
+ * @param g graph with random access node and edge iterators, e.g., {@link Graph::LC_CSR_Graph}
+ * @param fn operator
+ * @param args optional arguments to loop
+ * @returns fn
+ */
+template<typename GraphTy,typename FunctionTy, typename... Args>
+FunctionTy do_all_edges(GraphTy& g, FunctionTy fn, Args... args) {
+  return HIDDEN::do_all_gen(Runtime::makeEdgeBalancedRange(g, true),
+      HIDDEN::EdgeRangeEdgesFn<FunctionTy>(fn), std::make_tuple(loopname(), do_all_steal(), do_all_nested(), args...)).fn;
 }
 
 /**
@@ -245,6 +352,9 @@ static inline void reportPageAlloc(const char* label) {
  * range and T is the type of item. Comparison function should conform to <code>bool r = cmp(item1, item2)</code>
  * where r is true if item1 is less than or equal to item2. Neighborhood function should conform to
  * <code>nhFunc(item)</code> and should visit every element in the neighborhood of active element item.
+ * If the neighborhood of an item never changes while the item is pending, nhFunc may declare
+ * tt_has_fixed_neighborhood; neighborhoods are then computed once per item and the loop runs on
+ * an executor that does not abort iterations.
  *
  * @param b begining of range of initial items
  * @param e end of range of initial items
@@ -0,0 +1,319 @@
+/** Compressed graph format -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Group varint encoding of sorted adjacency lists and the compressed graph
+ * file format (.cgr) used by {@link LC_Compressed_Graph}.
+ *
+ * Each adjacency list is sorted and stored as the first destination followed
+ * by the differences between consecutive destinations. Values are grouped in
+ * fours; each group starts with a tag byte whose i-th pair of bits gives the
+ * length (1, 2, 4 or 8 bytes) of the i-th value, followed by the values in
+ * little endian order.
+ *
+ * File format:
+ * <ul>
+ *  <li>magic {uint64_t LE}</li>
+ *  <li>EdgeType size {uint64_t LE}</li>
+ *  <li>numNodes {uint64_t LE}</li>
+ *  <li>numEdges {uint64_t LE}</li>
+ *  <li>numBytes {uint64_t LE}</li>
+ *  <li>edgeindexs[numNodes] {uint64_t LE} (end edge index of each node)</li>
+ *  <li>byteindexs[numNodes] {uint64_t LE} (end byte index of each node)</li>
+ *  <li>bytes[numBytes], padding to re-align to 64 bits</li>
+ *  <li>EdgeType[numEdges] {EdgeType size} (in sorted neighbor order)</li>
+ * </ul>
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_GRAPH_COMPRESSEDGRAPHFORMAT_H
+#define GALOIS_GRAPH_COMPRESSEDGRAPHFORMAT_H
+
+#include "Galois/Endian.h"
+#include "Galois/LargeArray.h"
+#include "Galois/Graph/FileGraph.h"
+#include "Galois/Runtime/ll/gio.h"
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/utility.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Galois {
+namespace Graph {
+
+//! First word of a compressed graph file ("CGR1")
+const uint64_t compressedGraphMagic = 0x31524743;
+
+namespace detail {
+
+//! Returns the tag code (log2 of byte length) to store v
+inline unsigned groupVarintCode(uint64_t v) {
+  if (v < (UINT64_C(1) << 8))
+    return 0;
+  if (v < (UINT64_C(1) << 16))
+    return 1;
+  if (v < (UINT64_C(1) << 32))
+    return 2;
+  return 3;
+}
+
+//! Returns the number of bytes needed to encode sorted values [b, e)
+template<typename It>
+size_t groupVarintSize(It b, It e) {
+  size_t size = 0;
+  uint64_t prev = 0;
+  for (unsigned pos = 0; b != e; ++b, pos = (pos + 1) % 4) {
+    if (pos == 0)
+      size += 1;
+    size += 1 << groupVarintCode(*b - prev);
+    prev = *b;
+  }
+  return size;
+}
+
+//! Encodes sorted values [b, e) into out. Returns end of encoded bytes.
+template<typename It>
+uint8_t* groupVarintEncode(It b, It e, uint8_t* out) {
+  uint64_t prev = 0;
+  uint8_t* tag = 0;
+  for (unsigned pos = 0; b != e; ++b, pos = (pos + 1) % 4) {
+    if (pos == 0) {
+      tag = out++;
+      *tag = 0;
+    }
+    uint64_t v = *b - prev;
+    unsigned code = groupVarintCode(v);
+    *tag |= code << (2 * pos);
+    for (unsigned i = 0; i < (1u << code); ++i)
+      *out++ = static_cast<uint8_t>(v >> (8 * i));
+    prev = *b;
+  }
+  return out;
+}
+
+/**
+ * Forward iterator over a group varint encoded adjacency list. Dereferences
+ * to the edge index; the current destination is given by getDst().
+ */
+template<typename NodeIdTy>
+class CompressedEdgeIterator: public boost::iterator_facade<
+                              CompressedEdgeIterator<NodeIdTy>,
+                              uint64_t,
+                              boost::forward_traversal_tag,
+                              uint64_t> {
+  const uint8_t* tag;
+  const uint8_t* data;
+  uint64_t idx;
+  uint64_t end;
+  NodeIdTy dst;
+  unsigned pos;
+
+  void decode() {
+    unsigned len = 1u << ((*tag >> (2 * pos)) & 3);
+    uint64_t v = 0;
+    for (unsigned i = 0; i < len; ++i)
+      v |= static_cast<uint64_t>(data[i]) << (8 * i);
+    data += len;
+    dst += v;
+  }
+
+public:
+  CompressedEdgeIterator(): tag(0), data(0), idx(0), end(0), dst(0), pos(0) { }
+
+  //! Iterator over edges [i, e) encoded starting at bytes
+  CompressedEdgeIterator(const uint8_t* bytes, uint64_t i, uint64_t e):
+    tag(bytes), data(bytes + 1), idx(i), end(e), dst(0), pos(0)
+  {
+    if (idx != end)
+      decode();
+  }
+
+  NodeIdTy getDst() const { return dst; }
+
+private:
+  friend class boost::iterator_core_access;
+
+  void increment() {
+    if (++idx == end)
+      return;
+    if (++pos == 4) {
+      tag = data;
+      data = tag + 1;
+      pos = 0;
+    }
+    decode();
+  }
+
+  bool equal(const CompressedEdgeIterator& other) const { return idx == other.idx; }
+
+  uint64_t dereference() const { return idx; }
+};
+
+//! Fixed part of compressed graph file
+struct CompressedGraphHeader {
+  uint64_t magic;
+  uint64_t sizeofEdge;
+  uint64_t numNodes;
+  uint64_t numEdges;
+  uint64_t numBytes;
+};
+
+/**
+ * Read-only mapping of a compressed graph file. Pages are not faulted in
+ * up front; graphs copy their part of the file out in parallel instead.
+ */
+class CompressedGraphFile: private boost::noncopyable {
+  void* masterMapping;
+  size_t masterLength;
+  int masterFD;
+  CompressedGraphHeader header;
+  const uint64_t* edgeIdx;
+  const uint64_t* byteIdx;
+  const uint8_t* bytes;
+  const char* edgeData;
+
+public:
+  CompressedGraphFile(): masterMapping(0), masterLength(0), masterFD(-1) { }
+  ~CompressedGraphFile();
+
+  void structureFromFile(const std::string& filename);
+
+  const CompressedGraphHeader& getHeader() const { return header; }
+
+  uint64_t edgeBegin(uint64_t n) const { return n == 0 ? 0 : edgeEnd(n - 1); }
+  uint64_t edgeEnd(uint64_t n) const { return convert_le64(edgeIdx[n]); }
+  uint64_t byteBegin(uint64_t n) const { return n == 0 ? 0 : byteEnd(n - 1); }
+  uint64_t byteEnd(uint64_t n) const { return convert_le64(byteIdx[n]); }
+
+  const uint8_t* getBytes() const { return bytes; }
+  const char* getEdgeData() const { return edgeData; }
+
+  /**
+   * Returns the nodes of the tid-th of total ranges; ranges have about
+   * the same number of nodes times nodeSize plus bytes and edges times
+   * edgeSize.
+   */
+  std::pair<uint64_t,uint64_t> divideBy(size_t nodeSize, size_t edgeSize, unsigned tid, unsigned total) const;
+};
+
+//! Returns a copy of the neighbors of n sorted by destination, paired with
+//! their edge index in g
+inline void sortedNeighbors(FileGraph& g, FileGraph::LargeGraphNode n, std::vector<std::pair<uint64_t,uint64_t> >& out) {
+  out.clear();
+  for (FileGraph::edge_iterator ii = g.edge_begin(n), ei = g.edge_end(n); ii != ei; ++ii)
+    out.push_back(std::make_pair(g.getEdgeDst(ii), *ii));
+  std::sort(out.begin(), out.end());
+}
+
+//! Iterates over the first elements of pairs
+struct PairFirstIterator: public boost::iterator_facade<
+                          PairFirstIterator,
+                          uint64_t,
+                          boost::forward_traversal_tag,
+                          uint64_t> {
+  const std::pair<uint64_t,uint64_t>* p;
+  PairFirstIterator(const std::pair<uint64_t,uint64_t>* _p): p(_p) { }
+  void increment() { ++p; }
+  bool equal(const PairFirstIterator& other) const { return p == other.p; }
+  uint64_t dereference() const { return p->first; }
+};
+
+inline PairFirstIterator pairFirstBegin(const std::vector<std::pair<uint64_t,uint64_t> >& v) {
+  return PairFirstIterator(v.empty() ? 0 : &v[0]);
+}
+
+inline PairFirstIterator pairFirstEnd(const std::vector<std::pair<uint64_t,uint64_t> >& v) {
+  return PairFirstIterator(v.empty() ? 0 : &v[0] + v.size());
+}
+
+template<typename T>
+void writeLE64(std::ofstream& out, T* begin, T* end) {
+  for (; begin != end; ++begin) {
+    uint64_t v = convert_le64(*begin);
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+}
+
+} // end namespace
+
+//! Returns true if filename is a compressed graph file
+inline bool isCompressedGraphFile(const std::string& filename) {
+  std::ifstream in(filename.c_str(), std::ios::binary);
+  uint64_t magic = 0;
+  in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  return in && convert_le64(magic) == compressedGraphMagic;
+}
+
+/**
+ * Writes a compressed version of a graph to file. Adjacency lists are
+ * sorted by destination and edge data is reordered accordingly.
+ */
+template<typename EdgeTy>
+void writeCompressedGraph(FileGraph& in, const std::string& filename) {
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  std::vector<uint64_t> edgeIdx(in.size());
+  std::vector<uint64_t> byteIdx(in.size());
+  std::vector<uint8_t> bytes;
+  std::vector<char> edgeData(in.sizeEdges() * EdgeData::size_of::value);
+  std::vector<std::pair<uint64_t,uint64_t> > neighbors;
+
+  uint64_t numBytes = 0;
+  uint64_t numEdges = 0;
+  for (FileGraph::iterator ii = in.begin(), ei = in.end(); ii != ei; ++ii) {
+    detail::sortedNeighbors(in, *ii, neighbors);
+    size_t size = detail::groupVarintSize(detail::pairFirstBegin(neighbors), detail::pairFirstEnd(neighbors));
+    bytes.resize(numBytes + size);
+    if (size)
+      detail::groupVarintEncode(detail::pairFirstBegin(neighbors), detail::pairFirstEnd(neighbors), &bytes[numBytes]);
+    for (size_t i = 0; EdgeData::has_value && i < neighbors.size(); ++i) {
+      memcpy(&edgeData[(numEdges + i) * EdgeData::size_of::value],
+          &in.getEdgeData<edge_value_type>(FileGraph::edge_iterator(neighbors[i].second)),
+          EdgeData::size_of::value);
+    }
+    numBytes += size;
+    numEdges += neighbors.size();
+    edgeIdx[*ii] = numEdges;
+    byteIdx[*ii] = numBytes;
+  }
+
+  std::ofstream out(filename.c_str(), std::ios::binary | std::ios::trunc);
+  uint64_t header[] = { compressedGraphMagic, EdgeData::size_of::value, in.size(), numEdges, numBytes };
+  detail::writeLE64(out, header, header + 5);
+  detail::writeLE64(out, edgeIdx.data(), edgeIdx.data() + edgeIdx.size());
+  detail::writeLE64(out, byteIdx.data(), byteIdx.data() + byteIdx.size());
+  out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  char padding[8] = { 0 };
+  out.write(padding, (8 - numBytes % 8) % 8);
+  out.write(edgeData.data(), edgeData.size());
+  if (!out)
+    GALOIS_DIE("failed writing to ", filename);
+}
+
+}
+}
+#endif
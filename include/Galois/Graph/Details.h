@@ -27,6 +27,7 @@
 #ifndef GALOIS_GRAPH_DETAILS_H
 #define GALOIS_GRAPH_DETAILS_H
 
+#include "Galois/config.h"
 #include "Galois/LargeArray.h"
 #include "Galois/LazyObject.h"
 #include "Galois/NoDerefIterator.h"
@@ -34,9 +35,13 @@
 #include "Galois/Runtime/Context.h"
 #include "Galois/Runtime/MethodFlags.h"
 #include "Galois/Runtime/PerThreadStorage.h"
+#include "Galois/Runtime/ll/gio.h"
 
 #include <boost/mpl/if.hpp>
 #include <algorithm>
+#include <limits>
+#include GALOIS_CXX11_STD_HEADER(type_traits)
+#include GALOIS_CXX11_STD_HEADER(utility)
 
 namespace Galois {
 namespace Graph {
@@ -44,6 +49,7 @@ namespace Graph {
 struct read_default_graph_tag { };
 struct read_with_aux_graph_tag { };
 struct read_lc_inout_graph_tag { };
+struct read_compressed_graph_tag { };
 
 //! Proxy object for {@link detail::EdgeSortIterator}
 template<typename GraphNode, typename EdgeTy>
@@ -55,7 +61,7 @@ struct EdgeSortValue: public StrictObject<EdgeTy> {
   
   EdgeSortValue(GraphNode d, const value_type& v): Super(v), dst(d) { }
 
-  template<typename ER>
+  template<typename ER, typename = decltype(std::declval<const ER&>().initialize(std::declval<EdgeSortValue&>()))>
   EdgeSortValue(const ER& ref) {
     ref.initialize(*this);
   }
@@ -64,6 +70,13 @@ struct EdgeSortValue: public StrictObject<EdgeTy> {
 //! Implementation details for graphs
 namespace detail {
 
+//! Aborts if node ids of type NodeIdTy cannot address numNodes nodes
+template<typename NodeIdTy>
+void checkNodeIdRange(uint64_t numNodes) {
+  if (numNodes > std::numeric_limits<NodeIdTy>::max())
+    GALOIS_DIE("graph has ", numNodes, " nodes, too many for node id type; use with_node_id<uint64_t>");
+}
+
 template<bool Enable>
 class LocalIteratorFeature {
   typedef std::pair<uint64_t,uint64_t> Range;
@@ -136,6 +149,17 @@ struct EdgeSortReference {
 /**
  * Converts comparison functions over EdgeTy to be over {@link EdgeSortValue}.
  */
+//! Whether CompTy can compare two EdgeSortValueTy
+template<typename CompTy, typename EdgeSortValueTy>
+class IsEdgeSortComparator {
+  template<typename C>
+  static std::true_type test(decltype(std::declval<const C&>()(std::declval<const EdgeSortValueTy&>(), std::declval<const EdgeSortValueTy&>()))*);
+  template<typename C>
+  static std::false_type test(...);
+public:
+  typedef decltype(test<CompTy>(0)) type;
+};
+
 template<typename EdgeSortValueTy,typename CompTy>
 struct EdgeSortCompWrapper {
   const CompTy& comp;
@@ -312,14 +336,14 @@ public:
   iterator end() { return make_no_deref_iterator(g.in_edge_end(n, flag)); }
 };
 
-template<typename GraphTy>
+template<typename GraphTy, typename NodeTy = typename GraphTy::GraphNode>
 class EdgesWithNoFlagIterator {
   GraphTy& g;
-  typename GraphTy::GraphNode n;
+  NodeTy n;
 public:
   typedef NoDerefIterator<typename GraphTy::edge_iterator> iterator;
 
-  EdgesWithNoFlagIterator(GraphTy& g, typename GraphTy::GraphNode n): g(g), n(n) { }
+  EdgesWithNoFlagIterator(GraphTy& g, NodeTy n): g(g), n(n) { }
 
   iterator begin() { return make_no_deref_iterator(g.edge_begin(n)); }
   iterator end() { return make_no_deref_iterator(g.edge_end(n)); }
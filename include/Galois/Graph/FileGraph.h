@@ -43,6 +43,7 @@
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/utility.hpp>
 
+#include GALOIS_CXX11_STD_HEADER(functional)
 #include GALOIS_CXX11_STD_HEADER(type_traits)
 //#include <fstream>
 
@@ -51,29 +52,45 @@
 namespace Galois {
 namespace Graph {
 
-//! Graph serialized to a file
+namespace detail {
+/**
+ * Calls fn(tid, total) once on each active thread. Runs fn(0, 1) serially
+ * when already inside a parallel loop or when FileGraph is built without the
+ * Galois thread pool (e.g., for graph-convert-standalone).
+ */
+void fileGraphOnEach(const std::function<void(unsigned,unsigned)>& fn);
+}
+
+/**
+ * Graph serialized to a file.
+ *
+ * Version 1 graphs store edge destinations as 32-bit integers; version 2
+ * graphs store them as 64-bit integers and can hold more than 2^32 nodes.
+ */
 class FileGraph: private boost::noncopyable {
   friend class FileGraphAllocator;
 public:
+  //! Node id; enough for version 1 graphs, which have at most 2^32 nodes
   typedef uint32_t GraphNode;
+  //! Node id that can address every node of a version 2 graph
+  typedef uint64_t LargeGraphNode;
 
 protected:
   void* volatile masterMapping;
   size_t masterLength;
   uint64_t sizeofEdge;
   int masterFD;
+  uint64_t graphVersion;
 
   uint64_t* outIdx;
-  uint32_t* outs;
+  void* outs; // uint32_t (version 1) or uint64_t (version 2) destinations
 
   char* edgeData;
 
   uint64_t numEdges;
   uint64_t numNodes;
 
-  uint64_t getEdgeIdx(GraphNode src, GraphNode dst) const;
-  uint32_t* raw_neighbor_begin(GraphNode N) const;
-  uint32_t* raw_neighbor_end(GraphNode N) const;
+  uint64_t getEdgeIdx(LargeGraphNode src, LargeGraphNode dst) const;
 
   struct Convert32: public std::unary_function<uint32_t, uint32_t> {
     uint32_t operator()(uint32_t x) const {
@@ -87,6 +104,51 @@ protected:
     }
   };
 
+  struct EdgeDst {
+    typedef LargeGraphNode result_type;
+    const FileGraph* g;
+    EdgeDst(): g(0) { }
+    EdgeDst(const FileGraph* _g): g(_g) { }
+    LargeGraphNode operator()(uint64_t idx) const {
+      return g->getEdgeDstAt(idx);
+    }
+  };
+
+  LargeGraphNode getEdgeDstAt(uint64_t idx) const {
+    if (graphVersion == 1)
+      return convert_le32(static_cast<uint32_t*>(outs)[idx]);
+    return convert_le64(static_cast<uint64_t*>(outs)[idx]);
+  }
+
+  //! Sorts with edge values whose destinations are DstTy, the type stored
+  //! by the graph, if comp can compare them
+  template<typename DstTy, typename EdgeTy, typename CompTy>
+  void sortEdgesImpl(LargeGraphNode N, const CompTy& comp) {
+    typedef EdgeSortValue<DstTy,typename LargeArray<EdgeTy>::raw_value_type> Value;
+    sortEdgesImpl<DstTy,EdgeTy>(N, comp, typename detail::IsEdgeSortComparator<CompTy,Value>::type());
+  }
+
+  template<typename DstTy, typename EdgeTy, typename CompTy>
+  void sortEdgesImpl(LargeGraphNode N, const CompTy& comp, std::false_type) {
+    GALOIS_DIE("sortEdges: comparator does not accept EdgeSortValue<",
+        graphVersion == 1 ? "GraphNode" : "LargeGraphNode", ", EdgeTy> of a version ", graphVersion, " graph");
+  }
+
+  template<typename DstTy, typename EdgeTy, typename CompTy>
+  void sortEdgesImpl(LargeGraphNode N, const CompTy& comp, std::true_type) {
+    typedef LargeArray<DstTy> EdgeDstData;
+    typedef LargeArray<EdgeTy> EdgeData;
+    typedef detail::EdgeSortIterator<DstTy,uint64_t,EdgeDstData,EdgeData> edge_sort_iterator;
+
+    EdgeDstData edgeDst(outs, numEdges);
+    EdgeData ed(edgeData, numEdges);
+
+    edge_sort_iterator begin(*edge_begin(N), &edgeDst, &ed);
+    edge_sort_iterator end(*edge_end(N), &edgeDst, &ed);
+
+    std::sort(begin, end, comp);
+  }
+
   //! Initializes a graph from block of memory
   void parse(void* m);
 
@@ -96,6 +158,12 @@ protected:
   void* structureFromArrays(uint64_t* outIdxs, uint64_t numNodes,
       uint32_t* outs, uint64_t numEdges, size_t sizeofEdgeData);
 
+  void* structureFromArrays(uint64_t* outIdxs, uint64_t numNodes,
+      uint64_t* outs, uint64_t numEdges, size_t sizeofEdgeData);
+
+  void* structureFromArrays(uint64_t* outIdxs, uint64_t numNodes,
+      const void* outs, uint64_t numEdges, size_t sizeofEdgeData, uint64_t version);
+
   void* structureFromGraph(FileGraph& g, size_t sizeofEdgeData);
 
   /**
@@ -114,60 +182,49 @@ public:
   // Node Handling
 
   //! Checks if a node is in the graph (already added)
-  bool containsNode(const GraphNode n) const {
+  bool containsNode(const LargeGraphNode n) const {
     return n < numNodes;
   }
 
   // Edge Handling
   template<typename EdgeTy>
-  EdgeTy& getEdgeData(GraphNode src, GraphNode dst) {
+  EdgeTy& getEdgeData(LargeGraphNode src, LargeGraphNode dst) {
     assert(sizeofEdge == sizeof(EdgeTy));
     return reinterpret_cast<EdgeTy*>(edgeData)[getEdgeIdx(src, dst)];
   }
 
   // Iterators
   typedef boost::counting_iterator<uint64_t> edge_iterator;
-  edge_iterator edge_begin(GraphNode N) const;
-  edge_iterator edge_end(GraphNode N) const;
+  edge_iterator edge_begin(LargeGraphNode N) const;
+  edge_iterator edge_end(LargeGraphNode N) const;
 
-  detail::EdgesWithNoFlagIterator<FileGraph> out_edges(GraphNode N) {
-    return detail::EdgesWithNoFlagIterator<FileGraph>(*this, N);
+  detail::EdgesWithNoFlagIterator<FileGraph,LargeGraphNode> out_edges(LargeGraphNode N) {
+    return detail::EdgesWithNoFlagIterator<FileGraph,LargeGraphNode>(*this, N);
   }
 
   /**
    * Sorts outgoing edges of a node. Comparison function is over EdgeTy.
    */
   template<typename EdgeTy, typename CompTy>
-  void sortEdgesByEdgeData(GraphNode N, const CompTy& comp = std::less<EdgeTy>()) {
-    typedef LargeArray<GraphNode> EdgeDst;
-    typedef LargeArray<EdgeTy> EdgeData;
-    typedef detail::EdgeSortIterator<GraphNode,uint64_t,EdgeDst,EdgeData> edge_sort_iterator;
-
-    EdgeDst edgeDst(outs, numEdges);
-    EdgeData ed(edgeData, numEdges);
-
-    edge_sort_iterator begin(std::distance(outs, raw_neighbor_begin(N)), &edgeDst, &ed);
-    edge_sort_iterator end(std::distance(outs, raw_neighbor_end(N)), &edgeDst, &ed);
-
-    std::sort(begin, end, detail::EdgeSortCompWrapper<EdgeSortValue<GraphNode,EdgeTy>,CompTy>(comp));
+  void sortEdgesByEdgeData(LargeGraphNode N, const CompTy& comp = std::less<EdgeTy>()) {
+    if (graphVersion == 1)
+      sortEdges<EdgeTy>(N, detail::EdgeSortCompWrapper<EdgeSortValue<GraphNode,EdgeTy>,CompTy>(comp));
+    else
+      sortEdges<EdgeTy>(N, detail::EdgeSortCompWrapper<EdgeSortValue<LargeGraphNode,EdgeTy>,CompTy>(comp));
   }
 
   /**
-   * Sorts outgoing edges of a node. Comparison function is over <code>EdgeSortValue<EdgeTy></code>.
+   * Sorts outgoing edges of a node. Comparison function is over
+   * <code>EdgeSortValue<GraphNode,EdgeTy></code> for version 1 graphs and
+   * <code>EdgeSortValue<LargeGraphNode,EdgeTy></code> for version 2 graphs;
+   * a comparator that accepts only one of them aborts on the other version.
    */
   template<typename EdgeTy, typename CompTy>
-  void sortEdges(GraphNode N, const CompTy& comp) {
-    typedef LargeArray<GraphNode> EdgeDst;
-    typedef LargeArray<EdgeTy> EdgeData;
-    typedef detail::EdgeSortIterator<GraphNode,uint64_t,EdgeDst,EdgeData> edge_sort_iterator;
-
-    EdgeDst edgeDst(outs, numEdges);
-    EdgeData ed(edgeData, numEdges);
-
-    edge_sort_iterator begin(std::distance(outs, raw_neighbor_begin(N)), &edgeDst, &ed);
-    edge_sort_iterator end(std::distance(outs, raw_neighbor_end(N)), &edgeDst, &ed);
-
-    std::sort(begin, end, comp);
+  void sortEdges(LargeGraphNode N, const CompTy& comp) {
+    if (graphVersion == 1)
+      sortEdgesImpl<uint32_t,EdgeTy>(N, comp);
+    else
+      sortEdgesImpl<uint64_t,EdgeTy>(N, comp);
   }
 
   template<typename EdgeTy> 
@@ -175,19 +232,19 @@ public:
     return reinterpret_cast<EdgeTy*>(edgeData)[*it];
   }
 
-  GraphNode getEdgeDst(edge_iterator it) const;
+  LargeGraphNode getEdgeDst(edge_iterator it) const;
 
-  typedef boost::transform_iterator<Convert32, uint32_t*> neighbor_iterator;
-  typedef boost::transform_iterator<Convert32, uint32_t*> node_id_iterator;
+  typedef boost::transform_iterator<EdgeDst, edge_iterator> neighbor_iterator;
+  typedef boost::transform_iterator<EdgeDst, edge_iterator> node_id_iterator;
   typedef boost::transform_iterator<Convert64, uint64_t*> edge_id_iterator;
   typedef boost::counting_iterator<uint64_t> iterator;
   
-  neighbor_iterator neighbor_begin(GraphNode N) const {
-    return boost::make_transform_iterator(raw_neighbor_begin(N), Convert32());
+  neighbor_iterator neighbor_begin(LargeGraphNode N) const {
+    return boost::make_transform_iterator(edge_begin(N), EdgeDst(this));
   }
 
-  neighbor_iterator neighbor_end(GraphNode N) const {
-    return boost::make_transform_iterator(raw_neighbor_end(N), Convert32());
+  neighbor_iterator neighbor_end(LargeGraphNode N) const {
+    return boost::make_transform_iterator(edge_end(N), EdgeDst(this));
   }
 
   template<typename EdgeTy>
@@ -217,20 +274,26 @@ public:
 
   template<typename EdgeTy>
   EdgeTy& getEdgeData(neighbor_iterator it) {
-    return reinterpret_cast<EdgeTy*>(edgeData)[std::distance(outs, it.base())];
+    return reinterpret_cast<EdgeTy*>(edgeData)[*it.base()];
   }
 
-  bool hasNeighbor(GraphNode N1, GraphNode N2) const;
+  bool hasNeighbor(LargeGraphNode N1, LargeGraphNode N2) const;
 
   //! Returns the number of nodes in the graph
-  unsigned int size() const { return numNodes; }
+  uint64_t size() const { return numNodes; }
 
   //! Returns the number of edges in the graph
-  unsigned int sizeEdges() const { return numEdges; }
+  uint64_t sizeEdges() const { return numEdges; }
 
   //! Returns the size of an edge
   size_t edgeSize() const { return sizeofEdge; }
 
+  //! Returns the file format version of the graph
+  uint64_t version() const { return graphVersion; }
+
+  //! Returns the size of an edge destination
+  size_t sizeofEdgeDst() const { return graphVersion == 1 ? sizeof(uint32_t) : sizeof(uint64_t); }
+
   FileGraph();
   ~FileGraph();
 
@@ -259,10 +322,18 @@ public:
    * Reads graph connectivity information from arrays. Returns a pointer to
    * array to populate with edge data.
    */
-  template<typename T>
+  template<typename T, typename DstTy>
   T* structureFromArrays(uint64_t* outIdxs, uint64_t numNodes,
-      uint32_t* outs, uint64_t numEdges) {
-    return reinterpret_cast<T*>(structureFromArrays(outIdx, numNodes, outs, numEdges, sizeof(T)));
+      DstTy* outs, uint64_t numEdges,
+      typename std::enable_if<!std::is_void<T>::value>::type* = 0) {
+    return reinterpret_cast<T*>(structureFromArrays(outIdxs, numNodes, outs, numEdges, sizeof(T)));
+  }
+
+  template<typename T, typename DstTy>
+  T* structureFromArrays(uint64_t* outIdxs, uint64_t numNodes,
+      DstTy* outs, uint64_t numEdges,
+      typename std::enable_if<std::is_void<T>::value>::type* = 0) {
+    return structureFromArrays(outIdxs, numNodes, outs, numEdges, 0);
   }
 
   /** 
@@ -293,23 +364,30 @@ public:
  *    dst)</li>
  *  <li>finish(), use as FileGraph</li>
  * </ol>
+ *
+ * incrementDegree() and addNeighbor() may be called concurrently (e.g., from
+ * a Galois::do_all), in which case the order of the neighbors of a node is
+ * unspecified until they are put in a fixed order with sortNeighbors().
+ *
+ * Graphs with more than 2^32 nodes are written in the version 2 format.
+ *
+ * Neighbors are written directly into the final graph. After phase2(), edge
+ * data for the edge returned by addNeighbor() can be written through
+ * edge_data_begin().
  */
 class FileGraphWriter: public FileGraph {
   uint64_t *outIdx; // outIdxs
   uint32_t *starts;
-  uint32_t *outs; // outs
   size_t sizeofEdgeData;
 
 public:
-  FileGraphWriter(): outIdx(0), starts(0), outs(0), sizeofEdgeData(0) { }
+  FileGraphWriter(): outIdx(0), starts(0), sizeofEdgeData(0) { }
 
   ~FileGraphWriter() { 
     if (outIdx)
       delete [] outIdx;
     if (starts)
       delete [] starts;
-    if (outs)
-      delete [] outs;
   }
 
   void setNumNodes(uint64_t n) { this->numNodes = n; }
@@ -318,115 +396,232 @@ public:
   
   //! Marks the transition to next phase of parsing, counting the degree of
   //! nodes
-  void phase1() { 
-    assert(!outIdx);
-    outIdx = new uint64_t[this->numNodes];
-    memset(outIdx, 0, sizeof(*outIdx) * this->numNodes);
-  }
+  void phase1();
 
   //! Increments degree of id by delta
   void incrementDegree(size_t id, int delta = 1) {
     assert(id < this->numNodes);
-    outIdx[id] += delta;
+    __sync_fetch_and_add(&outIdx[id], delta);
   }
 
   //! Marks the transition to next phase of parsing, adding edges
-  void phase2() {
-    if (this->numNodes == 0)
-      return;
-
-    // Turn counts into partial sums
-    uint64_t* prev = outIdx;
-    for (uint64_t *ii = outIdx + 1, *ei = outIdx + this->numNodes; ii != ei; ++ii, ++prev) {
-      *ii += *prev;
-    }
-    assert(outIdx[this->numNodes-1] == this->numEdges);
-
-    starts = new uint32_t[this->numNodes];
-    memset(starts, 0, sizeof(*starts) * this->numNodes);
-
-    outs = new uint32_t[this->numEdges];
-  }
+  void phase2();
 
   //! Adds a neighbor between src and dst
   size_t addNeighbor(size_t src, size_t dst) {
     size_t base = src ? outIdx[src-1] : 0;
-    size_t idx = base + starts[src]++;
+    size_t idx = base + __sync_fetch_and_add(&starts[src], 1);
     assert(idx < outIdx[src]);
-    outs[idx] = dst;
+    if (this->graphVersion == 1)
+      static_cast<uint32_t*>(this->outs)[idx] = convert_le32(dst);
+    else
+      static_cast<uint64_t*>(this->outs)[idx] = convert_le64(dst);
     return idx;
   }
 
+  /**
+   * Sorts the neighbors of src by keys, which has an entry for each edge
+   * index returned by addNeighbor() and is permuted along with the
+   * neighbors. Edge data is not moved, so write it after sorting.
+   */
+  template<typename KeyTy>
+  void sortNeighbors(size_t src, LargeArray<KeyTy>& keys) {
+    if (this->graphVersion == 1)
+      sortNeighborsImpl<uint32_t>(src, keys);
+    else
+      sortNeighborsImpl<uint64_t>(src, keys);
+  }
+
   /** 
    * Finish making graph. Returns pointer to block of memory that should be
    * used to store edge data.
    */
   template<typename T>
   T* finish() { 
-    void* ret = structureFromArrays(outIdx, this->numNodes, outs, this->numEdges, sizeofEdgeData);
     delete [] outIdx;
     outIdx = 0;
     delete [] starts;
     starts = 0;
-    delete [] outs;
-    outs = 0;
-    return reinterpret_cast<T*>(ret);
+    return reinterpret_cast<T*>(this->edgeData);
+  }
+
+private:
+  template<typename DstTy, typename KeyTy>
+  void sortNeighborsImpl(size_t src, LargeArray<KeyTy>& keys) {
+    typedef LargeArray<DstTy> EdgeDstData;
+    typedef LargeArray<KeyTy> Keys;
+    typedef detail::EdgeSortIterator<DstTy,uint64_t,EdgeDstData,Keys> edge_sort_iterator;
+    typedef std::less<KeyTy> KeyComp;
+
+    EdgeDstData edgeDst(this->outs, this->numEdges);
+    edge_sort_iterator begin(*this->edge_begin(src), &edgeDst, &keys);
+    edge_sort_iterator end(*this->edge_end(src), &edgeDst, &keys);
+
+    KeyComp comp;
+    std::sort(begin, end, detail::EdgeSortCompWrapper<EdgeSortValue<DstTy,KeyTy>,KeyComp>(comp));
+  }
+};
+
+namespace detail {
+
+//! Calls fn(src, edge) for every edge of a graph, dividing edges among threads
+template<typename Fn>
+struct ForEachFileGraphEdge {
+  FileGraph* g;
+  Fn fn;
+
+  void operator()(unsigned tid, unsigned total) {
+    std::pair<FileGraph::iterator,FileGraph::iterator> r =
+      g->divideBy(sizeof(uint64_t), g->sizeofEdgeDst() + g->edgeSize(), tid, total);
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      for (FileGraph::edge_iterator jj = g->edge_begin(*ii), ej = g->edge_end(*ii); jj != ej; ++jj)
+        fn(*ii, jj);
+    }
+  }
+};
+
+template<typename Fn>
+void forEachFileGraphEdge(FileGraph& g, const Fn& fn) {
+  ForEachFileGraphEdge<Fn> f = { &g, fn };
+  fileGraphOnEach(f);
+}
+
+/**
+ * Writes each edge of the input graph to the edges given by a mapping
+ * function. Used in two passes: one to count degrees and one to add
+ * neighbors. When adding, each new edge is labeled with its position in a
+ * serial pass over the input (input edge index * arity + k).
+ */
+template<typename MapTy>
+struct MapFileGraphEdges {
+  typedef FileGraph::LargeGraphNode GNode;
+
+  FileGraph* in;
+  FileGraphWriter* out;
+  LargeArray<uint64_t>* order;
+  MapTy map;
+  bool add;
+
+  void operator()(GNode src, FileGraph::edge_iterator jj) {
+    GNode dst = in->getEdgeDst(jj);
+    for (unsigned k = 0; k < MapTy::arity; ++k) {
+      std::pair<GNode,GNode> e = map(src, dst, k);
+      if (!add)
+        out->incrementDegree(e.first);
+      else
+        order->set(out->addNeighbor(e.first, e.second), *jj * MapTy::arity + k);
+    }
   }
 };
 
 /**
- * Adds reverse edges to a graph. Reverse edges have edge data copied from the
- * original edge. New graph is placed in out parameter.  The previous graph in
- * out is destroyed.
+ * Puts the neighbors of each node of the output in the order a serial pass
+ * would have added them, independent of the number of threads, and copies
+ * edge data from the input edge each output edge came from.
  */
-template<typename EdgeTy>
-void makeSymmetric(FileGraph& in, FileGraph& out) {
-  typedef FileGraph::GraphNode GNode;
+template<typename EdgeTy, typename MapTy>
+struct SortMappedEdges {
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef typename EdgeData::value_type edge_value_type;
+
+  FileGraph* in;
+  FileGraphWriter* out;
+  LargeArray<uint64_t>* order;
+  EdgeData* outData;
+
+  void operator()(unsigned tid, unsigned total) {
+    std::pair<FileGraph::iterator,FileGraph::iterator> r =
+      out->divideBy(sizeof(uint64_t), out->sizeofEdgeDst() + out->edgeSize(), tid, total);
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      out->sortNeighbors(*ii, *order);
+      if (!EdgeData::has_value)
+        continue;
+      for (FileGraph::edge_iterator jj = out->edge_begin(*ii), ej = out->edge_end(*ii); jj != ej; ++jj) {
+        FileGraph::edge_iterator from(order->at(*jj) / MapTy::arity);
+        outData->set(*jj, in->getEdgeData<edge_value_type>(from));
+      }
+    }
+  }
+};
+
+template<typename EdgeTy, typename MapTy>
+void mapFileGraph(FileGraph& in, const MapTy& map, FileGraph& out) {
   typedef LargeArray<EdgeTy> EdgeData;
   typedef typename EdgeData::value_type edge_value_type;
 
   FileGraphWriter g;
-  EdgeData edgeData;
 
-  size_t numEdges = in.sizeEdges() * 2;
+  size_t numEdges = in.sizeEdges() * MapTy::arity;
   g.setNumNodes(in.size());
   g.setNumEdges(numEdges);
   g.setSizeofEdgeData(EdgeData::has_value ? sizeof(edge_value_type) : 0);
 
   g.phase1();
-  for (FileGraph::iterator ii = in.begin(), ei = in.end(); ii != ei; ++ii) {
-    GNode src = *ii;
-    for (FileGraph::edge_iterator jj = in.edge_begin(src), ej = in.edge_end(src); jj != ej; ++jj) {
-      GNode dst = in.getEdgeDst(jj);
-      g.incrementDegree(src);
-      g.incrementDegree(dst);
-    }
-  }
+  MapFileGraphEdges<MapTy> count = { &in, &g, 0, map, false };
+  forEachFileGraphEdge(in, count);
 
   g.phase2();
-  edgeData.create(numEdges);
-  for (FileGraph::iterator ii = in.begin(), ei = in.end(); ii != ei; ++ii) {
-    GNode src = *ii;
-    for (FileGraph::edge_iterator jj = in.edge_begin(src), ej = in.edge_end(src); jj != ej; ++jj) {
-      GNode dst = in.getEdgeDst(jj);
-      if (EdgeData::has_value) {
-        edge_value_type& data = in.getEdgeData<edge_value_type>(jj);
-        edgeData.set(g.addNeighbor(src, dst), data);
-        edgeData.set(g.addNeighbor(dst, src), data);
-      } else {
-        g.addNeighbor(src, dst);
-        g.addNeighbor(dst, src);
-      }
-    }
-  }
+  LargeArray<uint64_t> order;
+  order.create(numEdges);
+  MapFileGraphEdges<MapTy> add = { &in, &g, &order, map, true };
+  forEachFileGraphEdge(in, add);
 
-  edge_value_type* rawEdgeData = g.finish<edge_value_type>();
-  if (EdgeData::has_value)
-    std::copy(edgeData.begin(), edgeData.end(), rawEdgeData);
+  EdgeData outData(g.edge_data_begin<edge_value_type>(), numEdges);
+  SortMappedEdges<EdgeTy,MapTy> sort = { &in, &g, &order, &outData };
+  fileGraphOnEach(sort);
 
+  g.finish<edge_value_type>();
   out.swap(g);
 }
 
+struct SymmetricMap {
+  static const unsigned arity = 2;
+  std::pair<FileGraph::LargeGraphNode,FileGraph::LargeGraphNode>
+  operator()(FileGraph::LargeGraphNode src, FileGraph::LargeGraphNode dst, unsigned k) const {
+    return k == 0 ? std::make_pair(src, dst) : std::make_pair(dst, src);
+  }
+};
+
+struct TransposeMap {
+  static const unsigned arity = 1;
+  std::pair<FileGraph::LargeGraphNode,FileGraph::LargeGraphNode>
+  operator()(FileGraph::LargeGraphNode src, FileGraph::LargeGraphNode dst, unsigned k) const {
+    return std::make_pair(dst, src);
+  }
+};
+
+template<typename PTy>
+struct PermuteMap {
+  static const unsigned arity = 1;
+  const PTy* p;
+  std::pair<FileGraph::LargeGraphNode,FileGraph::LargeGraphNode>
+  operator()(FileGraph::LargeGraphNode src, FileGraph::LargeGraphNode dst, unsigned k) const {
+    return std::make_pair((FileGraph::LargeGraphNode) (*p)[src], (FileGraph::LargeGraphNode) (*p)[dst]);
+  }
+};
+
+}
+
+/**
+ * Adds reverse edges to a graph. Reverse edges have edge data copied from the
+ * original edge. New graph is placed in out parameter.  The previous graph in
+ * out is destroyed.
+ */
+template<typename EdgeTy>
+void makeSymmetric(FileGraph& in, FileGraph& out) {
+  detail::mapFileGraph<EdgeTy>(in, detail::SymmetricMap(), out);
+}
+
+/**
+ * Reverses the edges of a graph. Edge data is copied from the original edge.
+ * New graph is placed in out parameter. The previous graph in out is
+ * destroyed.
+ */
+template<typename EdgeTy>
+void transpose(FileGraph& in, FileGraph& out) {
+  detail::mapFileGraph<EdgeTy>(in, detail::TransposeMap(), out);
+}
+
 /**
  * Permutes a graph.
  *
@@ -440,46 +635,8 @@ void makeSymmetric(FileGraph& in, FileGraph& out) {
  */
 template<typename EdgeTy,typename PTy>
 void permute(FileGraph& in, const PTy& p, FileGraph& out) {
-  typedef FileGraph::GraphNode GNode;
-  typedef LargeArray<EdgeTy> EdgeData;
-  typedef typename EdgeData::value_type edge_value_type;
-
-  FileGraphWriter g;
-  EdgeData edgeData;
-
-  size_t numEdges = in.sizeEdges();
-  g.setNumNodes(in.size());
-  g.setNumEdges(numEdges);
-  g.setSizeofEdgeData(EdgeData::has_value ? sizeof(edge_value_type) : 0);
-
-  g.phase1();
-  for (FileGraph::iterator ii = in.begin(), ei = in.end(); ii != ei; ++ii) {
-    GNode src = *ii;
-    for (FileGraph::edge_iterator jj = in.edge_begin(src), ej = in.edge_end(src); jj != ej; ++jj) {
-      g.incrementDegree(p[src]);
-    }
-  }
-
-  g.phase2();
-  edgeData.create(numEdges);
-  for (FileGraph::iterator ii = in.begin(), ei = in.end(); ii != ei; ++ii) {
-    GNode src = *ii;
-    for (FileGraph::edge_iterator jj = in.edge_begin(src), ej = in.edge_end(src); jj != ej; ++jj) {
-      GNode dst = in.getEdgeDst(jj);
-      if (EdgeData::has_value) {
-        edge_value_type& data = in.getEdgeData<edge_value_type>(jj);
-        edgeData.set(g.addNeighbor(p[src], p[dst]), data);
-      } else {
-        g.addNeighbor(p[src], p[dst]);
-      }
-    }
-  }
-
-  edge_value_type* rawEdgeData = g.finish<edge_value_type>();
-  if (EdgeData::has_value)
-    std::copy(edgeData.begin(), edgeData.end(), rawEdgeData);
-
-  out.swap(g);
+  detail::PermuteMap<PTy> map = { &p };
+  detail::mapFileGraph<EdgeTy>(in, map, out);
 }
 
 template<typename GraphTy,typename... Args>
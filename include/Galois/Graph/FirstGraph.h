@@ -32,6 +32,7 @@
 #include "llvm/ADT/SmallVector.h"
 
 #include <boost/functional.hpp>
+#include <boost/utility.hpp>
 #include <boost/iterator/transform_iterator.hpp>
 #include <boost/iterator/filter_iterator.hpp>
 
@@ -39,6 +40,7 @@
 #include <map>
 #include <set>
 #include <vector>
+#include <stdint.h>
 
 namespace Galois {
 //! Parallel graph data structures.
@@ -142,6 +144,89 @@ struct EdgeFactory<void> {
   bool mustDel() const { return false; }
 };
 
+//! Nodes with at least this many edges index their edges by destination
+const unsigned EdgeIndexThreshold = 32;
+
+/**
+ * Open-addressing hash index from the destination of an edge to its
+ * position in an adjacency list. Keys are read from the list, so the index
+ * only stores positions.
+ */
+class EdgeIndex {
+  enum { empty = ~0U, deleted = ~0U - 1 };
+
+  std::vector<unsigned> slots;
+  //! Number of slots that are not empty, including deleted ones
+  size_t used;
+
+  size_t hash(const void* key) const {
+    uint64_t h = reinterpret_cast<uintptr_t>(key) * 0x9E3779B97F4A7C15ULL;
+    return (h >> 32) & (slots.size() - 1);
+  }
+
+  size_t next(size_t s) const { return (s + 1) & (slots.size() - 1); }
+
+public:
+  enum { npos = ~0U };
+
+  EdgeIndex(): used(0) { }
+
+  //! Indexes all of edges
+  template<typename EdgesTy>
+  void rebuild(const EdgesTy& edges) {
+    size_t cap = 16;
+    while (cap < 2 * edges.size())
+      cap *= 2;
+    slots.assign(cap, (unsigned) empty);
+    used = 0;
+    for (size_t i = 0; i < edges.size(); ++i)
+      insert(edges[i].first(), i);
+  }
+
+  //! Adds position pos with destination key; returns false if the index should be rebuilt
+  bool insert(const void* key, unsigned pos) {
+    size_t s = hash(key);
+    while (slots[s] != empty && slots[s] != deleted)
+      s = next(s);
+    if (slots[s] == empty)
+      ++used;
+    slots[s] = pos;
+    return 2 * used <= slots.size();
+  }
+
+  //! Position of some edge with destination key, or npos
+  template<typename EdgesTy>
+  unsigned find(const EdgesTy& edges, const void* key) const {
+    for (size_t s = hash(key); slots[s] != empty; s = next(s)) {
+      if (slots[s] != deleted && edges[slots[s]].first() == key)
+        return slots[s];
+    }
+    return npos;
+  }
+
+  //! Changes position from (destination key) to to
+  void move(const void* key, unsigned from, unsigned to) {
+    size_t s = hash(key);
+    while (slots[s] != from)
+      s = next(s);
+    slots[s] = to;
+  }
+
+  void remove(const void* key, unsigned pos) {
+    move(key, pos, deleted);
+  }
+
+  //! Removes position pos and shifts later positions down by one, to follow
+  //! an erase from the middle of the list
+  void removeAndShift(const void* key, unsigned pos) {
+    remove(key, pos);
+    for (size_t s = 0; s < slots.size(); ++s) {
+      if (slots[s] != empty && slots[s] != deleted && slots[s] > pos)
+        --slots[s];
+    }
+  }
+};
+
 } // end namespace impl
 
 /**
@@ -230,9 +315,11 @@ private:
     typedef typename EdgesTy::iterator iterator;
   };
 
+  //! Not copyable because it owns its edge index
   class gNode:
     public detail::NodeInfoBase<NodeTy, !HasNoLockable>,
-    public gNodeTypes
+    public gNodeTypes,
+    private boost::noncopyable
   {
     friend class FirstGraph;
     typedef detail::NodeInfoBase<NodeTy, !HasNoLockable> NodeInfo;
@@ -240,44 +327,105 @@ private:
     typedef typename gNode::iterator iterator;
     typedef typename gNode::EdgeInfo EdgeInfo;
 
+    FirstGraphImpl::EdgeIndex* index;
     bool active;
     
     iterator begin() { return edges.begin(); }
     iterator end() { return edges.end();  }
+
+    //! Indexes edges once there are enough of them and drops the index when there are few
+    void reindex() {
+      if (edges.size() >= FirstGraphImpl::EdgeIndexThreshold) {
+        if (!index)
+          index = new FirstGraphImpl::EdgeIndex();
+        index->rebuild(edges);
+      } else if (index && edges.size() < FirstGraphImpl::EdgeIndexThreshold / 2) {
+        delete index;
+        index = 0;
+      } else if (index) {
+        index->rebuild(edges);
+      }
+    }
+
+    iterator append(const EdgeInfo& e) {
+      edges.push_back(e);
+      if (index) {
+        if (!index->insert(edges.back().first(), edges.size() - 1))
+          index->rebuild(edges);
+      } else if (edges.size() >= FirstGraphImpl::EdgeIndexThreshold) {
+        reindex();
+      }
+      return end() - 1;
+    }
+
+    //! Removes edges to nodes that are no longer in the graph, keeping the order of the rest
+    void compact() {
+      iterator ii = std::remove_if(begin(), end(), first_not_valid());
+      if (ii == end())
+        return;
+      edges.erase(ii, end());
+      reindex();
+    }
     
+    //! Removes the edge at ii by moving the last edge into its place
     void erase(iterator ii) {
+      unsigned pos = ii - begin();
+      unsigned last = edges.size() - 1;
+      if (index) {
+        index->remove(ii->first(), pos);
+        if (pos != last)
+          index->move(edges.back().first(), last, pos);
+      }
       *ii = edges.back();
       edges.pop_back();
     }
 
+    //! Removes the edge to N, keeping the order of the remaining edges
     void erase(gNode* N) { 
       iterator ii = find(N);
-      if (ii != end())
-        edges.erase(ii); 
+      if (ii == end())
+        return;
+      if (index)
+        index->removeAndShift(N, ii - begin());
+      edges.erase(ii);
+    }
+
+    void clearEdges() {
+      edges.clear();
+      delete index;
+      index = 0;
     }
 
     iterator find(gNode* N) {
+      if (!N || !N->active)
+        return end();
+      if (index) {
+        unsigned pos = index->find(edges, N);
+        return pos == FirstGraphImpl::EdgeIndex::npos ? end() : begin() + pos;
+      }
       return std::find_if(begin(), end(), first_eq_and_valid<gNode*>(N));
     }
 
     void resizeEdges(size_t size) {
       edges.resize(size, EdgeInfo(new gNode(), 0));
+      reindex();
     }
 
     template<typename... Args>
     iterator createEdge(gNode* N, EdgeTy* v, Args&&... args) {
-      return edges.insert(edges.end(), EdgeInfo(N, v, std::forward<Args>(args)...));
+      return append(EdgeInfo(N, v, std::forward<Args>(args)...));
     }
 
+    /**
+     * Adds an edge. Edges to removed nodes are dropped when the edge list
+     * is full rather than searched for on every insertion, so their cost is
+     * amortized over the growth of the list.
+     */
     template<typename... Args>
     iterator createEdgeWithReuse(gNode* N, EdgeTy* v, Args&&... args) {
-      //First check for holes
-      iterator ii = std::find_if(begin(), end(), first_not_valid());
-      if (ii != end()) {
-	*ii = EdgeInfo(N, v, std::forward<Args>(args)...);
-	return ii;
-      }
-      return edges.insert(edges.end(), EdgeInfo(N, v, std::forward<Args>(args)...));
+      if (edges.size() == edges.capacity())
+        compact();
+      return append(EdgeInfo(N, v, std::forward<Args>(args)...));
     }
 
     template<bool _A1 = HasNoLockable>
@@ -290,7 +438,11 @@ private:
 
   public:
     template<typename... Args>
-    gNode(Args&&... args): NodeInfo(std::forward<Args>(args)...), active(false) { }
+    gNode(Args&&... args): NodeInfo(std::forward<Args>(args)...), index(0), active(false) { }
+
+    ~gNode() {
+      delete index;
+    }
   };
 
   //The graph manages the lifetimes of the data in the nodes and edges
@@ -420,7 +572,7 @@ public:
       if (!Directional && edges.mustDel())
 	for (edge_iterator ii = edge_begin(n, MethodFlag::NONE), ee = edge_end(n, MethodFlag::NONE); ii != ee; ++ii)
 	  edges.delEdge(ii->second());
-      N->edges.clear();
+      N->clearEdges();
     }
   }
 
@@ -459,11 +611,12 @@ public:
     if (Directional) {
       src->erase(dst.base());
     } else {
-      dst->first()->acquire(mflag);
+      gNode* N = dst->first();
+      N->acquire(mflag);
       EdgeTy* e = dst->second();
       edges.delEdge(e);
       src->erase(dst.base());
-      dst->first()->erase(src);
+      N->erase(src);
     }
   }
 
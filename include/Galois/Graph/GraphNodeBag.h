@@ -2,7 +2,7 @@
 #define GALOIS_GRAPHNODEBAG_H
 
 #include "Galois/Accumulator.h"
-#include "Galois/LargeArray.h"
+#include "Galois/AtomicBitset.h"
 #include "Galois/Bag.h"
 
 namespace Galois {
@@ -13,39 +13,40 @@ namespace Galois {
 template<unsigned int BlockSize = 0>
 class GraphNodeBag {
   typedef Galois::InsertBag<size_t, BlockSize> Bag;
-  typedef Galois::LargeArray<bool> Bitmask;
+  typedef Galois::AtomicBitset Bitmask;
 
   Bag bag;
   Galois::GAccumulator<size_t> counts;
   Galois::GAccumulator<size_t> numNodes;
   Bitmask bitmask;
   size_t size;
-  bool isDense;
+  bool dense;
 
   struct InitializeSmall {
     GraphNodeBag* self;
     void operator()(size_t n) {
-      self->bitmask[n] = 0;
+      self->bitmask.reset(n);
     }
   };
 
-  struct InitializeBig {
+  struct Densify {
     GraphNodeBag* self;
-    void operator()(unsigned id, unsigned total) {
-      typedef typename Bitmask::iterator It;
-      std::pair<It,It> p = Galois::block_range(self->bitmask.begin(), self->bitmask.end(), id, total);
-      std::fill(p.first, p.second, 0);
+    void operator()(size_t n) {
+      self->bitmask.set(n);
     }
   };
 
-  struct Densify {
+  struct Sparsify {
     GraphNodeBag* self;
     void operator()(size_t n) {
-      self->bitmask[n] = true;
+      self->bag.push(n);
+    }
+    void operator()(unsigned id, unsigned total) {
+      self->numNodes += self->bitmask.forEachSet(id, total, *this);
     }
   };
 public:
-  GraphNodeBag(size_t n): size(n), isDense(false) { }
+  GraphNodeBag(size_t n): size(n), dense(false) { }
 
   typedef typename Bag::iterator iterator;
   typedef typename Bag::local_iterator local_iterator;
@@ -55,13 +56,23 @@ public:
   local_iterator local_begin() { return bag.local_begin(); }
   local_iterator local_end() { return bag.local_end(); }
 
+  //! Adds n if it is not already in the bag; bag must be dense
   void pushDense(size_t n, size_t numEdges) {
-    assert(isDense);
+    assert(dense);
 
-    if (!bitmask[n]) {
-      bitmask[n] = true;
+    if (bitmask.set(n))
       push(n, numEdges);
-    }
+  }
+
+  /**
+   * Adds n to the dense form only; bag must be dense. Call {@link sparsify}
+   * once all nodes are added to make them visible to iteration.
+   */
+  void pushBit(size_t n, size_t numEdges) {
+    assert(dense);
+
+    if (bitmask.set(n))
+      counts += 1 + numEdges;
   }
 
   void push(size_t n, size_t numEdges) {
@@ -75,31 +86,34 @@ public:
   size_t getSize() { return numNodes.reduce(); }
 
   void clear() { 
-    if (isDense) {
+    if (dense) {
       if (numNodes.reduce() < bitmask.size() / 4) {
         InitializeSmall fn = { this };
         Galois::do_all_local(bag, fn);
       } else {
-        InitializeBig fn = { this };
-        Galois::on_each(fn);
+        bitmask.clear();
       }
     }
     bag.clear();
     counts.reset();
     numNodes.reset();
 
-    isDense = false;
+    dense = false;
   }
 
   bool contains(size_t n) {
-    assert(isDense);
-    return bitmask[n];
+    assert(dense);
+    return bitmask.test(n);
   }
 
   bool empty() const { return bag.empty(); }
 
+  //! Returns true if the dense form is available
+  bool isDense() const { return dense; }
+
+  //! Makes the dense form available; marks every node in the sparse form
   void densify() {
-    isDense = true;
+    dense = true;
     if (bitmask.size() == 0) {
       bitmask.create(size);
     }
@@ -107,6 +121,16 @@ public:
     Densify fn = { this };
     Galois::do_all_local(bag, fn);
   }
+
+  //! Rebuilds the sparse form from the dense form in node order
+  void sparsify() {
+    assert(dense);
+    bag.clear();
+    numNodes.reset();
+
+    Sparsify fn = { this };
+    Galois::on_each(fn);
+  }
 };
 
 /**
@@ -34,6 +34,7 @@
 #include "LC_CSR_Graph.h"
 #include "LC_InlineEdge_Graph.h"
 #include "LC_Linear_Graph.h"
+#include "LC_Compressed_Graph.h"
 #include "LC_Morph_Graph.h"
 #include "LC_InOut_Graph.h"
 #include "Util.h"
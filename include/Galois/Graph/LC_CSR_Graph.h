@@ -86,11 +86,14 @@ namespace Graph {
  *
  * @tparam NodeTy data on nodes
  * @tparam EdgeTy data on out edges
+ * @tparam NodeIdTy integer type of node ids; use uint64_t for graphs with
+ *   more than 2^32 nodes
  */
 template<typename NodeTy, typename EdgeTy,
   bool HasNoLockable=false,
   bool UseNumaAlloc=false,
-  bool HasOutOfLineLockable=false>
+  bool HasOutOfLineLockable=false,
+  typename NodeIdTy=uint32_t>
 class LC_CSR_Graph:
     private boost::noncopyable,
     private detail::LocalIteratorFeature<UseNumaAlloc>,
@@ -102,32 +105,36 @@ public:
   struct with_id { typedef LC_CSR_Graph type; };
 
   template<typename _node_data>
-  struct with_node_data { typedef LC_CSR_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable> type; };
+  struct with_node_data { typedef LC_CSR_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,NodeIdTy> type; };
 
   //! If true, do not use abstract locks in graph
   template<bool _has_no_lockable>
-  struct with_no_lockable { typedef LC_CSR_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable> type; };
+  struct with_no_lockable { typedef LC_CSR_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable,NodeIdTy> type; };
 
   //! If true, use NUMA-aware graph allocation
   template<bool _use_numa_alloc>
-  struct with_numa_alloc { typedef LC_CSR_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable> type; };
+  struct with_numa_alloc { typedef LC_CSR_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable,NodeIdTy> type; };
 
   //! If true, store abstract locks separate from nodes
   template<bool _has_out_of_line_lockable>
-  struct with_out_of_line_lockable { typedef LC_CSR_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable> type; };
+  struct with_out_of_line_lockable { typedef LC_CSR_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable,NodeIdTy> type; };
+
+  //! Integer type of node ids
+  template<typename _node_id>
+  struct with_node_id { typedef LC_CSR_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,_node_id> type; };
 
   typedef read_default_graph_tag read_tag;
 
 protected:
   typedef LargeArray<EdgeTy> EdgeData;
-  typedef LargeArray<uint32_t> EdgeDst;
+  typedef LargeArray<NodeIdTy> EdgeDst;
   typedef detail::NodeInfoBaseTypes<NodeTy,!HasNoLockable && !HasOutOfLineLockable> NodeInfoTypes;
   typedef detail::NodeInfoBase<NodeTy,!HasNoLockable && !HasOutOfLineLockable> NodeInfo;
   typedef LargeArray<uint64_t> EdgeIndData;
   typedef LargeArray<NodeInfo> NodeData;
 
 public:
-  typedef uint32_t GraphNode;
+  typedef NodeIdTy GraphNode;
   typedef EdgeTy edge_data_type;
   typedef NodeTy node_data_type;
   typedef typename EdgeData::reference edge_data_reference;
@@ -187,6 +194,11 @@ protected:
   }
 
 public:
+  //! Returns the id of N, which is in [0, size())
+  size_t idFromNode(GraphNode N) {
+    return getId(N);
+  }
+
   node_data_reference getData(GraphNode N, MethodFlag mflag = MethodFlag::ALL) {
     Galois::Runtime::checkWrite(mflag, false);
     NodeInfo& NI = nodeData[N];
@@ -254,6 +266,7 @@ public:
   void allocateFrom(FileGraph& graph) {
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
+    detail::checkNodeIdRange<GraphNode>(numNodes);
     if (UseNumaAlloc) {
       nodeData.allocateLocal(numNodes, false);
       edgeIndData.allocateLocal(numNodes, false);
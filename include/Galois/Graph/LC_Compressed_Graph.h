@@ -0,0 +1,338 @@
+/** Local Computation graphs -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_GRAPH_LC_COMPRESSED_GRAPH_H
+#define GALOIS_GRAPH_LC_COMPRESSED_GRAPH_H
+
+#include "Galois/config.h"
+#include "Galois/LargeArray.h"
+#include "Galois/Graph/FileGraph.h"
+#include "Galois/Graph/CompressedGraphFormat.h"
+#include "Galois/Graph/Details.h"
+#include "Galois/Runtime/MethodFlags.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Galois {
+namespace Graph {
+
+/**
+ * Local computation graph (i.e., graph structure does not change) that
+ * stores the destinations of each node as group varint encoded differences
+ * (see CompressedGraphFormat.h). Uses fewer bytes per edge than {@link
+ * LC_CSR_Graph} at the cost of decoding during edge iteration.
+ *
+ * Edge iterators are forward iterators; neighbors are visited in increasing
+ * order of destination. Edges cannot be sorted.
+ *
+ * The graph can be read from a regular .gr file or from a compressed .cgr
+ * file produced by graph-convert.
+ *
+ * The position of template parameters may change between Galois releases; the
+ * most robust way to specify them is through the with_XXX nested templates.
+ *
+ * @tparam NodeTy data on nodes
+ * @tparam EdgeTy data on out edges
+ */
+template<typename NodeTy, typename EdgeTy,
+  bool HasNoLockable=false,
+  bool UseNumaAlloc=false,
+  bool HasOutOfLineLockable=false,
+  typename NodeIdTy=uint32_t>
+class LC_Compressed_Graph:
+    private boost::noncopyable,
+    private detail::LocalIteratorFeature<UseNumaAlloc>,
+    private detail::OutOfLineLockableFeature<HasOutOfLineLockable && !HasNoLockable> {
+  template<typename Graph> friend class LC_InOut_Graph;
+
+public:
+  template<bool _has_id>
+  struct with_id { typedef LC_Compressed_Graph type; };
+
+  template<typename _node_data>
+  struct with_node_data { typedef LC_Compressed_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,NodeIdTy> type; };
+
+  //! If true, do not use abstract locks in graph
+  template<bool _has_no_lockable>
+  struct with_no_lockable { typedef LC_Compressed_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable,NodeIdTy> type; };
+
+  //! If true, use NUMA-aware graph allocation
+  template<bool _use_numa_alloc>
+  struct with_numa_alloc { typedef LC_Compressed_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable,NodeIdTy> type; };
+
+  //! If true, store abstract locks separate from nodes
+  template<bool _has_out_of_line_lockable>
+  struct with_out_of_line_lockable { typedef LC_Compressed_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable,NodeIdTy> type; };
+
+  //! Integer type of node ids
+  template<typename _node_id>
+  struct with_node_id { typedef LC_Compressed_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,_node_id> type; };
+
+  typedef read_compressed_graph_tag read_tag;
+
+protected:
+  typedef LargeArray<EdgeTy> EdgeData;
+  typedef LargeArray<uint8_t> EdgeBytes;
+  typedef detail::NodeInfoBaseTypes<NodeTy,!HasNoLockable && !HasOutOfLineLockable> NodeInfoTypes;
+  typedef detail::NodeInfoBase<NodeTy,!HasNoLockable && !HasOutOfLineLockable> NodeInfo;
+  typedef LargeArray<uint64_t> EdgeIndData;
+  typedef LargeArray<NodeInfo> NodeData;
+
+public:
+  typedef NodeIdTy GraphNode;
+  typedef EdgeTy edge_data_type;
+  typedef NodeTy node_data_type;
+  typedef typename EdgeData::reference edge_data_reference;
+  typedef typename NodeInfoTypes::reference node_data_reference;
+  typedef detail::CompressedEdgeIterator<NodeIdTy> edge_iterator;
+  typedef boost::counting_iterator<NodeIdTy> iterator;
+  typedef iterator const_iterator;
+  typedef iterator local_iterator;
+  typedef iterator const_local_iterator;
+
+protected:
+  NodeData nodeData;
+  EdgeIndData edgeIndData;
+  EdgeIndData byteIndData;
+  EdgeBytes edgeBytes;
+  EdgeData edgeData;
+
+  uint64_t numNodes;
+  uint64_t numEdges;
+  uint64_t numBytes;
+
+  edge_iterator raw_begin(GraphNode N) const {
+    uint64_t byte = (N == 0) ? 0 : byteIndData[N-1];
+    return edge_iterator(edgeBytes.data() + byte, (N == 0) ? 0 : edgeIndData[N-1], edgeIndData[N]);
+  }
+
+  edge_iterator raw_end(GraphNode N) const {
+    return edge_iterator(0, edgeIndData[N], edgeIndData[N]);
+  }
+
+  template<bool _A1 = HasNoLockable, bool _A2 = HasOutOfLineLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag, typename std::enable_if<!_A1 && !_A2>::type* = 0) {
+    Galois::Runtime::acquire(&nodeData[N], mflag);
+  }
+
+  template<bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag, typename std::enable_if<_A1 && !_A2>::type* = 0) {
+    this->outOfLineAcquire(getId(N), mflag);
+  }
+
+  template<bool _A1 = HasOutOfLineLockable, bool _A2 = HasNoLockable>
+  void acquireNode(GraphNode N, MethodFlag mflag, typename std::enable_if<_A2>::type* = 0) { }
+
+  size_t getId(GraphNode N) {
+    return N;
+  }
+
+  GraphNode getNode(size_t n) {
+    return n;
+  }
+
+  std::pair<FileGraph::iterator,FileGraph::iterator> divide(FileGraph& graph, unsigned tid, unsigned total) {
+    // Assume about 2 bytes per edge
+    return graph.divideBy(
+        NodeData::size_of::value + 2 * EdgeIndData::size_of::value + LC_Compressed_Graph::size_of_out_of_line::value,
+        2 + EdgeData::size_of::value,
+        tid, total);
+  }
+
+public:
+  //! Returns the id of N, which is in [0, size())
+  size_t idFromNode(GraphNode N) {
+    return getId(N);
+  }
+
+  node_data_reference getData(GraphNode N, MethodFlag mflag = MethodFlag::ALL) {
+    Galois::Runtime::checkWrite(mflag, false);
+    NodeInfo& NI = nodeData[N];
+    acquireNode(N, mflag);
+    return NI.getData();
+  }
+
+  edge_data_reference getEdgeData(edge_iterator ni, MethodFlag mflag = MethodFlag::NONE) {
+    Galois::Runtime::checkWrite(mflag, false);
+    return edgeData[*ni];
+  }
+
+  GraphNode getEdgeDst(edge_iterator ni) {
+    return ni.getDst();
+  }
+
+  uint64_t size() const { return numNodes; }
+  uint64_t sizeEdges() const { return numEdges; }
+
+  //! Returns the number of bytes used to store edge destinations
+  uint64_t sizeEdgeBytes() const { return numBytes; }
+
+  iterator begin() const { return iterator(0); }
+  iterator end() const { return iterator(numNodes); }
+
+  const_local_iterator local_begin() const { return const_local_iterator(this->localBegin(numNodes)); }
+  const_local_iterator local_end() const { return const_local_iterator(this->localEnd(numNodes)); }
+  local_iterator local_begin() { return local_iterator(this->localBegin(numNodes)); }
+  local_iterator local_end() { return local_iterator(this->localEnd(numNodes)); }
+
+  edge_iterator edge_begin(GraphNode N, MethodFlag mflag = MethodFlag::ALL) {
+    acquireNode(N, mflag);
+    if (Galois::Runtime::shouldLock(mflag)) {
+      for (edge_iterator ii = raw_begin(N), ee = raw_end(N); ii != ee; ++ii) {
+        acquireNode(ii.getDst(), mflag);
+      }
+    }
+    return raw_begin(N);
+  }
+
+  edge_iterator edge_end(GraphNode N, MethodFlag mflag = MethodFlag::ALL) {
+    acquireNode(N, mflag);
+    return raw_end(N);
+  }
+
+  detail::EdgesIterator<LC_Compressed_Graph> out_edges(GraphNode N, MethodFlag mflag = MethodFlag::ALL) {
+    return detail::EdgesIterator<LC_Compressed_Graph>(*this, N, mflag);
+  }
+
+  void allocateFrom(FileGraph& graph) {
+    numNodes = graph.size();
+    numEdges = graph.sizeEdges();
+    detail::checkNodeIdRange<GraphNode>(numNodes);
+    if (UseNumaAlloc) {
+      nodeData.allocateLocal(numNodes, false);
+      edgeIndData.allocateLocal(numNodes, false);
+      byteIndData.allocateLocal(numNodes, false);
+      edgeData.allocateLocal(numEdges, false);
+      this->outOfLineAllocateLocal(numNodes, false);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      byteIndData.allocateInterleaved(numNodes);
+      edgeData.allocateInterleaved(numEdges);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
+  //! Computes the encoded size of each node
+  void constructSizesFrom(FileGraph& graph, unsigned tid, unsigned total) {
+    std::vector<std::pair<uint64_t,uint64_t> > neighbors;
+    auto r = divide(graph, tid, total);
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      detail::sortedNeighbors(graph, *ii, neighbors);
+      edgeIndData[*ii] = *graph.edge_end(*ii);
+      byteIndData[*ii] = detail::groupVarintSize(detail::pairFirstBegin(neighbors), detail::pairFirstEnd(neighbors));
+    }
+  }
+
+  //! Turns encoded sizes into byte offsets and allocates encoded edges
+  void allocateEdgesFrom(FileGraph& graph) {
+    numBytes = 0;
+    for (uint64_t n = 0; n < numNodes; ++n) {
+      numBytes += byteIndData[n];
+      byteIndData[n] = numBytes;
+    }
+    if (UseNumaAlloc)
+      edgeBytes.allocateLocal(numBytes, false);
+    else
+      edgeBytes.allocateInterleaved(numBytes);
+  }
+
+  void constructFrom(FileGraph& graph, unsigned tid, unsigned total) {
+    std::vector<std::pair<uint64_t,uint64_t> > neighbors;
+    auto r = divide(graph, tid, total);
+    this->setLocalRange(*r.first, *r.second);
+    for (FileGraph::iterator ii = r.first, ei = r.second; ii != ei; ++ii) {
+      nodeData.constructAt(*ii);
+      this->outOfLineConstructAt(*ii);
+      detail::sortedNeighbors(graph, *ii, neighbors);
+      uint64_t byte = *ii == 0 ? 0 : byteIndData[*ii - 1];
+      detail::groupVarintEncode(detail::pairFirstBegin(neighbors), detail::pairFirstEnd(neighbors), edgeBytes.data() + byte);
+      uint64_t edge = *graph.edge_begin(*ii);
+      for (size_t i = 0; EdgeData::has_value && i < neighbors.size(); ++i) {
+        edgeData.set(edge + i,
+            graph.getEdgeData<typename EdgeData::value_type>(FileGraph::edge_iterator(neighbors[i].second)));
+      }
+    }
+  }
+
+  //! Allocates graph storage for a compressed graph file
+  void allocateFromCompressedFile(const detail::CompressedGraphFile& file, const std::string& filename) {
+    const detail::CompressedGraphHeader& header = file.getHeader();
+    if (EdgeData::has_value && header.sizeofEdge != EdgeData::size_of::value)
+      GALOIS_DIE("edge data size mismatch in ", filename);
+
+    numNodes = header.numNodes;
+    numEdges = header.numEdges;
+    numBytes = header.numBytes;
+    detail::checkNodeIdRange<GraphNode>(numNodes);
+    if (UseNumaAlloc) {
+      nodeData.allocateLocal(numNodes, false);
+      edgeIndData.allocateLocal(numNodes, false);
+      byteIndData.allocateLocal(numNodes, false);
+      edgeBytes.allocateLocal(numBytes, false);
+      edgeData.allocateLocal(numEdges, false);
+      this->outOfLineAllocateLocal(numNodes, false);
+    } else {
+      nodeData.allocateInterleaved(numNodes);
+      edgeIndData.allocateInterleaved(numNodes);
+      byteIndData.allocateInterleaved(numNodes);
+      edgeBytes.allocateInterleaved(numBytes);
+      edgeData.allocateInterleaved(numEdges);
+      this->outOfLineAllocateInterleaved(numNodes);
+    }
+  }
+
+  //! Copies a range of nodes with their encoded edges and edge data from file
+  void constructFromCompressedFile(const detail::CompressedGraphFile& file, unsigned tid, unsigned total) {
+    std::pair<uint64_t,uint64_t> r = file.divideBy(
+        NodeData::size_of::value + 2 * EdgeIndData::size_of::value + LC_Compressed_Graph::size_of_out_of_line::value,
+        EdgeData::size_of::value,
+        tid, total);
+    this->setLocalRange(r.first, r.second);
+    if (r.first == r.second)
+      return;
+
+    for (uint64_t n = r.first; n < r.second; ++n) {
+      nodeData.constructAt(n);
+      this->outOfLineConstructAt(n);
+      edgeIndData[n] = file.edgeEnd(n);
+      byteIndData[n] = file.byteEnd(n);
+    }
+
+    uint64_t byteBegin = file.byteBegin(r.first);
+    std::copy(file.getBytes() + byteBegin, file.getBytes() + byteIndData[r.second - 1], edgeBytes.data() + byteBegin);
+    if (EdgeData::has_value) {
+      uint64_t edgeBegin = file.edgeBegin(r.first);
+      std::copy(file.getEdgeData() + edgeBegin * EdgeData::size_of::value,
+          file.getEdgeData() + edgeIndData[r.second - 1] * EdgeData::size_of::value,
+          reinterpret_cast<char*>(edgeData.data()) + edgeBegin * EdgeData::size_of::value);
+    }
+  }
+};
+
+} // end namespace
+} // end namespace
+
+#endif
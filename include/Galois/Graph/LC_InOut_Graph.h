@@ -26,6 +26,7 @@
 #define GALOIS_GRAPH_LC_INOUT_GRAPH_H
 
 #include "Galois/Graph/Details.h"
+#include "Galois/Graph/FileGraph.h"
 
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/fusion/include/vector.hpp>
@@ -42,6 +43,8 @@ template<typename GraphTy>
 class LC_InOut_Graph: public GraphTy::template with_id<true>::type {
   template<typename G>
   friend void readGraphDispatch(G&, read_lc_inout_graph_tag, const std::string&, const std::string&);
+  template<typename G>
+  friend void readGraphDispatch(G&, read_lc_inout_graph_tag, FileGraph&, FileGraph&);
 
   typedef typename GraphTy
     ::template with_id<true>::type Super;
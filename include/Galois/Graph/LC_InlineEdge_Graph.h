@@ -50,7 +50,8 @@ template<typename NodeTy, typename EdgeTy,
   bool HasNoLockable=false,
   bool UseNumaAlloc=false,
   bool HasOutOfLineLockable=false,
-  bool HasCompressedNodePtr=false>
+  bool HasCompressedNodePtr=false,
+  typename NodeIdTy=uint32_t>
 class LC_InlineEdge_Graph:
     private boost::noncopyable,
     private detail::LocalIteratorFeature<UseNumaAlloc>,
@@ -62,29 +63,33 @@ public:
   struct with_id { typedef LC_InlineEdge_Graph type; };
 
   template<typename _node_data>
-  struct with_node_data { typedef LC_InlineEdge_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,HasCompressedNodePtr> type; };
+  struct with_node_data { typedef LC_InlineEdge_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,HasCompressedNodePtr,NodeIdTy> type; };
 
   template<bool _has_no_lockable>
-  struct with_no_lockable { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable,HasCompressedNodePtr> type; };
+  struct with_no_lockable { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable,HasCompressedNodePtr,NodeIdTy> type; };
 
   template<bool _use_numa_alloc>
-  struct with_numa_alloc { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable,HasCompressedNodePtr> type; };
+  struct with_numa_alloc { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable,HasCompressedNodePtr,NodeIdTy> type; };
 
   template<bool _has_out_of_line_lockable>
-  struct with_out_of_line_lockable { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable,HasCompressedNodePtr> type; };
+  struct with_out_of_line_lockable { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable,HasCompressedNodePtr,NodeIdTy> type; };
 
   /**
    * Compress representation of graph at the expense of one level of indirection on accessing
    * neighbors of a node
    */
   template<bool _has_compressed_node_ptr>
-  struct with_compressed_node_ptr { typedef  LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,_has_compressed_node_ptr> type; };
+  struct with_compressed_node_ptr { typedef  LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,_has_compressed_node_ptr,NodeIdTy> type; };
+
+  //! Integer type of node ids stored in edges when using compressed node pointers
+  template<typename _node_id>
+  struct with_node_id { typedef LC_InlineEdge_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,HasCompressedNodePtr,_node_id> type; };
 
   typedef read_default_graph_tag read_tag;
 
 protected:
   class NodeInfo;
-  typedef detail::EdgeInfoBase<typename boost::mpl::if_c<HasCompressedNodePtr,uint32_t,NodeInfo*>::type,EdgeTy> EdgeInfo;
+  typedef detail::EdgeInfoBase<typename boost::mpl::if_c<HasCompressedNodePtr,NodeIdTy,NodeInfo*>::type,EdgeTy> EdgeInfo;
   typedef LargeArray<EdgeInfo> EdgeData;
   typedef LargeArray<NodeInfo> NodeData;
   typedef detail::NodeInfoBaseTypes<NodeTy,!HasNoLockable && !HasOutOfLineLockable> NodeInfoTypes;
@@ -165,6 +170,11 @@ protected:
   }
 
 public:
+  //! Returns the id of N, which is in [0, size())
+  size_t idFromNode(GraphNode N) {
+    return getId(N);
+  }
+
   ~LC_InlineEdge_Graph() {
     if (!EdgeInfo::has_value) return;
     if (numNodes == 0) return;
@@ -244,6 +254,8 @@ public:
   void allocateFrom(FileGraph& graph) {
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
+    if (HasCompressedNodePtr)
+      detail::checkNodeIdRange<NodeIdTy>(numNodes);
 
     if (UseNumaAlloc) {
       nodeData.allocateLocal(numNodes, false);
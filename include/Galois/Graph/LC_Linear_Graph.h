@@ -50,7 +50,8 @@ template<typename NodeTy, typename EdgeTy,
   bool HasNoLockable=false,
   bool UseNumaAlloc=false,
   bool HasOutOfLineLockable=false,
-  bool HasId=false>
+  bool HasId=false,
+  typename NodeIdTy=uint32_t>
 class LC_Linear_Graph:
     private boost::noncopyable,
     private detail::LocalIteratorFeature<UseNumaAlloc>,
@@ -59,19 +60,23 @@ class LC_Linear_Graph:
 
 public:
   template<bool _has_id>
-  struct with_id { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,_has_id> type; };
+  struct with_id { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,_has_id,NodeIdTy> type; };
 
   template<typename _node_data>
-  struct with_node_data { typedef  LC_Linear_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,HasId> type; };
+  struct with_node_data { typedef  LC_Linear_Graph<_node_data,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,HasId,NodeIdTy> type; };
 
   template<bool _has_no_lockable>
-  struct with_no_lockable { typedef LC_Linear_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable,HasId> type; };
+  struct with_no_lockable { typedef LC_Linear_Graph<NodeTy,EdgeTy,_has_no_lockable,UseNumaAlloc,HasOutOfLineLockable,HasId,NodeIdTy> type; };
 
   template<bool _use_numa_alloc>
-  struct with_numa_alloc { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable,HasId> type; };
+  struct with_numa_alloc { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,_use_numa_alloc,HasOutOfLineLockable,HasId,NodeIdTy> type; };
 
   template<bool _has_out_of_line_lockable>
-  struct with_out_of_line_lockable { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable,_has_out_of_line_lockable||HasId> type; };
+  struct with_out_of_line_lockable { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,_has_out_of_line_lockable,_has_out_of_line_lockable||HasId,NodeIdTy> type; };
+
+  //! Integer type of intrusive node ids
+  template<typename _node_id>
+  struct with_node_id { typedef LC_Linear_Graph<NodeTy,EdgeTy,HasNoLockable,UseNumaAlloc,HasOutOfLineLockable,HasId,_node_id> type; };
 
   typedef read_with_aux_graph_tag read_tag;
 
@@ -83,7 +88,7 @@ protected:
 
   class NodeInfo:
       public detail::NodeInfoBase<NodeTy,!HasNoLockable && !HasOutOfLineLockable>,
-      public detail::IntrusiveId<typename boost::mpl::if_c<HasId,uint32_t,void>::type> {
+      public detail::IntrusiveId<typename boost::mpl::if_c<HasId,NodeIdTy,void>::type> {
     friend class LC_Linear_Graph;
     int numEdges;
 
@@ -159,6 +164,12 @@ protected:
   }
 
 public:
+  //! Returns the id of N, which is in [0, size())
+  template<bool _Enable = HasId>
+  size_t idFromNode(GraphNode N, typename std::enable_if<_Enable>::type* = 0) {
+    return getId(N);
+  }
+
   ~LC_Linear_Graph() { 
     for (typename Nodes::iterator ii = nodes.begin(), ei = nodes.end(); ii != ei; ++ii) {
       NodeInfo* n = *ii;
@@ -242,6 +253,8 @@ public:
   void allocateFrom(FileGraph& graph, const ReadGraphAuxData&) {
     numNodes = graph.size();
     numEdges = graph.sizeEdges();
+    if (HasId)
+      detail::checkNodeIdRange<NodeIdTy>(numNodes);
     if (UseNumaAlloc) {
       data.allocateLocal(sizeof(NodeInfo) * numNodes * 2 + sizeof(EdgeInfo) * numEdges, false);
       nodes.allocateLocal(numNodes, false);
@@ -137,6 +137,12 @@ protected:
   }
 
 public:
+  //! Returns the id of N, which is in [0, size())
+  template<bool _Enable = HasId>
+  size_t idFromNode(GraphNode N, typename std::enable_if<_Enable>::type* = 0) {
+    return getId(N);
+  }
+
   ~LC_Morph_Graph() {
     for (typename Nodes::iterator ii = nodes.begin(), ei = nodes.end(); ii != ei; ++ii) {
       NodeInfo& n = *ii;
@@ -158,6 +158,7 @@ private:
 
     void unload();
     void load(int fd, off64_t offset, size_t begin, size_t len, size_t sizeof_data); 
+    static void prefetch(int fd, off64_t offset, size_t begin, size_t len, size_t sizeof_data);
 
   public:
     Block(): m_mapping(0) { }
@@ -190,11 +191,15 @@ private:
   uint64_t numEdges;
   uint64_t numNodes;
   uint64_t* outIdx;
+  size_t sizeofEdgeDst;
+
+  off64_t outsOffset() const { return (4 + numNodes) * sizeof(uint64_t); }
+  off64_t edgeDataOffset() const;
 
 public:
   typedef Segment segment_type;
 
-  OCFileGraph(): masterMapping(0), masterFD(-1), numEdges(0), numNodes(0), outIdx(0) { }
+  OCFileGraph(): masterMapping(0), masterFD(-1), numEdges(0), numNodes(0), outIdx(0), sizeofEdgeDst(sizeof(uint32_t)) { }
   ~OCFileGraph();
 
   iterator begin() const { return iterator(0); }
@@ -218,8 +223,10 @@ public:
   }
 
   GraphNode getEdgeDst(const segment_type& s, edge_iterator it) {
-    uint32_t* p = reinterpret_cast<uint32_t*>(s.outs.get(*it));
-    return *p;
+    if (sizeofEdgeDst == sizeof(uint32_t))
+      return *reinterpret_cast<uint32_t*>(s.outs.get(*it));
+    // Version 2 files store 64-bit ids; structureFromFile checks they fit
+    return *reinterpret_cast<uint64_t*>(s.outs.get(*it));
   }
 
   void unload(segment_type& s) {
@@ -233,6 +240,10 @@ public:
 
   void load(segment_type& s, edge_iterator begin, edge_iterator end, size_t sizeof_data);
 
+  //! Starts reading edges [begin, end) into the page cache without waiting
+  //! for them
+  void prefetch(edge_iterator begin, edge_iterator end, size_t sizeof_data);
+
   void structureFromFile(const std::string& fname);
 };
 
@@ -409,6 +420,20 @@ public:
     load(seg, LazyObject<EdgeTy>::size_of::value);
   }
 
+  /**
+   * Starts reading seg from disk in the background so that a later load of
+   * seg waits less on I/O.
+   */
+  void prefetch(segment_type& seg) {
+    if (memorySegment || !seg)
+      return;
+
+    size_t sizeof_data = LazyObject<EdgeTy>::size_of::value;
+    outGraph.prefetch(outGraph.edge_begin(*seg.nodeBegin), outGraph.edge_end(seg.nodeEnd[-1]), sizeof_data);
+    if (inGraph != &outGraph)
+      inGraph->prefetch(inGraph->edge_begin(*seg.nodeBegin), inGraph->edge_end(seg.nodeEnd[-1]), sizeof_data);
+  }
+
   void unload(segment_type& seg) {
     if (memorySegment)
       return;
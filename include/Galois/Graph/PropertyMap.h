@@ -0,0 +1,149 @@
+/** Node properties stored outside of a graph -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Per-node values kept in their own arrays rather than in the node data of
+ * a graph. Each property is a separate column, so a loop that reads one
+ * field only brings that field into the cache, and several algorithms can
+ * share one loaded topology.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_GRAPH_PROPERTYMAP_H
+#define GALOIS_GRAPH_PROPERTYMAP_H
+
+#include "Galois/Galois.h"
+#include "Galois/LargeArray.h"
+#include "Galois/gstl.h"
+
+#include <boost/utility.hpp>
+#include <algorithm>
+#include <memory>
+
+namespace Galois {
+namespace Graph {
+
+/**
+ * Array of values of type T, one per node of a graph, allocated interleaved
+ * across NUMA nodes. Nodes are mapped to positions with idFromNode(), so any
+ * graph with dense node ids (the LC graphs) can be used. Maps can be
+ * attached to and detached from a graph at any time after it is loaded.
+ *
+ * \code
+ * typedef Galois::Graph::LC_CSR_Graph<void, void> Graph;
+ * Graph g;
+ * Galois::Graph::readGraph(g, filename);
+ * Galois::Graph::NodePropertyMap<Graph, float> rank(g, 1.0);
+ * for (Graph::iterator ii = g.begin(), ei = g.end(); ii != ei; ++ii)
+ *   rank[*ii] *= 0.5;
+ * rank.detach();
+ * \endcode
+ */
+template<typename GraphTy, typename T>
+class NodePropertyMap: private boost::noncopyable {
+public:
+  typedef GraphTy graph_type;
+  typedef typename GraphTy::GraphNode GraphNode;
+  typedef LargeArray<T> Data;
+  typedef typename Data::value_type value_type;
+  typedef typename Data::reference reference;
+  typedef typename Data::const_reference const_reference;
+  typedef typename Data::iterator iterator;
+  typedef typename Data::const_iterator const_iterator;
+
+private:
+  GraphTy* graph;
+  Data data;
+
+  struct Fill {
+    NodePropertyMap* self;
+    const T& value;
+    bool construct;
+    void operator()(unsigned id, unsigned total) {
+      std::pair<iterator,iterator> p = Galois::block_range(self->data.begin(), self->data.end(), id, total);
+      if (construct)
+        std::uninitialized_fill(p.first, p.second, value);
+      else
+        std::fill(p.first, p.second, value);
+    }
+  };
+
+public:
+  NodePropertyMap(): graph(0) { }
+
+  //! Attaches to g with every value initialized to init
+  explicit NodePropertyMap(GraphTy& g, const T& init = T()): graph(0) {
+    attach(g, init);
+  }
+
+  ~NodePropertyMap() {
+    detach();
+  }
+
+  /**
+   * Allocates a value for each node of g, replacing values for any graph
+   * this map was attached to. Values are initialized to init in parallel.
+   */
+  void attach(GraphTy& g, const T& init = T()) {
+    detach();
+    graph = &g;
+    data.allocateInterleaved(g.size());
+    Fill fn = { this, init, true };
+    Galois::on_each(fn);
+  }
+
+  //! Frees the values; the map can then be attached to another graph
+  void detach() {
+    if (!graph)
+      return;
+    data.destroy();
+    data.deallocate();
+    graph = 0;
+  }
+
+  bool isAttached() const { return graph != 0; }
+
+  GraphTy& getGraph() const { return *graph; }
+
+  //! Sets every value to v in parallel
+  void fill(const T& v) {
+    Fill fn = { this, v, false };
+    Galois::on_each(fn);
+  }
+
+  reference operator[](GraphNode n) { return data[graph->idFromNode(n)]; }
+
+  reference getData(GraphNode n) { return data[graph->idFromNode(n)]; }
+
+  //! Value at position id, for algorithms that work with node ids directly
+  reference at(size_t id) { return data[id]; }
+
+  size_t size() const { return data.size(); }
+
+  iterator begin() { return data.begin(); }
+  iterator end() { return data.end(); }
+  const_iterator begin() const { return data.begin(); }
+  const_iterator end() const { return data.end(); }
+};
+
+}
+}
+#endif
@@ -27,6 +27,7 @@
 
 #include "Galois/Galois.h"
 #include "Galois/Graph/Details.h"
+#include "Galois/Graph/CompressedGraphFormat.h"
 
 namespace Galois {
 namespace Graph {
@@ -108,7 +109,77 @@ void readGraphDispatch(GraphTy& graph, read_with_aux_graph_tag, FileGraph& f) {
 }
 
 template<typename GraphTy>
-void readGraphDispatch(GraphTy& graph, read_lc_inout_graph_tag, const std::string& f1, const std::string& f2) { 
+struct ReadGraphConstructSizesFrom {
+  GraphTy& graph;
+  FileGraph& f;
+  ReadGraphConstructSizesFrom(GraphTy& g, FileGraph& _f): graph(g), f(_f) { }
+  void operator()(unsigned tid, unsigned total) {
+    graph.constructSizesFrom(f, tid, total);
+  }
+};
+
+template<typename GraphTy>
+struct ReadGraphConstructFromCompressedFile {
+  GraphTy& graph;
+  const detail::CompressedGraphFile& file;
+  ReadGraphConstructFromCompressedFile(GraphTy& g, const detail::CompressedGraphFile& f): graph(g), file(f) { }
+  void operator()(unsigned tid, unsigned total) {
+    graph.constructFromCompressedFile(file, tid, total);
+  }
+};
+
+template<typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag tag, const std::string& filename) {
+  if (isCompressedGraphFile(filename)) {
+    detail::CompressedGraphFile file;
+    file.structureFromFile(filename);
+    graph.allocateFromCompressedFile(file, filename);
+    Galois::on_each(ReadGraphConstructFromCompressedFile<GraphTy>(graph, file));
+  } else {
+    FileGraph f;
+    f.structureFromFileInterleaved<typename GraphTy::edge_data_type>(filename);
+    readGraphDispatch(graph, tag, f);
+  }
+}
+
+template<typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_compressed_graph_tag, FileGraph& f) {
+  graph.allocateFrom(f);
+
+  Galois::on_each(ReadGraphConstructSizesFrom<GraphTy>(graph, f));
+  graph.allocateEdgesFrom(f);
+  Galois::on_each(ReadGraphConstructFrom<GraphTy>(graph, f));
+}
+
+template<typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_lc_inout_graph_tag, FileGraph& f1, FileGraph& f2) {
+  graph.createAsymmetric();
+
+  typename GraphTy::out_graph_type::read_tag tag1;
+  readGraphDispatch(graph, tag1, f1);
+
+  typename GraphTy::in_graph_type::read_tag tag2;
+  readGraphDispatch(graph.inGraph, tag2, f2);
+}
+
+/**
+ * Reads out-edges from f1 and in-edges from its transpose f2. If f2 is
+ * empty, the in-edges are instead computed in memory by transposing f1 in
+ * parallel; edge data is copied unless the graph has none.
+ */
+template<typename GraphTy>
+void readGraphDispatch(GraphTy& graph, read_lc_inout_graph_tag tag, const std::string& f1, const std::string& f2) { 
+  if (f2.empty()) {
+    typedef typename GraphTy::edge_data_type EdgeTy;
+    if (isCompressedGraphFile(f1))
+      GALOIS_DIE("Transposing compressed graphs is not supported: ", f1);
+    FileGraph out, in;
+    out.structureFromFileInterleaved<EdgeTy>(f1);
+    transpose<EdgeTy>(out, in);
+    readGraphDispatch(graph, tag, out, in);
+    return;
+  }
+
   graph.createAsymmetric();
 
   typename GraphTy::out_graph_type::read_tag tag1;
@@ -3,9 +3,12 @@
 
 #include "Galois/Graph/OCGraph.h"
 #include "Galois/Graph/GraphNodeBag.h"
+#include "Galois/Timer.h"
 
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/utility.hpp>
+#include <pthread.h>
+#include <sstream>
 
 namespace Galois {
 //! Implementation of GraphChi DSL in Galois
@@ -37,36 +40,20 @@ class SparseVertexMap: public DispatchOperator<PassWrappedGraph> {
   Graph& graph;
   WrappedGraph& wrappedGraph;
   VertexOperator op;
-  int& first;
-  segment_type& prev;
   segment_type& cur;
-  segment_type& next;
-  bool updated;
 
 public:
   typedef int tt_does_not_need_push;
   typedef int tt_does_not_need_aborts;
 
-  SparseVertexMap(Graph& g, WrappedGraph& w, VertexOperator op, int& f,
-      segment_type& p, segment_type& c, segment_type& n):
-    graph(g), wrappedGraph(w), op(op), first(f), prev(p), cur(c), next(n), updated(false) { }
+  SparseVertexMap(Graph& g, WrappedGraph& w, VertexOperator op, segment_type& c):
+    graph(g), wrappedGraph(w), op(op), cur(c) { }
 
   void operator()(size_t n, Galois::UserContext<size_t>&) {
     (*this)(n);
   }
 
   void operator()(size_t n) {
-    if (!updated) {
-      if (first == 0 && __sync_bool_compare_and_swap(&first, 0, 1)) {
-        if (prev.loaded()) {
-          graph.unload(prev);
-        }
-        if (next) {
-          graph.load(next);
-        }
-      }
-      updated = true;
-    }
     // Check if range
     if (!cur.containsNode(n)) {
       return;
@@ -78,43 +65,25 @@ public:
 
 template<bool CheckInput,bool PassWrappedGraph,typename Graph,typename WrappedGraph,typename VertexOperator,typename Bag>
 class DenseVertexMap: public DispatchOperator<PassWrappedGraph> {
-  typedef typename Graph::segment_type segment_type;
   typedef typename Graph::GraphNode GNode;
 
   Graph& graph;
   WrappedGraph& wrappedGraph;
   VertexOperator op;
   Bag* bag;
-  int& first;
-  segment_type& prev;
-  segment_type& cur;
-  segment_type& next;
-  bool updated;
 
 public:
   typedef int tt_does_not_need_push;
   typedef int tt_does_not_need_aborts;
 
-  DenseVertexMap(Graph& g, WrappedGraph& w, VertexOperator op, Bag* b, int& f,
-      segment_type& p, segment_type& c, segment_type& n):
-    graph(g), wrappedGraph(w), op(op), bag(b), first(f), prev(p), cur(c), next(n), updated(false) { }
+  DenseVertexMap(Graph& g, WrappedGraph& w, VertexOperator op, Bag* b):
+    graph(g), wrappedGraph(w), op(op), bag(b) { }
 
   void operator()(GNode n, Galois::UserContext<GNode>&) {
     (*this)(n);
   }
 
   void operator()(GNode n) {
-    if (!updated) {
-      if (first == 0 && __sync_bool_compare_and_swap(&first, 0, 1)) {
-        if (prev.loaded()) {
-          graph.unload(prev);
-        }
-        if (next) {
-          graph.load(next);
-        }
-      }
-      updated = true;
-    }
     if (CheckInput && !bag->contains(graph.idFromNode(n)))
       return;
 
@@ -122,6 +91,51 @@ public:
   }
 };
 
+/**
+ * Unloads the previous segment and loads the next one on a dedicated I/O
+ * thread while the current segment is processed, and asks the OS to start
+ * reading the segment after that.
+ */
+template<typename Graph>
+class SegmentLoader: private boost::noncopyable {
+  typedef typename Graph::segment_type segment_type;
+
+  Graph& graph;
+  segment_type& prev;
+  segment_type& next;
+  size_t edges;
+  pthread_t io;
+
+  static void* launch(void* self) {
+    static_cast<SegmentLoader*>(self)->run();
+    return 0;
+  }
+
+  void run() {
+    if (prev.loaded())
+      graph.unload(prev);
+    if (next) {
+      graph.load(next);
+      segment_type after = graph.nextSegment(next, edges);
+      graph.prefetch(after);
+    }
+  }
+
+public:
+  SegmentLoader(Graph& g, segment_type& p, segment_type& n, size_t e):
+    graph(g), prev(p), next(n), edges(e)
+  {
+    if (pthread_create(&io, 0, &launch, this))
+      GALOIS_DIE("failed creating I/O thread");
+  }
+
+  //! Waits for the I/O thread to finish
+  void wait() {
+    if (pthread_join(io, 0))
+      GALOIS_DIE("failed joining I/O thread");
+  }
+};
+
 template<typename Graph,typename Bag>
 struct contains_node {
   Graph* graph;
@@ -181,10 +195,21 @@ bool fitsInMemory(Graph& graph, size_t memoryLimit) {
   return nodeBytes + edgeBytes < bytes;
 }
 
+//! Returns the region name for the next segment round, numbered across all vertexMap calls
+inline std::string nextRoundName() {
+  static unsigned long round = 0;
+  std::ostringstream name;
+  name << "GraphChiRound" << round++;
+  return name.str();
+}
+
 template<bool CheckInput, bool PassWrappedGraph, typename Graph, typename WrappedGraph, typename VertexOperator, typename Bag>
 void vertexMap(Graph& graph, WrappedGraph& wgraph, VertexOperator op, Bag* input, size_t memoryLimit) {
   typedef typename Graph::segment_type segment_type;
   Galois::Statistic rounds("GraphChiRounds");
+  // Kept in microseconds: each call is short, so converting per call would truncate to zero
+  Galois::Statistic ioWaitTime("GraphChiIOWaitTimeUsec");
+  Galois::Statistic computeTime("GraphChiComputeTimeUsec");
   
   size_t edges = computeEdgeLimit(graph, memoryLimit);
   segment_type prev;
@@ -205,29 +230,42 @@ void vertexMap(Graph& graph, WrappedGraph& wgraph, VertexOperator op, Bag* input
 
   while (cur) {
     if (!CheckInput || !useDense || any_in_range(graph, cur, input)) {
+      unsigned long roundIOWait = 0;
+      unsigned long roundCompute = 0;
+      Galois::Timer t;
+      t.start();
       if (!cur.loaded()) {
         graph.load(cur);
       }
+      t.stop();
+      roundIOWait += t.get_usec();
 
       segment_type next = graph.nextSegment(cur, edges);
+      SegmentLoader<Graph> loader(graph, prev, next, edges);
 
-      int first = 0;
       wgraph.setSegment(cur);
 
+      t.start();
       if (useDense) {
-        DenseVertexMap<CheckInput,PassWrappedGraph,Graph,WrappedGraph,VertexOperator,Bag> vop(graph, wgraph, op, input, first, prev, cur, next);
+        DenseVertexMap<CheckInput,PassWrappedGraph,Graph,WrappedGraph,VertexOperator,Bag> vop(graph, wgraph, op, input);
         Galois::for_each(graph.begin(cur), graph.end(cur), vop);
       } else {
-        SparseVertexMap<PassWrappedGraph,Graph,WrappedGraph,VertexOperator> vop(graph, wgraph, op, first, prev, cur, next);
+        SparseVertexMap<PassWrappedGraph,Graph,WrappedGraph,VertexOperator> vop(graph, wgraph, op, cur);
         Galois::for_each_local(*input, vop);
       }
-
-      // XXX Shouldn't be necessary
-      if (prev.loaded()) {
-        abort();
-        graph.unload(prev);
-      }
-      
+      t.stop();
+      roundCompute += t.get_usec();
+
+      t.start();
+      loader.wait();
+      t.stop();
+      roundIOWait += t.get_usec();
+
+      std::string region = nextRoundName();
+      Galois::Runtime::reportStat(region, "GraphChiIOWaitTimeUsec", roundIOWait);
+      Galois::Runtime::reportStat(region, "GraphChiComputeTimeUsec", roundCompute);
+      ioWaitTime += roundIOWait;
+      computeTime += roundCompute;
       rounds += 1;
 
       prev = cur;
@@ -2,6 +2,9 @@
 #define GALOIS_GRAPHLABEXECUTOR_H
 
 #include "Galois/Bag.h"
+#include "Galois/LargeArray.h"
+#include "Galois/Statistic.h"
+#include "Galois/Runtime/ll/SimpleLock.h"
 
 #include <boost/mpl/has_xxx.hpp>
 
@@ -25,15 +28,41 @@ BOOST_MPL_HAS_XXX_TRAIT_DEF(tt_needs_scatter_out_edges)
 template<typename T>
 struct needs_scatter_out_edges: public has_tt_needs_scatter_out_edges<T> {};
 
+BOOST_MPL_HAS_XXX_TRAIT_DEF(tt_has_combine)
+template<typename T>
+struct has_combine: public has_tt_has_combine<T> {};
+
 struct EmptyMessage {
   EmptyMessage& operator+=(const EmptyMessage&) { return *this; }
 };
 
+/**
+ * Merges a message into the message pending for a vertex. Operators that
+ * define tt_has_combine supply a static combine(pending, message) function;
+ * otherwise messages are combined with operator+=.
+ */
+template<typename Operator, bool HasCombine = has_combine<Operator>::value>
+struct Combiner {
+  typedef typename Operator::message_type message_type;
+  static void combine(message_type& pending, const message_type& message) {
+    Operator::combine(pending, message);
+  }
+};
+
+template<typename Operator>
+struct Combiner<Operator,false> {
+  typedef typename Operator::message_type message_type;
+  static void combine(message_type& pending, const message_type& message) {
+    pending += message;
+  }
+};
+
+template<typename,typename> class AsyncEngine;
+
 template<typename Graph, typename Operator> 
 struct Context {
   typedef typename Graph::GraphNode GNode;
   typedef typename Operator::message_type message_type;
-  typedef std::pair<GNode,message_type> WorkItem;
 
 private:
   template<typename,typename> friend class AsyncEngine;
@@ -43,25 +72,26 @@ private:
   typedef std::deque<Message> MyMessages;
   typedef Galois::Runtime::PerPackageStorage<MyMessages> Messages;
 
-  Galois::UserContext<WorkItem>* ctx;
+  Galois::UserContext<GNode>* ctx;
+  AsyncEngine<Graph,Operator>* engine;
   Graph* graph;
   Galois::LargeArray<int>* scoreboard;
   Galois::InsertBag<GNode>* next;
   Messages* messages;
 
-  Context(Galois::UserContext<WorkItem>* c): ctx(c) { }
+  Context(AsyncEngine<Graph,Operator>* e, Galois::UserContext<GNode>* c): ctx(c), engine(e) { }
 
 #if defined(__IBMCPP__) && __IBMCPP__ <= 1210
 public:
 #endif
   Context(Graph* g, Galois::LargeArray<int>* s, Galois::InsertBag<GNode>* n, Messages* m):
-    graph(g), scoreboard(s), next(n), messages(m) { }
+    ctx(0), graph(g), scoreboard(s), next(n), messages(m) { }
 
 public:
 
   void push(GNode node, const message_type& message) {
     if (ctx) {
-      ctx->push(WorkItem(node, message));
+      engine->send(*ctx, node, message);
     } else {
       size_t id = graph->idFromNode(node);
       { 
@@ -87,6 +117,16 @@ public:
   }
 };
 
+/**
+ * Executes vertex programs asynchronously. Messages sent to a vertex that is
+ * already scheduled are combined into its pending message rather than
+ * scheduling the vertex again, so each vertex is on the worklist at most once
+ * while it has a pending message.
+ *
+ * Messages posted by an iteration are not retracted if it later aborts, so
+ * operators should access the graph with {@link MethodFlag::NONE}; the
+ * engine acquires the neighborhood of a vertex before running it.
+ */
 template<typename Graph, typename Operator>
 class AsyncEngine {
   typedef typename Operator::message_type message_type;
@@ -95,16 +135,24 @@ class AsyncEngine {
   typedef typename Graph::in_edge_iterator in_edge_iterator;
   typedef typename Graph::edge_iterator edge_iterator;
 
-  typedef typename Context<Graph,Operator>::WorkItem WorkItem;
+  template<typename,typename> friend struct Context;
+
+  struct PendingMessage {
+    Galois::Runtime::LL::SimpleLock<true> lock;
+    bool pending;
+    message_type message;
+    PendingMessage(): pending(false) { }
+  };
 
   struct Initialize {
     AsyncEngine* self;
-    Galois::InsertBag<WorkItem>& bag;
+    Galois::InsertBag<GNode>& bag;
 
-    Initialize(AsyncEngine* s, Galois::InsertBag<WorkItem>& b): self(s), bag(b) { }
+    Initialize(AsyncEngine* s, Galois::InsertBag<GNode>& b): self(s), bag(b) { }
 
     void operator()(GNode n) {
-      bag.push(WorkItem(n, message_type()));
+      self->post(n, message_type());
+      bag.push(n);
     }
   };
 
@@ -112,12 +160,9 @@ class AsyncEngine {
     AsyncEngine* self;
     Process(AsyncEngine* s): self(s) { }
 
-    void operator()(const WorkItem& item, Galois::UserContext<WorkItem>& ctx) {
+    void operator()(GNode node, Galois::UserContext<GNode>& ctx) {
       Operator op(self->origOp);
 
-      GNode node = item.first;
-      message_type msg = item.second;
-      
       if (needs_gather_in_edges<Operator>::value || needs_scatter_in_edges<Operator>::value) {
         self->graph.in_edge_begin(node, Galois::MethodFlag::ALL);
       }
@@ -126,6 +171,13 @@ class AsyncEngine {
         self->graph.edge_begin(node, Galois::MethodFlag::ALL);
       }
 
+      // Take the message only after the neighborhood is acquired so that an
+      // abort does not lose it
+      message_type msg;
+      if (!self->take(node, msg))
+        return;
+      *self->delivered += 1;
+
       op.init(self->graph, node, msg);
       
       gather_type sum;
@@ -147,7 +199,7 @@ class AsyncEngine {
       if (!op.needsScatter(self->graph, node))
         return;
 
-      Context<Graph,Operator> context(&ctx);
+      Context<Graph,Operator> context(self, &ctx);
 
       if (needs_scatter_in_edges<Operator>::value) {
         for (in_edge_iterator ii = self->graph.in_edge_begin(node, Galois::MethodFlag::NONE),
@@ -166,17 +218,71 @@ class AsyncEngine {
 
   Graph& graph;
   Operator origOp;
+  Galois::LargeArray<PendingMessage> pending;
+  Galois::Statistic* combined;
+  Galois::Statistic* delivered;
+
+  //! Merges message into the pending message of node; returns true if node
+  //! had no pending message and needs to be scheduled
+  bool post(GNode node, const message_type& message) {
+    PendingMessage& p = pending[graph.idFromNode(node)];
+    p.lock.lock();
+    bool wasPending = p.pending;
+    if (wasPending) {
+      Combiner<Operator>::combine(p.message, message);
+    } else {
+      p.message = message;
+      p.pending = true;
+    }
+    p.lock.unlock();
+    return !wasPending;
+  }
+
+  //! Removes the pending message of node; returns false if there is none
+  bool take(GNode node, message_type& message) {
+    PendingMessage& p = pending[graph.idFromNode(node)];
+    p.lock.lock();
+    bool wasPending = p.pending;
+    if (wasPending) {
+      message = p.message;
+      p.message = message_type();
+      p.pending = false;
+    }
+    p.lock.unlock();
+    return wasPending;
+  }
+
+  void send(Galois::UserContext<GNode>& ctx, GNode node, const message_type& message) {
+    if (post(node, message))
+      ctx.push(node);
+    else
+      *combined += 1;
+  }
 
 public:
-  AsyncEngine(Graph& g, Operator o): graph(g), origOp(o) { }
+  AsyncEngine(Graph& g, Operator o): graph(g), origOp(o), combined(0), delivered(0) {
+    pending.create(graph.size());
+  }
+
+  //! Sends an initial message to node, combined with the default message
+  //! every vertex receives
+  void signal(GNode node, const message_type& msg) {
+    post(node, msg);
+  }
 
   void execute() {
-    typedef typename Context<Graph,Operator>::WorkItem WorkItem;
     typedef Galois::WorkList::dChunkedFIFO<256> WL;
 
-    Galois::InsertBag<WorkItem> bag;
+    Galois::Statistic combinedStat("GraphLabMessagesCombined");
+    Galois::Statistic deliveredStat("GraphLabMessagesDelivered");
+    combined = &combinedStat;
+    delivered = &deliveredStat;
+
+    Galois::InsertBag<GNode> bag;
     Galois::do_all_local(graph, Initialize(this, bag));
     Galois::for_each_local(bag, Process(this), Galois::wl<WL>());
+
+    combined = delivered = 0;
   }
 };
 
@@ -2,11 +2,39 @@
 #define GALOIS_LIGRAEXECUTOR_H
 
 #include "Galois/Galois.h"
+#include "Galois/Accumulator.h"
+#include "Galois/NoDerefIterator.h"
+#include "Galois/Runtime/Support.h"
+
+#include <iostream>
 
 namespace Galois {
 //! Implementation of Ligra DSL in Galois
 namespace Ligra {
 
+/**
+ * Thresholds that decide between sparse (push from the frontier) and dense
+ * (visit every node) rounds of {@link edgeMap}, following the
+ * direction-optimizing BFS of Beamer et al. A sparse round is followed by a
+ * dense one when the frontier nodes plus their out-edges exceed |E| / alpha;
+ * a dense round is followed by a sparse one when the frontier has fewer than
+ * |V| / beta nodes.
+ */
+struct EdgeMapConfig {
+  unsigned alpha;
+  unsigned beta;
+  //! Print the mode, frontier size and edges inspected of every round
+  bool verbose;
+
+  EdgeMapConfig(): alpha(20), beta(24), verbose(false) { }
+};
+
+//! Returns the configuration used by all subsequent calls to edgeMap
+inline EdgeMapConfig& getEdgeMapConfig() {
+  static EdgeMapConfig config;
+  return config;
+}
+
 namespace hidden {
 template<typename Graph,bool Forward>
 struct Transposer {
@@ -88,6 +116,46 @@ struct Transposer<Graph,false> {
   }
 };
 
+enum EdgeMapMode {
+  SPARSE,
+  DENSE,
+  DENSE_FORWARD
+};
+
+/**
+ * Chooses the mode of an edgeMap round. A dense input means the previous
+ * round was dense as well, in which case the round stays dense until the
+ * frontier shrinks below |V| / beta.
+ */
+template<typename Graph,typename Bag>
+EdgeMapMode chooseMode(Graph& graph, Bag& input, bool denseForward) {
+  EdgeMapConfig& config = getEdgeMapConfig();
+  bool dense;
+  if (input.isDense())
+    dense = input.getSize() >= graph.size() / std::max(config.beta, 1U);
+  else
+    dense = input.getCount() > graph.sizeEdges() / std::max(config.alpha, 1U);
+
+  if (!dense)
+    return SPARSE;
+  return denseForward ? DENSE_FORWARD : DENSE;
+}
+
+//! Reports statistics about a round of edgeMap
+inline void reportRound(EdgeMapMode mode, size_t nodes, size_t inspected) {
+  static const char* names[] = { "sparse", "dense", "dense-forward" };
+  static const char* rounds[] = { "LigraSparseRounds", "LigraDenseRounds", "LigraDenseForwardRounds" };
+
+  Galois::Runtime::reportStat(0, rounds[mode], 1);
+  Galois::Runtime::reportStat(0, "LigraFrontierNodes", nodes);
+  Galois::Runtime::reportStat(0, "LigraEdgesInspected", inspected);
+
+  if (getEdgeMapConfig().verbose) {
+    std::cout << "edgeMap " << names[mode] << " frontier: " << nodes
+      << " edges inspected: " << inspected << "\n";
+  }
+}
+
 template<typename Graph,typename Bag,typename EdgeOperator,bool Forward>
 struct DenseOperator: public Transposer<Graph,Forward> {
   typedef Transposer<Graph,Forward> Super;
@@ -102,9 +170,11 @@ struct DenseOperator: public Transposer<Graph,Forward> {
   Bag& input;
   Bag& output;
   EdgeOperator op;
+  //! Number of in-edges looked at before cond became false
+  Galois::GAccumulator<size_t>& inspected;
   
-  DenseOperator(Graph& g, Bag& i, Bag& o, EdgeOperator op): 
-    graph(g), input(i), output(o), op(op) { }
+  DenseOperator(Graph& g, Bag& i, Bag& o, EdgeOperator op, Galois::GAccumulator<size_t>& in): 
+    graph(g), input(i), output(o), op(op), inspected(in) { }
 
   void operator()(GNode n, Galois::UserContext<GNode>&) {
     (*this)(n);
@@ -114,15 +184,18 @@ struct DenseOperator: public Transposer<Graph,Forward> {
     if (!op.cond(graph, n))
       return;
 
+    size_t count = 0;
     for (in_edge_iterator ii = this->in_edge_begin(graph, n), ei = this->in_edge_end(graph, n); ii != ei; ++ii) {
       GNode src = this->getInEdgeDst(graph, ii);
+      ++count;
         
       if (input.contains(graph.idFromNode(src)) && op(graph, src, n, this->getInEdgeData(graph, ii))) {
-        output.push(graph.idFromNode(n), std::distance(this->edge_begin(graph, n), this->edge_end(graph, n)));
+        output.pushBit(graph.idFromNode(n), std::distance(this->edge_begin(graph, n), this->edge_end(graph, n)));
       }
       if (!op.cond(graph, n))
-        return;
+        break;
     }
+    inspected += count;
   }
 };
 
@@ -149,19 +222,53 @@ struct DenseForwardOperator: public Transposer<Graph,Forward> {
   }
 
   void operator()(GNode n) {
+    (*this)(n, this->edge_begin(graph, n), this->edge_end(graph, n));
+  }
+
+  //! Process part of the edges of n; used with Galois::do_all_edges
+  void operator()(GNode n, edge_iterator ii, edge_iterator ei) {
     if (!IgnoreInput && !input.contains(graph.idFromNode(n)))
       return;
 
-    for (edge_iterator ii = this->edge_begin(graph, n), ei = this->edge_end(graph, n); ii != ei; ++ii) {
+    for (; ii != ei; ++ii) {
       GNode dst = this->getEdgeDst(graph, ii);
         
-      if (op.cond(graph, n) && op(graph, n, dst, this->getEdgeData(graph, ii))) {
-        output.pushDense(graph.idFromNode(dst), std::distance(this->edge_begin(graph, dst), this->edge_end(graph, dst)));
+      if (op.cond(graph, dst) && op(graph, n, dst, this->getEdgeData(graph, ii))) {
+        output.pushBit(graph.idFromNode(dst), std::distance(this->edge_begin(graph, dst), this->edge_end(graph, dst)));
       }
     }
   }
 };
 
+//! Out-degree above which the sparse operator expands a node in parallel
+static const ptrdiff_t nestedDegree = 1024;
+//! Chunk size of the worklist of sparse rounds
+static const int sparseChunkSize = 64;
+//! Chunk size of the worklist of rounds over all nodes
+static const int denseChunkSize = 256;
+
+/**
+ * Dense push over all nodes, or over the nodes of input unless IgnoreInput.
+ * Out-edges are contiguous, so work is divided by edges and the edges of
+ * high-degree nodes are shared among threads.
+ */
+template<bool Forward>
+struct DenseForwardAll {
+  template<bool IgnoreInput,typename Graph,typename EdgeOperator,typename Bag>
+  static void go(Graph& graph, EdgeOperator op, Bag& input, Bag& output) {
+    Galois::do_all_edges(graph, DenseForwardOperator<Graph,Bag,EdgeOperator,Forward,IgnoreInput>(graph, input, output, op));
+  }
+};
+
+template<>
+struct DenseForwardAll<false> {
+  template<bool IgnoreInput,typename Graph,typename EdgeOperator,typename Bag>
+  static void go(Graph& graph, EdgeOperator op, Bag& input, Bag& output) {
+    typedef Galois::WorkList::dChunkedFIFO<denseChunkSize> WL;
+    Galois::for_each_local(graph, DenseForwardOperator<Graph,Bag,EdgeOperator,false,IgnoreInput>(graph, input, output, op), Galois::wl<WL>());
+  }
+};
+
 template<typename Graph,typename Bag,typename EdgeOperator,bool Forward>
 struct SparseOperator: public Transposer<Graph,Forward> { 
   typedef Transposer<Graph,Forward> Super;
@@ -186,8 +293,16 @@ struct SparseOperator: public Transposer<Graph,Forward> {
 
   void operator()(size_t id) {
     GNode n = graph.nodeFromId(id);
+    edge_iterator ii = this->edge_begin(graph, n), ei = this->edge_end(graph, n);
 
-    for (edge_iterator ii = this->edge_begin(graph, n), ei = this->edge_end(graph, n); ii != ei; ++ii) {
+    if (std::distance(ii, ei) > nestedDegree) {
+      // Expand high-degree nodes with the help of idle threads
+      Galois::do_all(Galois::make_no_deref_iterator(ii), Galois::make_no_deref_iterator(ei),
+          SparseOperator(graph, output, op, n), Galois::do_all_nested(true));
+      return;
+    }
+
+    for (; ii != ei; ++ii) {
       GNode dst = this->getEdgeDst(graph, ii);
 
       if (op.cond(graph, dst) && op(graph, n, dst, this->getEdgeData(graph, ii))) {
@@ -213,7 +328,8 @@ struct SparseOperator: public Transposer<Graph,Forward> {
 template<bool Forward,typename Graph,typename EdgeOperator,typename Bag>
 void edgeMap(Graph& graph, EdgeOperator op, Bag& output) {
   output.densify();
-  Galois::for_each_local(graph, hidden::DenseForwardOperator<Graph,Bag,EdgeOperator,Forward,true>(graph, output, output, op));
+  hidden::DenseForwardAll<Forward>::template go<true>(graph, op, output, output);
+  output.sparsify();
 }
 
 template<bool Forward,typename Graph,typename EdgeOperator,typename Bag>
@@ -229,28 +345,43 @@ void edgeMap(Graph& graph, EdgeOperator op, typename Graph::GraphNode single, Ba
   }
 }
 
+/**
+ * Applies op to the edges leaving the nodes of input and adds the
+ * destinations for which op returns true to output. Each round is either
+ * sparse, pushing from the nodes of input, or dense, visiting every node; see
+ * {@link EdgeMapConfig}. Dense rounds pull along in-edges unless
+ * denseForward, in which case they push along the out-edges of the nodes of
+ * input.
+ */
 template<bool Forward,typename Graph,typename EdgeOperator,typename Bag>
 void edgeMap(Graph& graph, EdgeOperator op, Bag& input, Bag& output, bool denseForward) {
   using namespace Galois::WorkList;
   size_t count = input.getCount();
+  size_t nodes = input.getSize();
+  // Edges of the frontier; an upper bound on what a dense pull inspects
+  size_t inspected = count - nodes;
+  hidden::EdgeMapMode mode = hidden::chooseMode(graph, input, denseForward);
 
-  if (!denseForward && count > graph.sizeEdges() / 20) {
-    //std::cout << "(D) Count " << count << "\n"; // XXX
+  if (mode == hidden::SPARSE) {
+    typedef dChunkedFIFO<hidden::sparseChunkSize> WL;
+    Galois::for_each_local(input, hidden::SparseOperator<Graph,Bag,EdgeOperator,Forward>(graph, output, op), Galois::wl<WL>());
+  } else {
+    // Mark the output in the bitset only and build its sparse form once,
+    // in node order, after the round
     input.densify();
-    if (denseForward) {
-      abort(); // Never executed
-      output.densify();
-      typedef dChunkedFIFO<256*4> WL;
-      Galois::for_each_local(graph, hidden::DenseForwardOperator<Graph,Bag,EdgeOperator,Forward,false>(graph, input, output, op), Galois::wl<WL>());
+    output.densify();
+    if (mode == hidden::DENSE_FORWARD) {
+      hidden::DenseForwardAll<Forward>::template go<false>(graph, op, input, output);
     } else {
-      typedef dChunkedFIFO<256> WL;
-      Galois::for_each_local(graph, hidden::DenseOperator<Graph,Bag,EdgeOperator,Forward>(graph, input, output, op), Galois::wl<WL>());
+      typedef dChunkedFIFO<hidden::denseChunkSize> WL;
+      Galois::GAccumulator<size_t> pulled;
+      Galois::for_each_local(graph, hidden::DenseOperator<Graph,Bag,EdgeOperator,Forward>(graph, input, output, op, pulled), Galois::wl<WL>());
+      inspected = pulled.reduce();
     }
-  } else {
-    //std::cout << "(S) Count " << count << "\n"; // XXX
-    typedef dChunkedFIFO<64> WL;
-    Galois::for_each_local(input, hidden::SparseOperator<Graph,Bag,EdgeOperator,Forward>(graph, output, op), Galois::wl<WL>());
+    output.sparsify();
   }
+
+  hidden::reportRound(mode, nodes, inspected);
 }
 
 template<typename... Args>
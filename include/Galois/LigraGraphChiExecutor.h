@@ -18,6 +18,7 @@ void edgeMap(size_t size, Graph& graph, EdgeOperator op, Bag& output) {
       Galois::Ligra::hidden::DenseForwardOperator<WrappedGraph,Bag,EdgeOperator,Forward,true>(wgraph, output, output, op),
       static_cast<Bag*>(0),
       size);
+  output.sparsify();
 }
 
 template<bool Forward,typename Graph, typename EdgeOperator,typename Bag>
@@ -25,29 +26,37 @@ void edgeMap(size_t size, Graph& graph, EdgeOperator op, Bag& input, Bag& output
   typedef Galois::Graph::BindSegmentGraph<Graph> WrappedGraph;
   WrappedGraph wgraph(graph);
 
+  namespace hidden = Galois::Ligra::hidden;
   size_t count = input.getCount();
+  size_t nodes = input.getSize();
+  size_t inspected = count - nodes;
+  hidden::EdgeMapMode mode = hidden::chooseMode(graph, input, denseForward);
 
-  if (!denseForward && count > graph.sizeEdges() / 20) {
+  if (mode == hidden::SPARSE) {
+    Galois::GraphChi::hidden::vertexMap<true,false>(graph, wgraph,
+      hidden::SparseOperator<WrappedGraph,Bag,EdgeOperator,Forward>(wgraph, output, op),
+      &input,
+      size);
+  } else {
     input.densify();
-    if (denseForward) {
-      abort(); // Never used now
-      output.densify();
+    output.densify();
+    if (mode == hidden::DENSE_FORWARD) {
       Galois::GraphChi::hidden::vertexMap<false,false>(graph, wgraph,
-        Galois::Ligra::hidden::DenseForwardOperator<WrappedGraph,Bag,EdgeOperator,Forward,false>(wgraph, input, output, op),
+        hidden::DenseForwardOperator<WrappedGraph,Bag,EdgeOperator,Forward,false>(wgraph, input, output, op),
         static_cast<Bag*>(0),
         size);
     } else {
+      Galois::GAccumulator<size_t> pulled;
       Galois::GraphChi::hidden::vertexMap<false,false>(graph, wgraph,
-        Galois::Ligra::hidden::DenseOperator<WrappedGraph,Bag,EdgeOperator,Forward>(wgraph, input, output, op),
+        hidden::DenseOperator<WrappedGraph,Bag,EdgeOperator,Forward>(wgraph, input, output, op, pulled),
         static_cast<Bag*>(0),
         size);
+      inspected = pulled.reduce();
     }
-  } else {
-    Galois::GraphChi::hidden::vertexMap<true,false>(graph, wgraph,
-      Galois::Ligra::hidden::SparseOperator<WrappedGraph,Bag,EdgeOperator,Forward>(wgraph, output, op),
-      &input,
-      size);
+    output.sparsify();
   }
+
+  hidden::reportRound(mode, nodes, inspected);
 }
 
 template<bool Forward,typename Graph, typename EdgeOperator,typename Bag>
@@ -125,6 +125,9 @@ public:
   
   unsigned cancelIteration() { return 0; }
   unsigned commitIteration() { return 0; }
+
+  void setCooperativeAborts(bool) { }
+  bool isConflicted() const { return false; }
 };
 #elif defined(GALOIS_USE_TINYSTM) || defined(GALOIS_USE_XTM)
 class SimpleRuntimeContext;
@@ -165,6 +168,9 @@ public:
   }
   virtual ~SimpleRuntimeContext() { }
   void startIteration() { }
+
+  void setCooperativeAborts(bool) { }
+  bool isConflicted() const { return false; }
   
   unsigned cancelIteration() { return commitIteration(); }
   unsigned commitIteration() { 
@@ -257,6 +263,9 @@ class SimpleRuntimeContext: public LockManagerBase {
   //! The locks we hold
   Lockable* locks;
   bool customAcquire;
+  //! Record conflicts in conflicted instead of signaling them
+  bool cooperative;
+  bool conflicted;
 
 protected:
   friend void doAcquire(Lockable*);
@@ -278,12 +287,24 @@ protected:
   void release(Lockable* lockable);
 
 public:
-  SimpleRuntimeContext(bool child = false): locks(0), customAcquire(child) { }
+  SimpleRuntimeContext(bool child = false): locks(0), customAcquire(child), cooperative(false), conflicted(false) { }
   virtual ~SimpleRuntimeContext() { }
 
   void startIteration() {
     assert(!locks);
+    conflicted = false;
   }
+
+  /**
+   * When enabled, a failed acquire marks the current iteration as conflicted
+   * and returns normally instead of calling {@link signalConflict}. The
+   * executor checks {@link isConflicted()} after the operator returns and
+   * aborts the iteration without unwinding the stack.
+   */
+  void setCooperativeAborts(bool v) { cooperative = v; }
+
+  //! Has a failed acquire been recorded during the current iteration
+  bool isConflicted() const { return conflicted; }
   
   unsigned cancelIteration();
   unsigned commitIteration();
@@ -334,6 +355,12 @@ inline void acquire(Lockable* lockable, Galois::MethodFlag m) {
   }
 }
 
+//! Has the current iteration recorded a conflict instead of signaling it
+inline bool isConflicted() {
+  SimpleRuntimeContext* ctx = getThreadContext();
+  return ctx && ctx->isConflicted();
+}
+
 struct AlwaysLockObj {
   void operator()(Lockable* lockable) const {
     doAcquire(lockable);
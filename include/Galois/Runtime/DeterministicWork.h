@@ -374,6 +374,8 @@ class DMergeLocal: private boost::noncopyable {
   size_t committed;
   size_t iterations;
   size_t aborted;
+  //! Consecutive rounds that executed items but committed none of them
+  size_t stalled;
 public:
   NewItemsTy newItems;
 private:
@@ -383,6 +385,8 @@ private:
   PQ newReserve;
   Galois::optional<T> mostElement;
   Galois::optional<T> windowElement;
+  //! Greatest item scheduled when running without a window
+  Galois::optional<T> lastElement;
 
   // For id based execution
   size_t minId;
@@ -392,7 +396,7 @@ private:
   size_t size;
 
 public:
-  DMergeLocal(): alloc(&heap), newItems(alloc), newReserve(alloc) { 
+  DMergeLocal(): alloc(&heap), stalled(0), newItems(alloc), newReserve(alloc) { 
     resetStats(); 
   }
 
@@ -402,7 +406,7 @@ private:
   void initialLimits(BiIteratorTy ii, BiIteratorTy ei) {
     minId = std::numeric_limits<size_t>::max();
     maxId = std::numeric_limits<size_t>::min();
-    mostElement = windowElement = Galois::optional<T>();
+    mostElement = windowElement = lastElement = Galois::optional<T>();
 
     if (ii != ei) {
       if (ii + 1 == ei) {
@@ -626,6 +630,8 @@ public:
 
   void resetStats() { committed = iterations = aborted = 0; }
 
+  size_t stalledRounds() const { return stalled; }
+
   bool emptyReserve() { return reserve.empty() && newReserve.empty(); }
 };
 
@@ -722,6 +728,9 @@ public:
     }
 
     float commitRatio = alliterations > 0 ? allcommitted / (float) alliterations : 0.0;
+    if (inner)
+      mlocal.stalled = alliterations > 0 && allcommitted == 0 ? mlocal.stalled + 1 : 0;
+
     if (OptionsTy::hasFixedWindow) {
       if (!inner || allcommitted == alliterations) {
         mlocal.delta = MergeTraits<OptionsTy>::MinDelta;
@@ -1064,8 +1073,14 @@ public:
     MergeLocal& mlocal = *this->data.getLocal();
 
     // NB: Tricky conditions. If we can not definitively place an item, it must
-    // go into the current wl.
-    if (mlocal.mostElement && !comp(val, *mlocal.mostElement)) {
+    // go into the current wl. Without a window, only items less than every
+    // scheduled item can join the current wl; the rest wait to be windowed
+    // with the other new items, so they do not run ahead of lesser items
+    // created later.
+    if (!mlocal.mostElement && mlocal.lastElement && !comp(val, *mlocal.lastElement)) {
+      this->new_.push(NewItem(val, MergeTraits<OptionsTy>::id(fn1, val), 1));
+      hasNewWork = true;
+    } else if (mlocal.mostElement && !comp(val, *mlocal.mostElement)) {
       this->new_.push(NewItem(val, MergeTraits<OptionsTy>::id(fn1, val), 1));
       hasNewWork = true;
     } else if (mlocal.mostElement && mlocal.windowElement && !comp(val, *mlocal.windowElement)) {
@@ -1126,10 +1141,10 @@ public:
       // The most and window elements are exclusive of the range that they
       // define; there is no most or window element that includes X. The
       // easiest solution is to not use most or window elements for the next
-      // round, but the downside is that we will never return to windowed execution.
-
-      // TODO: improve this
+      // round. New items not less than X are held back until the next call,
+      // which windows them again.
       if (mlocal.windowElement && mlocal.mostElement && !comp(*mlocal.windowElement, *mlocal.mostElement)) {
+        mlocal.lastElement = mlocal.mostElement;
         mlocal.windowElement = mlocal.mostElement = Galois::optional<T>();
         for (; ii != ei; ++ii) {
           wl->push(Item(ii->val, 0));
@@ -1213,6 +1228,8 @@ class Executor {
   typedef WorkList::dChunkedFIFO<MergeTraits<OptionsTy>::ChunkSize,DetContext> PendingWork;
   typedef WorkList::ChunkedFIFO<MergeTraits<OptionsTy>::ChunkSize,DetContext,false> LocalPendingWork;
   static const bool useLocalState = has_deterministic_local_state<typename OptionsTy::Function1Ty>::value;
+  //! Rounds without any commit tolerated before an ordered loop gives up
+  static const size_t MaxStalledRounds = 16;
 
   // Truly thread-local
   struct ThreadLocalData: private boost::noncopyable {
@@ -1305,6 +1322,14 @@ void Executor<OptionsTy>::go() {
         break;
 
       mergeManager.calculateWindow(true);
+      // In ordered execution, the least pending item is always in the round,
+      // wins every conflict and ignores acquires while committing. The only
+      // way it fails to commit is an explicit abort by the operator, e.g., a
+      // stability test that rejects it. That abort repeats every round, so
+      // stop instead of retrying forever.
+      if (OptionsTy::useOrdered && mlocal.stalledRounds() >= MaxStalledRounds)
+        GALOIS_DIE("ordered loop aborted every item for ", MaxStalledRounds,
+            " rounds; the stability test must accept the least pending item");
       mergeManager.prepareNextWindow(tld.wlnext);
 
       barrier.wait();
@@ -1528,13 +1553,17 @@ static inline void for_each_det_impl(const RangeTy& range, WorkTy& W) {
 }
 
 
-#if 0
 /**
- * TODO(ddn): This executor only properly works for ordered algorithms that do
- * not create new work; otherwise, the behavior is deterministic (and clients
- * have some control over the order enforced via comp), but this executor does
- * not guarantee that a newly added activity, A, will execute before a
- * previously created activity, B, even if A < B.
+ * Two-phase ordered executor. Each round executes a window of the least
+ * pending items: the first phase runs the neighborhood function to acquire
+ * locks, with conflicts resolved in favor of the lesser item according to
+ * comp, and the second phase runs the operator on the items that still own
+ * their neighborhoods. Losers are retried in the next round.
+ *
+ * A new item joins the next round only if it compares less than the bound
+ * of the current window, so no greater pending item runs ahead of it;
+ * otherwise it is merged with the pending items outside the window and is
+ * scheduled in comp order with them.
  */
 template<typename IterTy, typename ComparatorTy, typename NhFunc, typename OpFunc>
 static inline void for_each_ordered_2p(IterTy b, IterTy e, ComparatorTy comp, NhFunc f1, OpFunc f2, const char* loopname) {
@@ -1547,7 +1576,6 @@ static inline void for_each_ordered_2p(IterTy b, IterTy e, ComparatorTy comp, Nh
   WorkTy W(options, loopname);
   for_each_det_impl(makeStandardRange(b,e), W);
 }
-#endif
 
 } // end namespace Runtime
 } // end namespace Galois
@@ -32,8 +32,11 @@
 #include "Galois/Statistic.h"
 #include "Galois/Runtime/Barrier.h"
 #include "Galois/Runtime/Support.h"
+#include "Galois/Runtime/Nested.h"
 #include "Galois/Runtime/Range.h"
+#include "Galois/Runtime/ReduceTree.h"
 #include "Galois/Runtime/ForEachTraits.h"
+#include "Galois/Runtime/ll/CompilerSpecific.h"
 
 #include <algorithm>
 
@@ -50,7 +53,6 @@ struct EmptyFn {
 template<class FunctionTy, class ReduceFunTy, class RangeTy>
 class DoAllWork {
   typedef typename RangeTy::local_iterator local_iterator;
-  LL::SimpleLock<true> reduceLock;
   FunctionTy origF;
   FunctionTy outputF;
   ReduceFunTy RF;
@@ -58,6 +60,8 @@ class DoAllWork {
   Barrier& barrier;
   bool needsReduce;
   bool useStealing;
+  //! Threads still working on their range, i.e., that may spawn nested tasks
+  std::atomic<unsigned> running;
 
   struct SharedState {
     local_iterator stealBegin;
@@ -73,6 +77,7 @@ class DoAllWork {
   };
 
   PerThreadStorage<SharedState> TLDS;
+  TreeCombiner<FunctionTy> combiner;
 
   //! Master execution function for this loop type
   void processRange(PrivateState& tld) {
@@ -119,17 +124,16 @@ class DoAllWork {
     return false;
   }
 
+  //! Combines thread functors along a package-aware tree; thread 0 folds
+  //! the result into outputF
   void doReduce(PrivateState& mytld) {
-    if (needsReduce) {
-      reduceLock.lock();
+    if (needsReduce && combiner.combine(mytld.F, RF, activeThreads))
       RF(outputF, mytld.F);
-      reduceLock.unlock();
-    }
   }
 
 public:
   DoAllWork(const FunctionTy& F, const ReduceFunTy& R, bool needsReduce, RangeTy r, bool steal)
-    : origF(F), outputF(F), RF(R), range(r), barrier(getSystemBarrier()), needsReduce(needsReduce), useStealing(steal)
+    : origF(F), outputF(F), RF(R), range(r), barrier(getSystemBarrier()), needsReduce(needsReduce), useStealing(steal), running(activeThreads)
   { }
 
   void operator()() {
@@ -150,6 +154,13 @@ public:
       processRange(thisTLD);
     } while (useStealing && trySteal(thisTLD));
 
+    // Help with loops nested in iterations of threads that are still busy
+    running.fetch_sub(1, std::memory_order_release);
+    while (running.load(std::memory_order_acquire)) {
+      if (!helpNested())
+        LL::asmPause();
+    }
+
     doReduce(thisTLD);
   }
 
@@ -157,8 +168,14 @@ public:
 };
 
 template<typename RangeTy, typename FunctionTy, typename ReducerTy>
-FunctionTy do_all_dispatch(RangeTy range, FunctionTy f, ReducerTy r, bool doReduce, const char* loopname, bool steal) {
+FunctionTy do_all_dispatch(RangeTy range, FunctionTy f, ReducerTy r, bool doReduce, const char* loopname, bool steal, bool nested) {
   if (Galois::Runtime::inGaloisForEach) {
+    if (nested && activeThreads > 1) {
+      FunctionTy result(f);
+      NestedDoAll<typename RangeTy::iterator, FunctionTy, ReducerTy> task(range.begin(), range.end(), f, result, r, doReduce);
+      runNested(task);
+      return result;
+    }
     return std::for_each(range.begin(), range.end(), f);
   } else {
 
@@ -180,13 +197,13 @@ FunctionTy do_all_dispatch(RangeTy range, FunctionTy f, ReducerTy r, bool doRedu
 }
 
 template<typename RangeTy, typename FunctionTy>
-FunctionTy do_all_impl(RangeTy range, FunctionTy f, const char* loopname = 0, bool steal = false) {
-  return do_all_dispatch(range, f, EmptyFn(), false, loopname, steal);
+FunctionTy do_all_impl(RangeTy range, FunctionTy f, const char* loopname = 0, bool steal = false, bool nested = false) {
+  return do_all_dispatch(range, f, EmptyFn(), false, loopname, steal, nested);
 }
 
 template<typename RangeTy, typename FunctionTy, typename ReduceTy>
-FunctionTy do_all_impl(RangeTy range, FunctionTy f, ReduceTy r, const char* loopname = 0, bool steal = false) {
-  return do_all_dispatch(range, f, r, true, loopname, steal);
+FunctionTy do_all_impl(RangeTy range, FunctionTy f, ReduceTy r, const char* loopname = 0, bool steal = false, bool nested = false) {
+  return do_all_dispatch(range, f, r, true, loopname, steal, nested);
 }
 
 } // end namespace Runtime
@@ -40,7 +40,9 @@ struct ForEachTraits {
     NeedsBreak = Galois::needs_parallel_break<FunctionTy>::value,
     NeedsPush = !Galois::does_not_need_push<FunctionTy>::value,
     NeedsPIA = Galois::needs_per_iter_alloc<FunctionTy>::value,
-    NeedsAborts = !Galois::does_not_need_aborts<FunctionTy>::value
+    NeedsAborts = !Galois::does_not_need_aborts<FunctionTy>::value,
+    NeedsCooperativeAborts = !Galois::does_not_need_aborts<FunctionTy>::value
+      && Galois::needs_cooperative_aborts<FunctionTy>::value
   };
 };
 
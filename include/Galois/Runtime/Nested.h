@@ -0,0 +1,175 @@
+/** Nested parallel loops -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Fork-join tasks spawned from inside an iteration of a parallel loop. The
+ * spawning thread publishes the task and works on it; threads of the
+ * enclosing loop that run out of work pick up chunks of the task until it is
+ * exhausted. Nested do_all loops split their range into chunks; nested
+ * for_each loops share a worklist that their pushes also go to.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_RUNTIME_NESTED_H
+#define GALOIS_RUNTIME_NESTED_H
+
+#include "Galois/config.h"
+#include "Galois/Runtime/ActiveThreads.h"
+#include "Galois/Runtime/UserContextAccess.h"
+#include "Galois/Runtime/ll/CompilerSpecific.h"
+#include "Galois/Runtime/ll/SimpleLock.h"
+#include "Galois/WorkList/GFifo.h"
+
+#include <algorithm>
+#include <iterator>
+#include GALOIS_CXX11_STD_HEADER(atomic)
+
+namespace Galois {
+namespace Runtime {
+
+/**
+ * Work spawned by an iteration of a parallel loop. {@link run} is called
+ * concurrently by the spawning thread and by any helping threads, and
+ * returns when no unclaimed work is left.
+ */
+struct NestedTask {
+  //! Number of helping threads currently inside run
+  std::atomic<unsigned> helpers;
+
+  NestedTask(): helpers(0) { }
+  virtual ~NestedTask() { }
+  virtual void run() = 0;
+};
+
+/**
+ * Publishes task to the other active threads, runs it on the calling thread
+ * and returns once every helper has finished with it. Conflict detection is
+ * disabled for the duration of the task on all threads running it.
+ */
+void runNested(NestedTask& task);
+
+/**
+ * Runs part of a task published by another thread. Called by threads of a
+ * parallel loop that are otherwise idle. Returns true if any work was done.
+ */
+bool helpNested();
+
+/**
+ * Applies a functor to a range of items in chunks claimed by the threads
+ * running the task. As in a top-level do_all, each thread runs its own copy
+ * of the functor; with a reducer, the copies are folded into result when
+ * each thread leaves the task.
+ */
+template<typename IterTy, typename FunctionTy, typename ReduceFunTy>
+class NestedDoAll: public NestedTask {
+  //! Protects cur and result
+  LL::SimpleLock<true> lock;
+  IterTy cur;
+  IterTy end;
+  const FunctionTy& origF;
+  FunctionTy& result;
+  ReduceFunTy RF;
+  bool needsReduce;
+  size_t chunkSize;
+
+  bool nextChunk(IterTy& b, IterTy& e) {
+    lock.lock();
+    b = cur;
+    for (size_t i = 0; i < chunkSize && cur != end; ++i)
+      ++cur;
+    e = cur;
+    lock.unlock();
+    return b != e;
+  }
+
+public:
+  NestedDoAll(const IterTy& b, const IterTy& e, const FunctionTy& f, FunctionTy& r, const ReduceFunTy& rf, bool reduce):
+    cur(b), end(e), origF(f), result(r), RF(rf), needsReduce(reduce)
+  {
+    // Several chunks per thread so that late helpers still find work
+    chunkSize = std::max(std::distance(b, e) / (8 * activeThreads), (typename std::iterator_traits<IterTy>::difference_type) 1);
+  }
+
+  virtual void run() {
+    FunctionTy fn(origF);
+    IterTy b, e;
+    while (nextChunk(b, e)) {
+      for (; b != e; ++b)
+        fn(*b);
+    }
+    if (needsReduce) {
+      lock.lock();
+      RF(result, fn);
+      lock.unlock();
+    }
+  }
+};
+
+/**
+ * Runs a for_each operator over a worklist shared by the threads running the
+ * task. Items the operator pushes join the same worklist, and run returns
+ * once every item has been processed. The operator must not need aborts or
+ * parallel break.
+ */
+template<typename T, typename FunctionTy>
+class NestedForEach: public NestedTask {
+  WorkList::GFIFO<T> wl;
+  const FunctionTy& origF;
+  //! Items pushed and not yet processed
+  std::atomic<size_t> pending;
+
+public:
+  template<typename IterTy>
+  NestedForEach(const IterTy& b, const IterTy& e, const FunctionTy& f): origF(f), pending(0) {
+    for (IterTy ii = b; ii != e; ++ii) {
+      wl.push(*ii);
+      ++pending;
+    }
+  }
+
+  virtual void run() {
+    FunctionTy fn(origF);
+    UserContextAccess<T> facing;
+    while (pending.load(std::memory_order_acquire)) {
+      Galois::optional<T> p = wl.pop();
+      if (!p) {
+        // Another thread holds the remaining items and may push more
+        LL::asmPause();
+        continue;
+      }
+      fn(*p, facing.data());
+      typename UserContextAccess<T>::PushBufferTy& pushed = facing.getPushBuffer();
+      if (pushed.begin() != pushed.end()) {
+        // Count new items before retiring this one so pending never drops to zero early
+        pending.fetch_add(std::distance(pushed.begin(), pushed.end()));
+        wl.push(pushed.begin(), pushed.end());
+        facing.resetPushBuffer();
+      }
+      facing.resetAlloc();
+      pending.fetch_sub(1, std::memory_order_release);
+    }
+  }
+};
+
+}
+} // end namespace Galois
+
+#endif
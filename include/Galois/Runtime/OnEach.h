@@ -0,0 +1,86 @@
+/** Galois on each executor -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2012, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Runs a function once on each active thread. Kept apart from the foreach
+ * executor so that lightweight headers can use it.
+ *
+ * @author Andrew Lenharth <andrewl@lenharth.org>
+ */
+#ifndef GALOIS_RUNTIME_ONEACH_H
+#define GALOIS_RUNTIME_ONEACH_H
+
+#include "Galois/Runtime/ActiveThreads.h"
+#include "Galois/Runtime/Barrier.h"
+#include "Galois/Runtime/Support.h"
+#include "Galois/Runtime/ThreadPool.h"
+#include "Galois/Runtime/ll/TID.h"
+#include "Galois/Runtime/ll/gio.h"
+
+#include <functional>
+
+namespace Galois {
+namespace Runtime {
+namespace {
+
+template<typename FunctionTy>
+struct WOnEach {
+  FunctionTy& origFunction;
+  WOnEach(FunctionTy& f): origFunction(f) { }
+  void operator()(void) {
+    FunctionTy fn(origFunction);
+    fn(LL::getTID(), activeThreads);   
+  }
+};
+
+template<typename FunctionTy>
+void on_each_impl(FunctionTy fn, const char* loopname = 0) {
+  if (inGaloisForEach)
+    GALOIS_DIE("Nested for_each not supported");
+
+  inGaloisForEach = true;
+  RunCommand w[2] = {WOnEach<FunctionTy>(fn),
+		     std::ref(getSystemBarrier())};
+  getSystemThreadPool().run(&w[0], &w[2], activeThreads);
+  inGaloisForEach = false;
+}
+
+//! on each executor with simple barrier.
+template<typename FunctionTy>
+void on_each_simple_impl(FunctionTy fn, const char* loopname = 0) {
+  if (inGaloisForEach)
+    GALOIS_DIE("Nested for_each not supported");
+
+  inGaloisForEach = true;
+  Barrier* b = createSimpleBarrier();
+  b->reinit(activeThreads);
+  RunCommand w[2] = {WOnEach<FunctionTy>(fn),
+		     std::ref(*b)};
+  getSystemThreadPool().run(&w[0], &w[2], activeThreads);
+  delete b;
+  inGaloisForEach = false;
+}
+
+} // end namespace anonymous
+} // end namespace Runtime
+} // end namespace Galois
+
+#endif
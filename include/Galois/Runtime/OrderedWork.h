@@ -20,13 +20,26 @@
  *
  * @section Description
  *
+ * Executors behind {@link Galois::for_each_ordered()}. Loops whose
+ * neighborhood function declares tt_has_fixed_neighborhood run on a kinetic
+ * dependence graph (KDG) executor; all others run on the two-phase
+ * executor of the deterministic runtime.
+ *
  * @author Donald Nguyen <ddn@cs.utexas.edu>
  */
 #ifndef GALOIS_RUNTIME_ORDERED_WORK_H
 #define GALOIS_RUNTIME_ORDERED_WORK_H
 
+#include "Galois/Bag.h"
+#include "Galois/Statistic.h"
 #include "Galois/Runtime/DeterministicWork.h"
-//#include "Galois/Runtime/LCordered.h"
+#include "Galois/Runtime/DoAll.h"
+#include "Galois/Runtime/UserContextAccess.h"
+#include "Galois/Runtime/mm/Mem.h"
+
+#include GALOIS_CXX11_STD_HEADER(atomic)
+#include <algorithm>
+#include <vector>
 
 namespace Galois {
 namespace Runtime {
@@ -38,38 +51,365 @@ struct OrderedTraits {
 };
 
 
+/**
+ * Wraps an operator so that an iteration is aborted and retried later
+ * unless its active element passes the stability test. Inherits from the
+ * operator so that its tt_* traits are still visible to the executor.
+ *
+ * Retries need no backoff: every round of the two-phase executor contains
+ * the least pending item, which is stable by definition, so each round
+ * commits at least one item. A test that rejects the least item would make
+ * every later round fail the same way, so the executor stops after a few
+ * rounds without a commit.
+ */
+template <typename OpFunc, typename StableTest>
+struct StableSourceOp: public OpFunc {
+  StableTest stabilityTest;
+
+  StableSourceOp(const OpFunc& opFunc, const StableTest& stabilityTest):
+    OpFunc(opFunc), stabilityTest(stabilityTest) { }
+
+  template <typename T, typename C>
+  void operator()(T& item, C& ctx) {
+    if (!stabilityTest(item))
+      signalConflict(NULL);
+    OpFunc::operator()(item, ctx);
+  }
+};
+
+//! Implementation of the KDG add-remove executor
+namespace KDGImpl {
+
+//! A pending task and the lockables its neighborhood function touched
+template<typename T>
+class Context: public SimpleRuntimeContext {
+public:
+  typedef T value_type;
+  typedef std::vector<Lockable*> Nhood;
+
+  T item;
+  Nhood nhood;
+  //! Set when the task is selected to execute
+  std::atomic<bool> onWL;
+
+  explicit Context(const T& i): SimpleRuntimeContext(true), item(i), onWL(false) { }
+
+  //! Makes this context hold a new task, keeping the storage of nhood
+  void recycle(const T& i) {
+    item = i;
+    nhood.clear();
+    onWL = false;
+  }
+
+  virtual void subAcquire(Lockable* lockable) {
+    if (std::find(nhood.begin(), nhood.end(), lockable) == nhood.end())
+      nhood.push_back(lockable);
+  }
+};
+
+/**
+ * The pending tasks whose neighborhoods contain a lockable. While the loop
+ * runs, an item is the owner of its lockable, so it is found without a
+ * separate map. Tasks sharing one lockable are expected to be few, so they
+ * are kept unordered; the least one is cached and found again by a scan
+ * only when it is removed. Each entry keeps a copy of the task so that the
+ * scan does not touch the contexts of the other tasks.
+ */
+template<typename Ctx, typename Cmp>
+class NhoodItem: public LockManagerBase {
+  typedef std::pair<typename Ctx::value_type, Ctx*> Entry;
+  typedef std::vector<Entry> Sharers;
+
+  LL::SimpleLock<true> mutex;
+  Sharers sharers;
+  //! Position of the least task in sharers
+  size_t min;
+  Lockable* lockable;
+
+  /**
+   * Strict total order on tasks. cmp may be a strict order or a less than or
+   * equal order, so a task only precedes another when cmp holds in one
+   * direction; tasks that are equal under cmp are ordered by address.
+   */
+  static bool before(const Cmp& cmp, const Entry& a, const Entry& b) {
+    bool ab = cmp(a.first, b.first);
+    bool ba = cmp(b.first, a.first);
+    if (ab != ba)
+      return ab;
+    return a.second < b.second;
+  }
+
+public:
+  explicit NhoodItem(Lockable* l): min(0), lockable(l) { }
+
+  //! Returns the item of a lockable in the neighborhood of some pending task
+  static NhoodItem* of(Lockable* l) {
+    return static_cast<NhoodItem*>(LockManagerBase::getOwner(l));
+  }
+
+  //! Returns the item of l, creating it and appending it to created if needed
+  static NhoodItem* get(Lockable* l, std::vector<NhoodItem*>& created) {
+    NhoodItem* n = of(l);
+    if (n)
+      return n;
+    n = new NhoodItem(l);
+    if (n->tryAcquire(l) == NEW_OWNER) {
+      created.push_back(n);
+      return n;
+    }
+    delete n;
+    // Another thread won but may not have published itself yet
+    while (!(n = of(l)))
+      LL::asmPause();
+    return n;
+  }
+
+  void add(Ctx* c, const Cmp& cmp) {
+    mutex.lock();
+    sharers.push_back(Entry(c->item, c));
+    if (before(cmp, sharers.back(), sharers[min]))
+      min = sharers.size() - 1;
+    mutex.unlock();
+  }
+
+  //! Removes c and returns the least remaining task, or null
+  Ctx* remove(Ctx* c, const Cmp& cmp) {
+    mutex.lock();
+    size_t pos = 0;
+    while (sharers[pos].second != c)
+      ++pos;
+    sharers[pos] = sharers.back();
+    sharers.pop_back();
+    if (pos == min) {
+      min = 0;
+      for (size_t i = 1; i < sharers.size(); ++i) {
+        if (before(cmp, sharers[i], sharers[min]))
+          min = i;
+      }
+    } else if (min == sharers.size()) {
+      // The least task was the last one and moved into the hole
+      min = pos;
+    }
+    Ctx* retval = sharers.empty() ? 0 : sharers[min].second;
+    mutex.unlock();
+    return retval;
+  }
+
+  //! Least task; only called when no thread is modifying the item
+  Ctx* least() const { return sharers.empty() ? 0 : sharers[min].second; }
+
+  bool empty() const { return sharers.empty(); }
+
+  //! Gives the lockable back to the graph
+  void release() {
+    LockManagerBase::release(lockable);
+  }
+};
+
+/**
+ * Add-remove executor for loops with fixed neighborhoods. The neighborhood
+ * function of a task runs once, when the task is created, and the task is
+ * added to the items of the lockables it touched. A task is a source when
+ * it is the least task of all of its items; sources have disjoint
+ * neighborhoods, so each round executes all current sources in parallel
+ * without locks. Executing a task removes it from its items and adds the
+ * tasks it pushed, and only the tasks that are now least in one of those
+ * items are checked for the next round.
+ *
+ * Like the two-phase executor, a task created by a task of the current
+ * round is not guaranteed to execute before a source of the same round
+ * that compares greater than it; the usual case of a task rescheduling
+ * itself at a later time over the same neighborhood is exact.
+ */
+template<typename T, typename Cmp, typename NhFunc, typename OpFunc>
+class Executor {
+  typedef Context<T> Ctx;
+  typedef NhoodItem<Ctx, Cmp> Item;
+  typedef Galois::InsertBag<Ctx*> Bag;
+
+  Cmp cmp;
+  NhFunc nhFunc;
+  OpFunc opFunc;
+  const char* loopname;
+  MM::FixedSizeAllocator heap;
+  PerThreadStorage<UserContextAccess<T> > facing;
+  PerThreadStorage<std::vector<Item*> > created;
+  PerThreadStorage<unsigned long> iterations;
+  Bag sources;
+  Bag candidates;
+
+  struct Spawn {
+    typedef int tt_does_not_need_stats;
+    Executor* self;
+    void operator()(const T& item) { self->spawn(self->make(item)); }
+  };
+
+  struct Select {
+    typedef int tt_does_not_need_stats;
+    Executor* self;
+    void operator()(Ctx* c) { self->select(c); }
+  };
+
+  struct Execute {
+    typedef int tt_does_not_need_stats;
+    Executor* self;
+    void operator()(Ctx* c) { self->execute(c); }
+  };
+
+  Ctx* make(const T& item) {
+    return new (heap.allocate(sizeof(Ctx))) Ctx(item);
+  }
+
+  //! Computes the neighborhood of a new task and makes it a candidate
+  void spawn(Ctx* c) {
+    setThreadContext(c);
+    nhFunc(c->item, facing.getLocal()->data());
+    setThreadContext(0);
+
+    std::vector<Item*>& mine = *created.getLocal();
+    for (typename Ctx::Nhood::iterator ii = c->nhood.begin(), ei = c->nhood.end(); ii != ei; ++ii)
+      Item::get(*ii, mine)->add(c, cmp);
+    candidates.push(c);
+  }
+
+  bool isSource(Ctx* c) const {
+    for (typename Ctx::Nhood::iterator ii = c->nhood.begin(), ei = c->nhood.end(); ii != ei; ++ii) {
+      if (Item::of(*ii)->least() != c)
+        return false;
+    }
+    return true;
+  }
+
+  void select(Ctx* c) {
+    // A task can be a candidate through several items
+    if (isSource(c) && !c->onWL.exchange(true))
+      sources.push(c);
+  }
+
+  void execute(Ctx* c) {
+    UserContextAccess<T>& f = *facing.getLocal();
+    opFunc(c->item, f.data());
+    *iterations.getLocal() += 1;
+
+    for (typename Ctx::Nhood::iterator ii = c->nhood.begin(), ei = c->nhood.end(); ii != ei; ++ii) {
+      Ctx* next = Item::of(*ii)->remove(c, cmp);
+      if (next)
+        candidates.push(next);
+    }
+
+    // The context of c is reused for the first task it pushed, which saves
+    // allocating one in the common case of a task rescheduling itself
+    Ctx* reuse = c;
+    if (ForEachTraits<OpFunc>::NeedsPush) {
+      typedef typename UserContextAccess<T>::PushBufferTy::iterator iterator;
+      for (iterator ii = f.getPushBuffer().begin(), ei = f.getPushBuffer().end(); ii != ei; ++ii) {
+        if (reuse) {
+          reuse->recycle(*ii);
+          spawn(reuse);
+          reuse = 0;
+        } else {
+          spawn(make(*ii));
+        }
+      }
+      f.resetPushBuffer();
+    }
+    if (ForEachTraits<OpFunc>::NeedsPIA)
+      f.resetAlloc();
+
+    if (reuse) {
+      reuse->~Ctx();
+      heap.deallocate(reuse);
+    }
+  }
+
+public:
+  Executor(const Cmp& c, const NhFunc& nh, const OpFunc& op, const char* ln):
+    cmp(c), nhFunc(nh), opFunc(op), loopname(ln), heap(sizeof(Ctx)) { }
+
+  template<typename Iter>
+  void go(Iter b, Iter e) {
+    Spawn spawnFn = { this };
+    Select selectFn = { this };
+    Execute executeFn = { this };
+
+    do_all_impl(makeStandardRange(b, e), spawnFn);
+
+    unsigned long rounds = 0;
+    while (true) {
+      do_all_impl(makeLocalRange(candidates), selectFn);
+      candidates.clear();
+      if (sources.empty())
+        break;
+      do_all_impl(makeLocalRange(sources), executeFn);
+      sources.clear();
+      ++rounds;
+    }
+
+    unsigned long total = 0;
+    for (unsigned i = 0; i < iterations.size(); ++i) {
+      total += *iterations.getRemote(i);
+      std::vector<Item*>& items = *created.getRemote(i);
+      for (typename std::vector<Item*>::iterator ii = items.begin(), ei = items.end(); ii != ei; ++ii) {
+        // The least pending task is always a source, so tasks left over
+        // mean that cmp is not a consistent order
+        if (!(*ii)->empty())
+          GALOIS_DIE("ordered loop ended with pending tasks but no sources");
+        (*ii)->release();
+        delete *ii;
+      }
+      items.clear();
+    }
+
+    if (ForEachTraits<OpFunc>::NeedsStats) {
+      reportStat(loopname, "Iterations", total);
+      reportStat(loopname, "RoundsExecuted", rounds);
+    }
+  }
+};
+
+} // end namespace KDGImpl
+
+template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
+void for_each_ordered_kdg(Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc, const OpFunc& opFunc, const char* loopname) {
+  typedef typename StandardRange<Iter>::value_type T;
+  KDGImpl::Executor<T, Cmp, NhFunc, OpFunc> W(cmp, nhFunc, opFunc, loopname);
+  W.go(beg, end);
+}
+
+template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
+void for_each_ordered_dispatch(Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc, const OpFunc& opFunc, const char* loopname, std::true_type) {
+  for_each_ordered_kdg(beg, end, cmp, nhFunc, opFunc, loopname);
+}
+
+template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
+void for_each_ordered_dispatch(Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc, const OpFunc& opFunc, const char* loopname, std::false_type) {
+  for_each_ordered_2p(beg, end, cmp, nhFunc, opFunc, loopname);
+}
+
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc>
 void for_each_ordered_impl (Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc, const OpFunc& opFunc, const char* loopname) {
-#if 0
-  if (!OrderedTraits<NhFunc, OpFunc>::NeedsPush && OrderedTraits<NhFunc, OpFunc>::HasFixedNeighborhood) {
-    // TODO: Remove-only/DAG executor
-    GALOIS_DIE("Remove-only executor not implemented yet");
-  } else if (OrderedTraits<NhFunc, OpFunc>::HasFixedNeighborhood) {
-    for_each_ordered_lc (beg, end, cmp, nhFunc, opFunc, loopname);
-  } else {
-    for_each_ordered_2p (beg, end, cmp, nhFunc, opFunc, loopname);
-  }
-#else
-  GALOIS_DIE("not yet implemented");
-#endif
+  StatTimer LoopTimer("LoopTime", loopname);
+  if (ForEachTraits<OpFunc>::NeedsStats)
+    LoopTimer.start();
+
+  for_each_ordered_dispatch(beg, end, cmp, nhFunc, opFunc, loopname,
+      std::integral_constant<bool, OrderedTraits<NhFunc, OpFunc>::HasFixedNeighborhood>());
+
+  if (ForEachTraits<OpFunc>::NeedsStats)
+    LoopTimer.stop();
 }
 
 
 template <typename Iter, typename Cmp, typename NhFunc, typename OpFunc, typename StableTest>
 void for_each_ordered_impl (Iter beg, Iter end, const Cmp& cmp, const NhFunc& nhFunc, const OpFunc& opFunc, const StableTest& stabilityTest, const char* loopname) {
-#if 0
-  if (!OrderedTraits<NhFunc, OpFunc>::NeedsPush && OrderedTraits<NhFunc, OpFunc>::HasFixedNeighborhood) {
-    GALOIS_DIE("no-adds + fixed-neighborhood == stable-source");
-  } else if (OrderedTraits<NhFunc, OpFunc>::HasFixedNeighborhood) {
-    for_each_ordered_lc (beg, end, cmp, nhFunc, opFunc, stabilityTest, loopname);
-  } else {
-    GALOIS_DIE("two-phase executor for unstable-source algorithms not implemented yet");
-    // TODO: implement following
-    // for_each_ordered_2p (beg, end, cmp, nhFunc, opFunc, stabilityTest, loopname); 
-  }
-#else
-  GALOIS_DIE("not yet implemented");
-#endif
+  StatTimer LoopTimer("LoopTime", loopname);
+  if (ForEachTraits<OpFunc>::NeedsStats)
+    LoopTimer.start();
+
+  for_each_ordered_2p (beg, end, cmp, nhFunc, StableSourceOp<OpFunc, StableTest> (opFunc, stabilityTest), loopname);
+
+  if (ForEachTraits<OpFunc>::NeedsStats)
+    LoopTimer.stop();
 }
 
 } // end namespace Runtime
@@ -34,6 +34,8 @@
 #include "Galois/Runtime/Barrier.h"
 #include "Galois/Runtime/Context.h"
 #include "Galois/Runtime/ForEachTraits.h"
+#include "Galois/Runtime/Nested.h"
+#include "Galois/Runtime/OnEach.h"
 #include "Galois/Runtime/Range.h"
 #include "Galois/Runtime/Stm.h"
 #include "Galois/Runtime/Support.h"
@@ -229,6 +231,14 @@ public:
   LocalAbortedList* getLocalQueue() { return localQueues.getLocal(); }
 };
 
+template<typename WLTy>
+void setWorkListLoopname(WLTy& wl, const char* loopname, boost::mpl::true_) {
+  wl.setLoopname(loopname);
+}
+
+template<typename WLTy>
+void setWorkListLoopname(WLTy&, const char*, boost::mpl::false_) { }
+
 template<class WorkListTy, class T, class FunctionTy>
 class ForEachWork {
 protected:
@@ -288,7 +298,8 @@ protected:
       tld.facing.resetAlloc();
   }
 
-  inline void doProcess(value_type& val, ThreadLocalData& tld) {
+  //! Returns false if the iteration recorded a conflict and must be aborted
+  inline bool doProcess(value_type& val, ThreadLocalData& tld) {
 #ifdef GALOIS_USE_TINYSTM
     // GCC 4.7, XLC optimize this variable away even in presence of setjmp
     // make volatile to prevent this
@@ -344,9 +355,14 @@ protected:
     if (ForEachTraits<FunctionTy>::NeedsPIA)
       tld.facing.resetAlloc();
 #else
+    if (ForEachTraits<FunctionTy>::NeedsCooperativeAborts && tld.ctx.isConflicted()) {
+      GALOIS_STM_END();
+      return false;
+    }
     commitIteration(tld);
     GALOIS_STM_END();
 #endif
+    return true;
   }
 
   bool runQueueSimple(ThreadLocalData& tld) {
@@ -378,7 +394,8 @@ protected:
     try {
 #endif
       while (p) {
-	doProcess(aborted.value(*p), tld);
+	if (!doProcess(aborted.value(*p), tld))
+	  abortIteration(*p, tld);
 	if (limit) {
 	  ++num;
 	  if (num == limit)
@@ -435,8 +452,10 @@ protected:
     // Thread-local data goes on the local stack to be NUMA friendly
     ThreadLocalData tld(origFunction, loopname);
     tld.facing.setBreakFlag(&broke);
-    if (couldAbort)
+    if (couldAbort) {
+      tld.ctx.setCooperativeAborts(ForEachTraits<FunctionTy>::NeedsCooperativeAborts);
       setThreadContext(&tld.ctx);
+    }
     if (ForEachTraits<FunctionTy>::NeedsPush && !couldAbort)
       tld.facing.setFastPushBack(
           std::bind(&ForEachWork::fastPushBack, std::ref(*this), std::placeholders::_1));
@@ -455,6 +474,10 @@ protected:
       } else { // No try/catch
         didWork = runQueueSimple(tld);
       }
+      // Help with loops nested in iterations of other threads. This thread
+      // did not run any iteration, so it is safe to leave its context.
+      if (!didWork)
+        helpNested();
       // Update node color and prop token
       term.localTermination(didWork);
     } while (!term.globalTermination() && (!ForEachTraits<FunctionTy>::NeedsBreak || !broke));
@@ -464,10 +487,14 @@ protected:
   }
 
 public:
-  ForEachWork(FunctionTy& f, const char* l): term(getSystemTermination()), origFunction(f), loopname(l), broke(false) { }
+  ForEachWork(FunctionTy& f, const char* l): term(getSystemTermination()), origFunction(f), loopname(l), broke(false) {
+    setWorkListLoopname(wl, loopname, typename needs_loopname<WLTy>::type());
+  }
   
   template<typename W>
-  ForEachWork(W& w, FunctionTy& f, const char* l): term(getSystemTermination()), wl(w), origFunction(f), loopname(l), broke(false) { }
+  ForEachWork(W& w, FunctionTy& f, const char* l): term(getSystemTermination()), wl(w), origFunction(f), loopname(l), broke(false) {
+    setWorkListLoopname(wl, loopname, typename needs_loopname<WLTy>::type());
+  }
 
   template<typename RangeTy>
   void AddInitialWork(const RangeTy& range) {
@@ -495,10 +522,27 @@ public:
   }
 };
 
+//! Nested for_each of a speculative operator: not supported
+template<typename RangeTy, typename FunctionTy>
+void for_each_nested(const RangeTy&, FunctionTy&, std::true_type) {
+  GALOIS_DIE("Nested for_each needs an operator with does_not_need_aborts and without needs_parallel_break");
+}
+
+//! Nested for_each: shares the items with idle threads of the enclosing loop
+template<typename RangeTy, typename FunctionTy>
+void for_each_nested(const RangeTy& range, FunctionTy& f, std::false_type) {
+  NestedForEach<typename RangeTy::value_type, FunctionTy> task(range.begin(), range.end(), f);
+  runNested(task);
+}
+
 template<typename WLTy, typename RangeTy, typename FunctionTy>
 void for_each_impl(const RangeTy& range, FunctionTy f, const char* loopname) {
-  if (inGaloisForEach)
-    GALOIS_DIE("Nested for_each not supported");
+  if (inGaloisForEach) {
+    // Nested iterations run without a context, so they cannot be rolled back
+    for_each_nested(range, f, std::integral_constant<bool,
+        ForEachTraits<FunctionTy>::NeedsAborts || ForEachTraits<FunctionTy>::NeedsBreak>());
+    return;
+  }
 
   StatTimer LoopTimer("LoopTime", loopname);
   if (ForEachTraits<FunctionTy>::NeedsStats)
@@ -527,44 +571,6 @@ void for_each_impl(const RangeTy& range, FunctionTy f, const char* loopname) {
   inGaloisForEach = false;
 }
 
-template<typename FunctionTy>
-struct WOnEach {
-  FunctionTy& origFunction;
-  WOnEach(FunctionTy& f): origFunction(f) { }
-  void operator()(void) {
-    FunctionTy fn(origFunction);
-    fn(LL::getTID(), activeThreads);   
-  }
-};
-
-template<typename FunctionTy>
-void on_each_impl(FunctionTy fn, const char* loopname = 0) {
-  if (inGaloisForEach)
-    GALOIS_DIE("Nested for_each not supported");
-
-  inGaloisForEach = true;
-  RunCommand w[2] = {WOnEach<FunctionTy>(fn),
-		     std::ref(getSystemBarrier())};
-  getSystemThreadPool().run(&w[0], &w[2], activeThreads);
-  inGaloisForEach = false;
-}
-
-//! on each executor with simple barrier.
-template<typename FunctionTy>
-void on_each_simple_impl(FunctionTy fn, const char* loopname = 0) {
-  if (inGaloisForEach)
-    GALOIS_DIE("Nested for_each not supported");
-
-  inGaloisForEach = true;
-  Barrier* b = createSimpleBarrier();
-  b->reinit(activeThreads);
-  RunCommand w[2] = {WOnEach<FunctionTy>(fn),
-		     std::ref(*b)};
-  getSystemThreadPool().run(&w[0], &w[2], activeThreads);
-  delete b;
-  inGaloisForEach = false;
-}
-
 } // end namespace anonymous
 
 void preAlloc_impl(int num);
@@ -26,10 +26,14 @@
 #define GALOIS_RUNTIME_RANGE_H
 
 #include "Galois/gstl.h"
+#include "Galois/MethodFlags.h"
 
 #include "Galois/Runtime/ActiveThreads.h"
 #include "Galois/Runtime/ll/TID.h"
 
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
 #include <iterator>
 
 namespace Galois {
@@ -106,6 +110,164 @@ inline StandardRange<IterTy> makeStandardRange(IterTy begin, IterTy end) {
   return StandardRange<IterTy>(begin, end);
 }
 
+//! Part of the out-edges of a node
+template<typename GraphTy>
+struct EdgeRangeItem {
+  typename GraphTy::GraphNode node;
+  typename GraphTy::edge_iterator begin;
+  typename GraphTy::edge_iterator end;
+};
+
+/**
+ * Range over the nodes of a graph that is divided among threads by
+ * cumulative out-degree rather than by node count. Each node counts as one
+ * unit of work plus one unit per out-edge, and the work of thread i of n is
+ * the i-th of n equal parts.
+ *
+ * If split is true, nodes that straddle a boundary between parts are split
+ * so that each thread processes only the edges in its part; a node may then
+ * appear several times with disjoint edge ranges whose union is all of its
+ * edges. Otherwise, each node appears once with all its edges and belongs to
+ * the thread whose part contains its first unit of work.
+ *
+ * Requires random access node and edge iterators whose edges are stored
+ * contiguously in node order (e.g., {@link LC_CSR_Graph}).
+ */
+template<typename GraphTy>
+class EdgeBalancedRange {
+  typedef typename GraphTy::iterator node_iterator;
+  typedef typename GraphTy::edge_iterator edge_iterator;
+
+  GraphTy* g;
+  edge_iterator firstEdge;
+  size_t numNodes;
+  size_t numWork;
+  bool split;
+
+  typename GraphTy::GraphNode node(size_t n) const { return *(g->begin() + n); }
+
+  //! Position of the first unit of work of node n
+  size_t workBegin(size_t n) const {
+    if (n == numNodes)
+      return numWork;
+    return n + std::distance(firstEdge, g->edge_begin(node(n), Galois::MethodFlag::NONE));
+  }
+
+  //! First node n such that workBegin(n) >= x (or > x if strict)
+  size_t search(size_t x, bool strict) const {
+    size_t lo = 0;
+    size_t hi = numNodes + 1;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      size_t w = workBegin(mid);
+      if (w < x || (strict && w == x))
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+public:
+  class iterator: public boost::iterator_facade<iterator, EdgeRangeItem<GraphTy>, 
+                                                boost::forward_traversal_tag, EdgeRangeItem<GraphTy> > {
+    const EdgeBalancedRange* r;
+    size_t n;
+    size_t a;
+    size_t b;
+
+    friend class boost::iterator_core_access;
+
+    void increment() { ++n; }
+    bool equal(const iterator& other) const { return n == other.n; }
+
+    EdgeRangeItem<GraphTy> dereference() const {
+      EdgeRangeItem<GraphTy> item;
+      item.node = r->node(n);
+      item.begin = r->g->edge_begin(item.node, Galois::MethodFlag::NONE);
+      item.end = r->g->edge_end(item.node, Galois::MethodFlag::NONE);
+      if (r->split) {
+        // Edge k of n is at work position workBegin(n) + 1 + k
+        size_t first = r->workBegin(n) + 1;
+        size_t degree = std::distance(item.begin, item.end);
+        size_t lo = a > first ? std::min(a - first, degree) : 0;
+        size_t hi = b > first ? std::min(b - first, degree) : 0;
+        item.end = item.begin;
+        std::advance(item.begin, lo);
+        std::advance(item.end, std::max(lo, hi));
+      }
+      return item;
+    }
+
+  public:
+    iterator(): r(0), n(0), a(0), b(0) { }
+    iterator(const EdgeBalancedRange* _r, size_t _n, size_t _a, size_t _b): r(_r), n(_n), a(_a), b(_b) { }
+  };
+
+  typedef iterator local_iterator;
+  typedef iterator block_iterator;
+  typedef EdgeRangeItem<GraphTy> value_type;
+
+  EdgeBalancedRange(GraphTy& _g, bool _split): g(&_g), split(_split) {
+    numNodes = std::distance(g->begin(), g->end());
+    if (numNodes) {
+      firstEdge = g->edge_begin(node(0), Galois::MethodFlag::NONE);
+      numWork = numNodes + std::distance(firstEdge, g->edge_end(node(numNodes - 1), Galois::MethodFlag::NONE));
+    } else {
+      numWork = 0;
+    }
+  }
+
+  //! Returns the part of the range for thread tid of total threads
+  std::pair<iterator, iterator> thread_pair(unsigned tid, unsigned total) const {
+    size_t a = numWork * tid / total;
+    size_t b = numWork * (tid + 1) / total;
+    return work_pair(a, b);
+  }
+
+  //! Returns the part of the range covering work positions [a, b)
+  std::pair<iterator, iterator> work_pair(size_t a, size_t b) const {
+    if (a >= b)
+      return std::make_pair(iterator(this, 0, a, b), iterator(this, 0, a, b));
+    size_t first;
+    size_t last = search(b, false);
+    if (split) {
+      // Nodes with any work in [a, b)
+      first = search(a, true) - 1;
+      // Skip last node if only its node unit falls in [a, b) and it has
+      // edges, which are then processed by other threads
+      if (last > first && workBegin(last - 1) + 1 == b && workBegin(last) > b)
+        --last;
+    } else {
+      // Nodes whose first unit is in [a, b)
+      first = search(a, false);
+    }
+    return std::make_pair(iterator(this, first, a, b), iterator(this, last, a, b));
+  }
+
+  iterator begin() const { return work_pair(0, numWork).first; }
+  iterator end() const { return work_pair(0, numWork).second; }
+
+  std::pair<block_iterator, block_iterator> block_pair() const {
+    return thread_pair(LL::getTID(), activeThreads);
+  }
+
+  std::pair<local_iterator, local_iterator> local_pair() const {
+    return block_pair();
+  }
+
+  local_iterator local_begin() const { return block_begin(); }
+  local_iterator local_end() const { return block_end(); }
+
+  block_iterator block_begin() const { return block_pair().first; }
+  block_iterator block_end() const { return block_pair().second; }
+};
+
+template<typename GraphTy>
+inline EdgeBalancedRange<GraphTy> makeEdgeBalancedRange(GraphTy& g, bool split) {
+  return EdgeBalancedRange<GraphTy>(g, split);
+}
+
 }
 } // end namespace Galois
 
@@ -0,0 +1,129 @@
+/** Topology-aware reduction tree -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Combining trees over threads that follow package boundaries, used to
+ * reduce per-thread values without a global lock.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_RUNTIME_REDUCETREE_H
+#define GALOIS_RUNTIME_REDUCETREE_H
+
+#include "Galois/config.h"
+#include "Galois/Runtime/PerThreadStorage.h"
+#include "Galois/Runtime/ll/CompilerSpecific.h"
+#include "Galois/Runtime/ll/HWTopo.h"
+#include "Galois/Runtime/ll/TID.h"
+
+#include GALOIS_CXX11_STD_HEADER(atomic)
+#include <algorithm>
+
+namespace Galois {
+namespace Runtime {
+
+/**
+ * Shape of a combining tree over threads [0, num). Threads of a package form
+ * a binary tree rooted at the package leader, and package leaders form a
+ * binary tree over packages rooted at thread 0. Each thread has at most four
+ * children, and values only cross packages between leaders.
+ */
+struct ReduceTree {
+  static const unsigned maxChildren = 4;
+
+  //! Writes the children of tid into out and returns their number
+  static unsigned children(unsigned tid, unsigned num, unsigned* out) {
+    unsigned numPackages = LL::getMaxPackageForThread(num - 1) + 1;
+    unsigned pkg = LL::getPackageForThread(tid);
+    unsigned leader = LL::getLeaderForPackage(pkg);
+    unsigned end = num;
+    if (pkg + 1 < numPackages)
+      end = std::min(end, LL::getLeaderForPackage(pkg + 1));
+
+    unsigned n = 0;
+    unsigned rank = tid - leader;
+    for (unsigned i = 1; i <= 2; ++i) {
+      if (leader + 2 * rank + i < end)
+        out[n++] = leader + 2 * rank + i;
+    }
+    if (rank == 0) {
+      for (unsigned i = 1; i <= 2; ++i) {
+        if (2 * pkg + i < numPackages)
+          out[n++] = LL::getLeaderForPackage(2 * pkg + i);
+      }
+    }
+    return n;
+  }
+};
+
+/**
+ * Combines one value per thread along a {@link ReduceTree}. Every active
+ * thread calls {@link combine} with its value; each thread waits for the
+ * values of its children, folds them into its own value and hands the result
+ * to its parent. Values are passed by pointer, so a thread returns only after
+ * its parent has consumed its value.
+ */
+template<typename T>
+class TreeCombiner {
+  struct Slot {
+    T* value;
+    std::atomic<bool> ready;
+    Slot(): value(0), ready(false) { }
+  };
+
+  PerThreadStorage<Slot> slots;
+
+public:
+  /**
+   * Combines value with the values of the children of the calling thread
+   * using fn(T& lhs, T& rhs), which folds rhs into lhs. Returns true on
+   * thread 0, whose value then holds the combination of all values.
+   */
+  template<typename FnTy>
+  bool combine(T& value, FnTy& fn, unsigned num) {
+    unsigned tid = LL::getTID();
+    unsigned children[ReduceTree::maxChildren];
+    unsigned numChildren = ReduceTree::children(tid, num, children);
+
+    for (unsigned i = 0; i < numChildren; ++i) {
+      Slot& s = *slots.getRemote(children[i]);
+      while (!s.ready.load(std::memory_order_acquire))
+        LL::asmPause();
+      fn(value, *s.value);
+      s.ready.store(false, std::memory_order_release);
+    }
+
+    if (tid == 0)
+      return true;
+
+    Slot& s = *slots.getLocal();
+    s.value = &value;
+    s.ready.store(true, std::memory_order_release);
+    while (s.ready.load(std::memory_order_acquire))
+      LL::asmPause();
+    return false;
+  }
+};
+
+}
+} // end namespace Galois
+
+#endif
@@ -47,7 +47,7 @@ void reportPageAlloc(const char* category);
 //! Reports NUMA memory stats for all NUMA nodes
 void reportNumaAlloc(const char* category);
 
-//! Prints all stats
+//! Prints all stats, including the page allocator counters of each thread
 void printStats();
 
 }
@@ -36,6 +36,7 @@ namespace LL {
 //gIO.cpp: "GALOIS_DEBUG_TO_FILE"
 //gIO.cpp: "GALOIS_DEBUG_SKIP"
 //DeterministicWork.h: "GALOIS_FIXED_DET_WINDOW_SIZE"
+//AutoTune.cpp: "GALOIS_AUTOTUNE_FILE"
 //! Return true if the Enviroment variable is set
 bool EnvCheck(const char* parm);
 bool EnvCheck(const char* parm, int& val);
@@ -63,6 +63,18 @@ int numPageAllocTotal();
 //! Returns total large pages allocated for thread by Galois memory management subsystem
 int numPageAllocForThread(unsigned tid);
 
+//! Per-thread counters of the large page allocator
+struct PageAllocStats {
+  unsigned long hits;        //!< pages taken from the thread's cache
+  unsigned long misses;      //!< allocations that refilled the cache from the OS
+  unsigned long osAllocs;    //!< mappings requested from the OS
+  unsigned long osPages;     //!< pages obtained from the OS
+  unsigned long hugePages;   //!< pages obtained from the OS backed by huge pages
+  unsigned long remoteFrees; //!< pages freed to the cache of another thread
+};
+//! Returns page allocator counters for thread
+PageAllocStats pageAllocStatsForThread(unsigned tid);
+
 //! Returns total small pages allocated by OS on a NUMA node
 int numNumaAllocForNode(unsigned nodeid);
 //! Returns number of NUMA nodes on machine
@@ -23,6 +23,7 @@ kind.
 #define GALOIS_SPARSEBITVECTOR_H
 
 #include "Galois/Runtime/ll/SimpleLock.h"
+#include "Galois/Runtime/ll/CompilerSpecific.h"
 
 #include <vector>
 #include <string>
@@ -35,108 +36,128 @@ namespace Galois {
  * 
  * Stores objects as indices in sparse bit vectors.
  * Saves space when the data to be stored is sparsely populated.
+ *
+ * Bits are kept in a list of blocks of several words sorted by base. Bits
+ * are only ever added and blocks are linked in after they are filled, so
+ * readers (count, isSubsetEq, getAllSetBits) need no lock even while
+ * another thread adds bits. Writers must be serialized by the caller.
  */
 struct SparseBitVector {
   typedef unsigned long WORD;
   typedef Galois::Runtime::LL::SimpleLock<true> LockType;
   static const unsigned wordsize = sizeof(WORD)*8;
+  //! Words per block
+  static const unsigned blockwords = 4;
+  //! Bits per block
+  static const unsigned blocksize = wordsize * blockwords;
 
-  struct OneWord {
-    WORD bits;
+  static unsigned popcount(WORD w) { return __builtin_popcountl(w); }
+
+  struct Block {
+    WORD bits[blockwords];
     unsigned base;
-    struct OneWord *next;
-    LockType kulup;
+    Block* volatile next;
 
-    bool set(unsigned oo) {
-      WORD oribits = bits;
-      bits |= ((WORD)1 << oo);
-      return bits != oribits;
+    Block(unsigned bb): base(bb), next(0) {
+      for (unsigned ii = 0; ii < blockwords; ++ii)
+        bits[ii] = 0;
     }
 
-    OneWord(unsigned bb, unsigned oo) {
-      base = bb;
-      set(oo);
-      next = 0;
+    Block(const Block& o): base(o.base), next(0) {
+      for (unsigned ii = 0; ii < blockwords; ++ii)
+        bits[ii] = o.bits[ii];
     }
 
-    OneWord() { }
+    bool set(unsigned oo) {
+      WORD& w = bits[oo / wordsize];
+      WORD mask = (WORD)1 << (oo % wordsize);
+      if (w & mask)
+        return false;
+      w |= mask;
+      return true;
+    }
 
-    unsigned unify(OneWord *second) {
-      if (second) {
-        WORD oribits = count();
-        bits |= second->bits;
-        return count() - oribits;
-      }
-      return 0;
+    bool test(unsigned oo) const {
+      return bits[oo / wordsize] & ((WORD)1 << (oo % wordsize));
     }
-    unsigned count() {
-      unsigned numElements = 0;
-      WORD powerof2 = 1;
 
-      for (unsigned ii = 0; ii < wordsize; ++ii) {
-        if (bits & powerof2) {
-                ++numElements;
-        }
-        powerof2 <<= 1;
+    //! Ors in the bits of second; returns the number of bits that were added
+    unsigned unify(const Block* second) {
+      unsigned added = 0;
+      // Straight-line over a fixed number of words so the compiler can
+      // vectorize the or
+      for (unsigned ii = 0; ii < blockwords; ++ii) {
+        WORD n = second->bits[ii] & ~bits[ii];
+        added += popcount(n);
+        bits[ii] |= second->bits[ii];
       }
-      return numElements;
+      return added;
     }
-    inline bool isSubsetEq(OneWord *second) {
-      return (bits & second->bits) == bits;
+
+    unsigned count() const {
+      unsigned numElements = 0;
+      for (unsigned ii = 0; ii < blockwords; ++ii)
+        numElements += popcount(bits[ii]);
+      return numElements;
     }
-    OneWord *clone() {
-      OneWord *newword = new OneWord();
-      newword->base = base;
-      newword->bits = bits;
-      newword->next = 0;
-      return newword;
+
+    bool isSubsetEq(const Block* second) const {
+      WORD extra = 0;
+      for (unsigned ii = 0; ii < blockwords; ++ii)
+        extra |= bits[ii] & ~second->bits[ii];
+      return !extra;
     }
-    OneWord *cloneAll() {
-      OneWord *newlist = clone();
-      OneWord *ptr2;
 
-      for (OneWord *newlistptr = newlist, *ptr = next; ptr;) {
-        //ptr->lock();
-        newlistptr->next = ptr->clone();
-        ptr2 = ptr->next; 
-        //ptr->unlock();
-        ptr = ptr2;
-        newlistptr = newlistptr->next;
-      }
-      return newlist;
+    bool equals(const Block* second) const {
+      WORD diff = 0;
+      for (unsigned ii = 0; ii < blockwords; ++ii)
+        diff |= bits[ii] ^ second->bits[ii];
+      return !diff;
     }
-    void getAllSetBits(std::vector<unsigned> &setbits) {
-      WORD powerof2 = 1;
-      unsigned bitno = 0;
 
-      for (unsigned ii = 0; ii < wordsize; ++ii) {
-        if (bits & powerof2) {
-          setbits.push_back(base*wordsize + bitno);
-        }
-        powerof2 <<= 1;
-        ++bitno;
+    void getAllSetBits(std::vector<unsigned> &setbits) const {
+      for (unsigned ii = 0; ii < blockwords; ++ii) {
+        for (WORD w = bits[ii]; w; w &= w - 1)
+          setbits.push_back(base * blocksize + ii * wordsize + __builtin_ctzl(w));
       }
     }
-    void lock() {
-            kulup.lock();
-    }
-    void unlock() {
-            kulup.unlock();
-    }
   };
 
-  OneWord *head;
+  Block *head;
   LockType headkulup;
 
   SparseBitVector() {
     init(0);
   }
+  SparseBitVector(const SparseBitVector& o) {
+    init(0);
+    copyFrom(o);
+  }
+  SparseBitVector& operator=(const SparseBitVector& o) {
+    if (this != &o) {
+      clear();
+      copyFrom(o);
+    }
+    return *this;
+  }
+  ~SparseBitVector() {
+    clear();
+  }
   void init() {
     init(0);
   }
   void init(unsigned nelements) {
     head = 0;
   }
+  //! Frees all blocks; not safe with concurrent readers
+  void clear() {
+    for (Block* ptr = head; ptr; ) {
+      Block* next = ptr->next;
+      delete ptr;
+      ptr = next;
+    }
+    head = 0;
+  }
   void lock() {
     headkulup.lock();
   }
@@ -147,7 +168,7 @@ struct SparseBitVector {
     unsigned base, offset;
     getOffsets(bit, base, offset);
 
-    OneWord *ptr, *prev;
+    Block *ptr, *prev;
     ptr = head;
     prev = 0;
     for (; ptr && ptr->base <= base; ptr = ptr->next) {  // sorted order.
@@ -156,102 +177,94 @@ struct SparseBitVector {
       }
       prev = ptr;
     }
-    OneWord *newword = new OneWord(base, offset);
-    if (prev) {
-      //prev->lock();
-      newword->next = prev->next;
-      prev->next = newword;
-      //prev->unlock();
-    } else {
-      //lock();
-      newword->next = head;
-      head = newword;
-      //unlock();
-    }
+    Block *newblock = new Block(base);
+    newblock->set(offset);
+    newblock->next = ptr;
+    publish(prev, newblock);
     return true;
   }
-  unsigned unify(SparseBitVector &second) {
+  bool test(unsigned bit) const {
+    unsigned base, offset;
+    getOffsets(bit, base, offset);
+    for (Block* ptr = head; ptr && ptr->base <= base; ptr = ptr->next) {
+      if (ptr->base == base)
+        return ptr->test(offset);
+    }
+    return false;
+  }
+  //! Adds the bits of second; returns the number of bits that were added
+  unsigned unify(const SparseBitVector &second) {
     unsigned nchanged = 0;
-    OneWord *prev = 0, *ptrone, *ptrtwo;
-    for (ptrone = head, ptrtwo = second.head; ptrone && ptrtwo;) {
-      if (ptrone->base == ptrtwo->base) {
-        //ptrone->lock();
+    Block *prev = 0, *ptrone = head;
+    for (const Block* ptrtwo = second.head; ptrtwo; ptrtwo = ptrtwo->next) {
+      while (ptrone && ptrone->base < ptrtwo->base) {
+        prev = ptrone;
+        ptrone = ptrone->next;
+      }
+      if (ptrone && ptrone->base == ptrtwo->base) {
         nchanged += ptrone->unify(ptrtwo);
-        prev = ptrone; ptrone = ptrone->next;
-        ptrtwo = ptrtwo->next;
-        //prev->unlock();
-      } else if (ptrone->base < ptrtwo->base) {
-        prev = ptrone; 
-        //prev->lock();
+        prev = ptrone;
         ptrone = ptrone->next;
-        //prev->unlock();
       } else {
-        OneWord *newword = ptrtwo->clone();
-        newword->next = ptrone;
-        if (prev) {
-          //prev->lock();
-          prev->next = newword;
-          //prev->unlock();
-          prev = newword;
-        } else {
-          //lock();
-          head = prev = newword;
-          //unlock();
-        }
-        ptrtwo = ptrtwo->next;
-      }
-    }
-    if (ptrtwo) {
-      OneWord *remaining = ptrtwo->cloneAll();
-      if (prev) {
-        //prev->lock();
-        prev->next = remaining;
-        //prev->unlock();
-      } else if (ptrtwo) {
-        //lock();
-        head = remaining;
-        //unlock();
+        Block *newblock = new Block(*ptrtwo);
+        nchanged += newblock->count();
+        newblock->next = ptrone;
+        publish(prev, newblock);
+        prev = newblock;
       }
     }
     return nchanged;
   }
-  bool isSubsetEq(SparseBitVector &second) {
-    OneWord *ptrone, *ptrtwo;
+  bool isSubsetEq(const SparseBitVector &second) const {
+    const Block *ptrone, *ptrtwo;
     for (ptrone = head, ptrtwo = second.head; ptrone && ptrtwo; ptrone = ptrone->next) {
-      if (ptrone->base == ptrtwo->base) {
-        if (!ptrone->isSubsetEq(ptrtwo)) {
-          return false;
-        }
+      while (ptrtwo && ptrtwo->base < ptrone->base)
         ptrtwo = ptrtwo->next;
-      } else if (ptrone->base > ptrtwo->base) {
-          return false;
-      }
+      if (!ptrtwo || ptrtwo->base != ptrone->base || !ptrone->isSubsetEq(ptrtwo))
+        return false;
+      ptrtwo = ptrtwo->next;
     }
-    if (ptrone) {
-      return false;
+    return !ptrone;
+  }
+  //! Same bits as second; with hash(), lets clients share identical sets
+  bool equals(const SparseBitVector &second) const {
+    const Block *ptrone, *ptrtwo;
+    for (ptrone = head, ptrtwo = second.head; ptrone && ptrtwo; ptrone = ptrone->next, ptrtwo = ptrtwo->next) {
+      if (ptrone->base != ptrtwo->base || !ptrone->equals(ptrtwo))
+        return false;
     }
-    return true;
+    return !ptrone && !ptrtwo;
+  }
+  size_t hash() const {
+    size_t h = 0;
+    for (const Block* ptr = head; ptr; ptr = ptr->next) {
+      h = h * 31 + ptr->base;
+      for (unsigned ii = 0; ii < blockwords; ++ii)
+        h = h * 31 + ptr->bits[ii];
+    }
+    return h;
   }
-  inline void getOffsets(unsigned bit, unsigned &ventry, unsigned &wbit) {
-    ventry = bit / wordsize;
-    wbit = bit % wordsize;
+  static void getOffsets(unsigned bit, unsigned &ventry, unsigned &wbit) {
+    ventry = bit / blocksize;
+    wbit = bit % blocksize;
   }
-  unsigned count() {
+  unsigned count() const {
     unsigned nbits = 0;
-    for (OneWord *ptr = head; ptr; ptr = ptr->next) {
+    for (const Block *ptr = head; ptr; ptr = ptr->next) {
       nbits += ptr->count();
     }
     return nbits;
   }
-  unsigned getAllSetBits(std::vector<unsigned> &setbits) {
+  //! Appends the set bits in increasing order; returns the number of blocks
+  unsigned getAllSetBits(std::vector<unsigned> &setbits) const {
     unsigned nnodes = 0;
-    for (OneWord *ptr = head; ptr; ptr = ptr->next) {
+    for (const Block *ptr = head; ptr; ptr = ptr->next) {
       ptr->getAllSetBits(setbits);
       ++nnodes;
     }
     return nnodes;
   }
-  void print(std::ostream& out, std::string prefix = std::string("")) {
+  void print(std::ostream& out, std::string prefix = std::string("")) const {
     std::vector<unsigned> setbits;
     unsigned nnodes = getAllSetBits(setbits);
     out << "Elements(" << nnodes << "): ";
@@ -260,6 +273,25 @@ struct SparseBitVector {
     }
     out << "\n";
   }
+
+private:
+  //! Links a filled block after prev (or at the head) so readers never see it half built
+  void publish(Block* prev, Block* newblock) {
+    Galois::Runtime::LL::compilerBarrier();
+    if (prev)
+      prev->next = newblock;
+    else
+      head = newblock;
+  }
+
+  void copyFrom(const SparseBitVector& o) {
+    Block* prev = 0;
+    for (const Block* ptr = o.head; ptr; ptr = ptr->next) {
+      Block* newblock = new Block(*ptr);
+      publish(prev, newblock);
+      prev = newblock;
+    }
+  }
 };
 }
 
@@ -199,6 +199,21 @@ BOOST_MPL_HAS_XXX_TRAIT_DEF(tt_does_not_need_aborts)
 template<typename T>
 struct does_not_need_aborts : public has_tt_does_not_need_aborts<T> {};
 
+/**
+ * Indicates the operator checks {@link UserContext::isConflicted()} after
+ * each acquire and returns early if it is set. Conflicts are then handled
+ * by returning from the operator rather than by unwinding the stack.
+ * Operators must not read data they tried to acquire, nor modify shared
+ * state, once a conflict is recorded.
+ *
+ * This is opt-in because an operator that does not check would keep
+ * running on data owned by another iteration after a failed acquire;
+ * other operators still abort through {@link signalConflict}.
+ */
+BOOST_MPL_HAS_XXX_TRAIT_DEF(tt_needs_cooperative_aborts)
+template<typename T>
+struct needs_cooperative_aborts : public has_tt_needs_cooperative_aborts<T> {};
+
 /**
  * Indicates that the neighborhood set does not change through out i.e. is not
  * dependent on computed values. Examples of such fixed neighborhood is e.g. the 
@@ -210,6 +225,15 @@ BOOST_MPL_HAS_XXX_TRAIT_DEF(tt_has_fixed_neighborhood)
 template <typename T>
 struct has_fixed_neighborhood: public has_tt_has_fixed_neighborhood<T> {};
 
+/**
+ * Indicates the worklist wants to know the name of the loop it schedules.
+ * The runtime calls setLoopname(const char*) on such worklists before any
+ * work is added.
+ */
+BOOST_MPL_HAS_XXX_TRAIT_DEF(tt_needs_loopname)
+template <typename T>
+struct needs_loopname: public has_tt_needs_loopname<T> {};
+
 /**
  * Temporary type trait for pre-C++11 compilers, which don't support exact
  * std::is_trivially_constructible. 
@@ -26,6 +26,16 @@
 #ifndef GALOIS_UNIONFIND_H
 #define GALOIS_UNIONFIND_H
 
+#include "Galois/Accumulator.h"
+#include "Galois/Galois.h"
+#include "Galois/LargeArray.h"
+#include "Galois/ParallelSTL/ParallelSTL.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace Galois {
 /**
  * Intrusive union-find implementation. Users subclass this to get disjoint
@@ -98,5 +108,154 @@ public:
     }
   }
 };
+
+/**
+ * Concurrent union-find over the dense ids [0, size). Roots are linked by
+ * a fixed random priority of each id, which keeps trees shallow in
+ * expectation on any input, and finds halve the path they traverse. Both
+ * merge and find are lock-free.
+ *
+ * \code
+ * Galois::UnionFind<> uf(graph.size());
+ * uf.merge(a, b);
+ * assert(uf.find(a) == uf.find(b));
+ * \endcode
+ */
+template<typename IdTy = uint32_t>
+class UnionFind: private boost::noncopyable {
+public:
+  typedef IdTy value_type;
+  typedef std::pair<IdTy,IdTy> Edge;
+
+private:
+  LargeArray<IdTy> parents;
+
+  //! Total order on ids used to link roots; a bijection so there are no ties
+  static uint64_t priority(IdTy x) {
+    return static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ULL;
+  }
+
+  struct Init {
+    UnionFind* self;
+    void operator()(size_t x) { self->parents[x] = x; }
+  };
+
+  struct Canonicalize {
+    UnionFind* self;
+    void operator()(Edge& e) {
+      IdTy a = self->find(e.first);
+      IdTy b = self->find(e.second);
+      e = a < b ? Edge(a, b) : Edge(b, a);
+    }
+  };
+
+  struct IsSelf {
+    bool operator()(const Edge& e) const { return e.first == e.second; }
+  };
+
+  struct MergeEdge {
+    UnionFind* self;
+    Galois::GAccumulator<size_t>& merged;
+    void operator()(const Edge& e) {
+      if (self->merge(e.first, e.second))
+        merged += 1;
+    }
+  };
+
+public:
+  UnionFind() { }
+
+  explicit UnionFind(size_t n) { create(n); }
+
+  //! Makes every id in [0, n) its own set
+  void create(size_t n) {
+    parents.destroy();
+    parents.deallocate();
+    parents.allocateInterleaved(n);
+    Init fn = { this };
+    Galois::do_all(boost::counting_iterator<size_t>(0), boost::counting_iterator<size_t>(n), fn);
+  }
+
+  size_t size() const { return parents.size(); }
+
+  bool isRep(IdTy x) const { return parents[x] == x; }
+
+  //! Returns the representative of x, halving the path from x on the way
+  IdTy find(IdTy x) {
+    while (true) {
+      IdTy p = parents[x];
+      IdTy gp = parents[p];
+      if (p == gp)
+        return p;
+      // Only non-roots are updated and only to one of their ancestors, so
+      // racing finds and merges cannot create a cycle
+      parents[x] = gp;
+      x = gp;
+    }
+  }
+
+  bool sameSet(IdTy a, IdTy b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b)
+        return true;
+      // a may have been linked since it was found
+      if (isRep(a))
+        return false;
+    }
+  }
+
+  //! Lock-free merge. Returns if merge was done.
+  bool merge(IdTy a, IdTy b) {
+    while (true) {
+      a = find(a);
+      b = find(b);
+      if (a == b)
+        return false;
+      if (priority(a) > priority(b))
+        std::swap(a, b);
+      if (__sync_bool_compare_and_swap(&parents[a], a, b))
+        return true;
+    }
+  }
+
+  /**
+   * Merges the endpoints of a range of edges (pairs of ids) in parallel.
+   * Edges are processed in blocks. In each block, edges are replaced by the
+   * pair of current representatives of their endpoints, and those inside a
+   * component are dropped; the rest are sorted and deduplicated so repeated
+   * edges between two components cost one merge. Once most ids are in a
+   * few components, later blocks reduce to nearly nothing before the sort.
+   *
+   * @returns number of merges done
+   */
+  template<typename Iter>
+  size_t mergeEdges(Iter b, Iter e) {
+    // A spanning forest has fewer than size() edges, so blocks of that
+    // size leave most of the remaining edges inside components
+    const size_t blockSize = std::max(size(), (size_t) 1024);
+    std::vector<Edge> edges;
+    edges.reserve(blockSize);
+    Galois::GAccumulator<size_t> merged;
+
+    while (b != e) {
+      edges.clear();
+      for (; b != e && edges.size() < blockSize; ++b)
+        edges.push_back(*b);
+
+      Canonicalize canon = { this };
+      Galois::do_all(edges.begin(), edges.end(), canon);
+      edges.erase(std::remove_if(edges.begin(), edges.end(), IsSelf()), edges.end());
+      Galois::ParallelSTL::sort(edges.begin(), edges.end());
+      edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+      MergeEdge fn = { this, merged };
+      Galois::do_all(edges.begin(), edges.end(), fn);
+    }
+    return merged.reduce();
+  }
+};
+
 }
 #endif
@@ -137,6 +137,13 @@ public:
   //! Force the abort of this iteration
   void abort() { Galois::Runtime::forceAbort(); }
 
+  /**
+   * Returns true if this iteration has lost a conflict. Only operators with
+   * the {@link needs_cooperative_aborts} trait observe conflicts this way;
+   * for other operators, conflicts abort the iteration immediately.
+   */
+  bool isConflicted() const { return Galois::Runtime::isConflicted(); }
+
   //! Store and retrieve local state for deterministic
   void* getLocalState(bool& used) { used = localStateUsed; return localState; }
  
@@ -0,0 +1,233 @@
+/** Worklist that picks among several worklists per loop -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Chooses the worklist of a named loop from a set of candidates based on
+ * how long previous executions of the loop took with each of them.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_WORKLIST_AUTOTUNE_H
+#define GALOIS_WORKLIST_AUTOTUNE_H
+
+#include "Galois/optional.h"
+#include "Galois/Timer.h"
+#include "Galois/TypeTraits.h"
+#include "Galois/Runtime/ActiveThreads.h"
+#include "Galois/Runtime/Support.h"
+#include "Galois/Runtime/ll/SimpleLock.h"
+
+#include <boost/utility.hpp>
+#include <iterator>
+
+namespace Galois {
+namespace Runtime {
+
+/**
+ * Returns the candidate to use for the next execution of loopname with
+ * numThreads threads and numItems initial items. Times are kept separately
+ * for each loopname, thread count and power of two of numItems. Each
+ * candidate is tried once, in order, and afterwards the one with the least
+ * average time is used. If the environment variable GALOIS_AUTOTUNE_FILE
+ * names a file, times are loaded from and saved to it, so calibration
+ * carries over between runs.
+ */
+unsigned chooseTunedConfig(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs);
+
+//! Records the time of an execution of loopname with candidate config
+void recordTunedConfig(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs, unsigned config, unsigned long usec);
+
+}
+
+namespace WorkList {
+
+namespace detail {
+
+template<unsigned I, typename... WLs>
+struct AutoTuneList;
+
+template<unsigned I>
+struct AutoTuneList<I> {
+  static const unsigned size = I;
+
+  void create(unsigned) { }
+
+  template<typename V>
+  void push(unsigned, const V&) { }
+
+  template<typename Iter>
+  void push(unsigned, Iter, Iter) { }
+
+  template<typename RangeTy>
+  void push_initial(unsigned, const RangeTy&) { }
+
+  template<typename V>
+  Galois::optional<V> pop(unsigned) { return Galois::optional<V>(); }
+};
+
+//! Only the chosen worklist is constructed, so the others neither allocate
+//! nor report statistics
+template<unsigned I, typename Head, typename... Tail>
+struct AutoTuneList<I, Head, Tail...> {
+  static const unsigned size = AutoTuneList<I + 1, Tail...>::size;
+
+  Head* wl;
+  AutoTuneList<I + 1, Tail...> rest;
+
+  AutoTuneList(): wl(0) { }
+  ~AutoTuneList() { delete wl; }
+
+  void create(unsigned c) {
+    if (c == I)
+      wl = new Head();
+    else
+      rest.create(c);
+  }
+
+  template<typename V>
+  void push(unsigned c, const V& val) {
+    if (c == I)
+      wl->push(val);
+    else
+      rest.push(c, val);
+  }
+
+  template<typename Iter>
+  void push(unsigned c, Iter b, Iter e) {
+    if (c == I)
+      wl->push(b, e);
+    else
+      rest.push(c, b, e);
+  }
+
+  template<typename RangeTy>
+  void push_initial(unsigned c, const RangeTy& range) {
+    if (c == I)
+      wl->push_initial(range);
+    else
+      rest.push_initial(c, range);
+  }
+
+  template<typename V>
+  Galois::optional<V> pop(unsigned c) {
+    if (c == I)
+      return wl->pop();
+    return rest.template pop<V>(c);
+  }
+};
+
+template<typename Head, typename... Tail>
+struct AutoTuneFirst { typedef Head type; };
+
+}
+
+/**
+ * Schedules a loop with one of the worklists WLs, chosen by {@link
+ * Runtime::chooseTunedConfig} from the times of previous executions of the
+ * loop with the same number of threads and a similar number of initial
+ * items. Loops must be named with {@link Galois::loopname}; unnamed loops
+ * always use the first worklist. The worklist is chosen when the initial
+ * items are pushed, so items must not be pushed before push_initial().
+ *
+ * \code
+ * typedef AutoTune<dChunkedFIFO<16>, dChunkedFIFO<64>, dChunkedLIFO<64> > WL;
+ * Galois::for_each(b, e, fn, Galois::loopname("main"), Galois::wl<WL>());
+ * \endcode
+ */
+template<typename... WLs>
+class AutoTune : private boost::noncopyable {
+  typedef detail::AutoTuneList<0, WLs...> List;
+
+  List wls;
+  unsigned chosen;
+  const char* loopname;
+  unsigned numThreads;
+  size_t numItems;
+  Runtime::LL::SimpleLock<true> lock;
+  volatile bool created;
+  Galois::Timer timer;
+
+  template<typename RangeTy>
+  void choose(const RangeTy& range) {
+    lock.lock();
+    if (!created) {
+      if (loopname) {
+        numThreads = Runtime::activeThreads;
+        numItems = std::distance(range.begin(), range.end());
+        chosen = Runtime::chooseTunedConfig(loopname, numThreads, numItems, List::size);
+        timer.start();
+      }
+      wls.create(chosen);
+      created = true;
+    }
+    lock.unlock();
+  }
+
+public:
+  typedef int tt_needs_loopname;
+
+  template<bool _concurrent>
+  struct rethread { typedef AutoTune<typename WLs::template rethread<_concurrent>::type...> type; };
+
+  template<typename _T>
+  struct retype { typedef AutoTune<typename WLs::template retype<_T>::type...> type; };
+
+  typedef typename detail::AutoTuneFirst<WLs...>::type::value_type value_type;
+
+  AutoTune(): chosen(0), loopname(0), numThreads(0), numItems(0), created(false) { }
+
+  ~AutoTune() {
+    if (!loopname || !created)
+      return;
+    timer.stop();
+    Runtime::recordTunedConfig(loopname, numThreads, numItems, List::size, chosen, timer.get_usec());
+    Runtime::reportStat(loopname, "AutoTuneConfig", chosen);
+  }
+
+  void setLoopname(const char* l) {
+    loopname = l;
+  }
+
+  void push(const value_type& val) {
+    wls.push(chosen, val);
+  }
+
+  template<typename Iter>
+  void push(Iter b, Iter e) {
+    wls.push(chosen, b, e);
+  }
+
+  //! Chooses the worklist on the first call
+  template<typename RangeTy>
+  void push_initial(const RangeTy& range) {
+    if (!created)
+      choose(range);
+    wls.push_initial(chosen, range);
+  }
+
+  Galois::optional<value_type> pop() {
+    return wls.template pop<value_type>(chosen);
+  }
+};
+
+}
+}
+#endif
@@ -0,0 +1,234 @@
+/** Relaxed concurrent priority worklist -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * MultiQueue: a set of locked binary heaps, several per thread. Pushes go to
+ * a random heap and pops take the better top of two random heaps, which
+ * keeps the order close to that of a single priority queue without a
+ * global lock.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#ifndef GALOIS_WORKLIST_MULTIQUEUE_H
+#define GALOIS_WORKLIST_MULTIQUEUE_H
+
+#include "Galois/optional.h"
+#include "Galois/Statistic.h"
+#include "Galois/Runtime/ActiveThreads.h"
+#include "Galois/Runtime/PerThreadStorage.h"
+#include "Galois/Runtime/ll/PaddedLock.h"
+#include "Galois/Runtime/ll/TID.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace Galois {
+namespace WorkList {
+
+/**
+ * Relaxed priority worklist. Items that are smaller according to Compare
+ * are popped first, but a pop may return an item that is not the smallest
+ * one. Quality of order is estimated by sampling pops and counting the heaps
+ * whose top precedes the popped item; the sums are reported as the
+ * statistics MultiQueueRankError and MultiQueueRankSamples.
+ *
+ * @tparam Compare strict weak order on T
+ * @tparam T value type of worklist
+ * @tparam concurrent if false, a single heap without locking
+ * @tparam QueuesPerThread number of heaps per active thread
+ */
+template<class Compare = std::less<int>, typename T = int, bool concurrent = true, unsigned QueuesPerThread = 2>
+class MultiQueue : private boost::noncopyable {
+  //! Reversed order so that the std heap functions keep the smallest item on top
+  struct HeapCompare {
+    Compare c;
+    bool operator()(const T& a, const T& b) const { return c(b, a); }
+  };
+
+  struct Queue {
+    Runtime::LL::PaddedLock<concurrent> lock;
+    std::vector<T> heap;
+    //! Size of the heap, read without the lock only as a hint
+    volatile size_t size;
+    Queue(): size(0) { }
+  };
+
+  struct ThreadData {
+    unsigned long seed;
+    unsigned pops;
+    ThreadData(): seed(0), pops(0) { }
+  };
+
+  //! Pops with a failed try_lock or two empty heaps before scanning all heaps
+  static const int attempts = 4;
+  //! One out of this many pops is checked for rank error
+  static const unsigned sampleInterval = 64;
+
+  std::vector<Queue> queues;
+  Runtime::PerThreadStorage<ThreadData> tld;
+  Compare compare;
+  Galois::Statistic rankError;
+  Galois::Statistic rankSamples;
+
+  //! xorshift generator per thread
+  unsigned next() {
+    ThreadData& d = *tld.getLocal();
+    if (!d.seed)
+      d.seed = (Runtime::LL::getTID() + 1) * 2654435761UL;
+    d.seed ^= d.seed << 13;
+    d.seed ^= d.seed >> 7;
+    d.seed ^= d.seed << 17;
+    return d.seed;
+  }
+
+  Queue& random() {
+    return queues[next() % queues.size()];
+  }
+
+  void pushLocked(Queue& q, const T& val) {
+    q.heap.push_back(val);
+    std::push_heap(q.heap.begin(), q.heap.end(), HeapCompare());
+    q.size = q.heap.size();
+  }
+
+  T popLocked(Queue& q) {
+    std::pop_heap(q.heap.begin(), q.heap.end(), HeapCompare());
+    T v = q.heap.back();
+    q.heap.pop_back();
+    q.size = q.heap.size();
+    return v;
+  }
+
+  //! Copies the top of q under its lock; fails if q is empty or, unless blocking, busy
+  bool peek(Queue& q, T& v, bool blocking) {
+    if (!q.size)
+      return false;
+    if (blocking)
+      q.lock.lock();
+    else if (!q.lock.try_lock())
+      return false;
+    bool ok = !q.heap.empty();
+    if (ok)
+      v = q.heap.front();
+    q.lock.unlock();
+    return ok;
+  }
+
+  //! Pops from q if it is not empty
+  bool tryPop(Queue& q, T& v, bool blocking) {
+    if (!q.size)
+      return false;
+    if (blocking)
+      q.lock.lock();
+    else if (!q.lock.try_lock())
+      return false;
+    bool ok = !q.heap.empty();
+    if (ok)
+      v = popLocked(q);
+    q.lock.unlock();
+    return ok;
+  }
+
+  void sample(const T& v) {
+    ThreadData& d = *tld.getLocal();
+    if (++d.pops % sampleInterval)
+      return;
+    unsigned long error = 0;
+    T top;
+    for (typename std::vector<Queue>::iterator ii = queues.begin(), ei = queues.end(); ii != ei; ++ii) {
+      if (peek(*ii, top, true) && compare(top, v))
+        ++error;
+    }
+    rankError += error;
+    rankSamples += 1;
+  }
+
+public:
+  template<bool newconcurrent>
+  struct rethread { typedef MultiQueue<Compare, T, newconcurrent, QueuesPerThread> type; };
+
+  template<typename Tnew>
+  struct retype { typedef MultiQueue<Compare, Tnew, concurrent, QueuesPerThread> type; };
+
+  typedef T value_type;
+
+  MultiQueue():
+    queues(concurrent ? std::max(Runtime::activeThreads * QueuesPerThread, 1U) : 1),
+    rankError("MultiQueueRankError"),
+    rankSamples("MultiQueueRankSamples") { }
+
+  void push(const value_type& val) {
+    Queue* q = &random();
+    for (int i = 0; !q->lock.try_lock(); ++i) {
+      if (i == attempts) {
+        q->lock.lock();
+        break;
+      }
+      q = &random();
+    }
+    pushLocked(*q, val);
+    q->lock.unlock();
+  }
+
+  template<typename Iter>
+  void push(Iter b, Iter e) {
+    for (; b != e; ++b)
+      push(*b);
+  }
+
+  template<typename RangeTy>
+  void push_initial(RangeTy range) {
+    push(range.local_begin(), range.local_end());
+  }
+
+  Galois::optional<value_type> pop() {
+    T v, top1, top2;
+    for (int i = 0; i < attempts; ++i) {
+      Queue& q1 = random();
+      Queue& q2 = random();
+      bool has1 = peek(q1, top1, false);
+      bool has2 = peek(q2, top2, false);
+      Queue* q = &q1;
+      if (!has1 || (has2 && compare(top2, top1)))
+        q = &q2;
+      if (tryPop(*q, v, false)) {
+        sample(v);
+        return Galois::optional<value_type>(v);
+      }
+    }
+
+    // Scan every heap so that an empty result means the worklist was empty
+    size_t start = next();
+    for (size_t i = 0; i < queues.size(); ++i) {
+      if (tryPop(queues[(start + i) % queues.size()], v, true)) {
+        sample(v);
+        return Galois::optional<value_type>(v);
+      }
+    }
+    return Galois::optional<value_type>();
+  }
+};
+GALOIS_WLCOMPILECHECK(MultiQueue)
+
+}
+}
+#endif
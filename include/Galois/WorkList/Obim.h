@@ -25,16 +25,32 @@
 
 #include "Galois/config.h"
 #include "Galois/FlatMap.h"
+#include "Galois/Statistic.h"
 #include "Galois/Runtime/PerThreadStorage.h"
+#include "Galois/Runtime/Support.h"
 #include "Galois/WorkList/Fifo.h"
 #include "Galois/WorkList/WorkListHelpers.h"
 
 #include GALOIS_CXX11_STD_HEADER(type_traits)
 #include <limits>
+#include <vector>
 
 namespace Galois {
 namespace WorkList {
 
+namespace detail {
+//! Rounds index down to a multiple of 2^shift; non-integral indices are not merged
+template<typename Index, bool = std::is_integral<Index>::value>
+struct CoarsenIndex {
+  static Index go(Index i, unsigned) { return i; }
+};
+
+template<typename Index>
+struct CoarsenIndex<Index, true> {
+  static Index go(Index i, unsigned shift) { return (i >> shift) << shift; }
+};
+}
+
 /**
  * Approximate priority scheduling. Indexer is a default-constructable class
  * whose instances conform to <code>R r = indexer(item)</code> where R is
@@ -53,36 +69,50 @@ namespace WorkList {
  * Galois::for_each<WL>(items.begin(), items.end(), Fn);
  * \endcode
  *
+ * Bins that a thread finds drained while looking for work are removed from
+ * the index and reused for later indices. If MaxBins is non-zero and more
+ * than MaxBins bins are live, the range of indices that share a bin doubles
+ * (for integral indices), which merges sparse bins in the style of adaptive
+ * delta-stepping.
+ * The number of bins visited by slow pops and the number of bins created,
+ * recycled and live are reported as statistics.
+ *
  * @tparam Indexer Indexer class
  * @tparam Container Scheduler for each bucket
  * @tparam BlockPeriod Check for higher priority work every 2^BlockPeriod
  *                     iterations
  * @tparam BSP Use back-scan prevention
+ * @tparam MaxBins Number of live bins above which bins are merged; 0 never
+ *                 merges bins
  */
 template<class Indexer = DummyIndexer<int>, typename Container = FIFO<>,
   unsigned BlockPeriod=0,
   bool BSP=true,
   typename T=int,
   typename Index=int,
-  bool Concurrent=true>
+  bool Concurrent=true,
+  unsigned MaxBins=0>
 struct OrderedByIntegerMetric : private boost::noncopyable {
   template<bool _concurrent>
-  struct rethread { typedef OrderedByIntegerMetric<Indexer, typename Container::template rethread<_concurrent>::type, BlockPeriod, BSP, T, Index, _concurrent> type; };
+  struct rethread { typedef OrderedByIntegerMetric<Indexer, typename Container::template rethread<_concurrent>::type, BlockPeriod, BSP, T, Index, _concurrent, MaxBins> type; };
 
   template<typename _T>
-  struct retype { typedef OrderedByIntegerMetric<Indexer, typename Container::template retype<_T>::type, BlockPeriod, BSP, _T, typename std::result_of<Indexer(_T)>::type, Concurrent> type; };
+  struct retype { typedef OrderedByIntegerMetric<Indexer, typename Container::template retype<_T>::type, BlockPeriod, BSP, _T, typename std::result_of<Indexer(_T)>::type, Concurrent, MaxBins> type; };
 
   template<unsigned _period>
-  struct with_block_period { typedef OrderedByIntegerMetric<Indexer, Container, _period, BSP, T, Index, Concurrent> type; };
+  struct with_block_period { typedef OrderedByIntegerMetric<Indexer, Container, _period, BSP, T, Index, Concurrent, MaxBins> type; };
 
   template<typename _container>
-  struct with_container { typedef OrderedByIntegerMetric<Indexer, _container, BlockPeriod, BSP, T, Index, Concurrent> type; };
+  struct with_container { typedef OrderedByIntegerMetric<Indexer, _container, BlockPeriod, BSP, T, Index, Concurrent, MaxBins> type; };
 
   template<typename _indexer>
-  struct with_indexer { typedef OrderedByIntegerMetric<_indexer, Container, BlockPeriod, BSP, T, Index, Concurrent> type; };
+  struct with_indexer { typedef OrderedByIntegerMetric<_indexer, Container, BlockPeriod, BSP, T, Index, Concurrent, MaxBins> type; };
 
   template<bool _bsp>
-  struct with_back_scan_prevention { typedef OrderedByIntegerMetric<Indexer, Container, BlockPeriod, _bsp, T, Index, Concurrent> type; };
+  struct with_back_scan_prevention { typedef OrderedByIntegerMetric<Indexer, Container, BlockPeriod, _bsp, T, Index, Concurrent, MaxBins> type; };
+
+  template<unsigned _bins>
+  struct with_max_bins { typedef OrderedByIntegerMetric<Indexer, Container, BlockPeriod, BSP, T, Index, Concurrent, _bins> type; };
 
   typedef T value_type;
 
@@ -98,23 +128,47 @@ private:
     CTy* current;
     unsigned int lastMasterVersion;
     unsigned int numPops;
+    //! Value of numRecycled when this thread last found every free bin empty
+    size_t emptyRecycled;
 
     perItem() :
       curIndex(std::numeric_limits<Index>::min()), 
       scanStart(std::numeric_limits<Index>::min()),
-      current(0), lastMasterVersion(0), numPops(0) { }
+      current(0), lastMasterVersion(0), numPops(0), emptyRecycled(0) { }
   };
 
+  //! Changes to the map from index to bin; a null bin removes the index
   typedef std::deque<std::pair<Index, CTy*> > MasterLog;
 
+  //! Most bins a slow pop hands back for recycling
+  static const int maxRecycle = 16;
+
   // NB: Place dynamically growing masterLog after fixed-size PerThreadStorage
   // members to give higher likelihood of reclaiming PerThreadStorage
   Runtime::PerThreadStorage<perItem> current;
   Runtime::LL::PaddedLock<Concurrent> masterLock;
   MasterLog masterLog;
+  //! Every bin allocated, for deallocation
+  std::deque<CTy*> allBins;
+  //! Bins removed from the map with the master version that includes their
+  //! removal. Pushes by threads that have not seen the removal may still land
+  //! here, so idle threads check them for work.
+  std::vector<std::pair<CTy*, unsigned int> > freeBins;
+  size_t liveBins;
+  size_t maxLiveBins;
+  std::atomic<size_t> numRecycled;
+  size_t createdSinceShift;
 
   std::atomic<unsigned int> masterVersion;
   Indexer indexer;
+  //! Indices that agree above the lowest shift bits share a bin
+  volatile unsigned shift;
+  Galois::Statistic scanLength;
+  Galois::Statistic slowPops;
+
+  Index getIndex(const value_type& val) {
+    return detail::CoarsenIndex<Index>::go(indexer(val), shift);
+  }
 
   bool updateLocal(perItem& p) {
     if (p.lastMasterVersion != masterVersion.load(std::memory_order_relaxed)) {
@@ -126,8 +180,14 @@ private:
         p.local.insert(masterLog[p.lastMasterVersion]);
 #else
         std::pair<Index, CTy*> logEntry = masterLog[p.lastMasterVersion];
-        p.local[logEntry.first] = logEntry.second;
-        assert(logEntry.second);
+        if (logEntry.second) {
+          p.local[logEntry.first] = logEntry.second;
+        } else {
+          p.local.erase(logEntry.first);
+          // Stop pushing to a removed bin once its removal has been seen
+          if (logEntry.first == p.curIndex)
+            p.current = 0;
+        }
 #endif
       }
       //masterLock.unlock();
@@ -154,16 +214,87 @@ private:
       }
     }
 
+    std::pair<Index, CTy*> drained[maxRecycle];
+    int numDrained = 0;
+    unsigned long scanned = 0;
+    Galois::optional<T> retval;
     for (auto ii = p.local.lower_bound(msS), ee = p.local.end(); ii != ee; ++ii) {
-      Galois::optional<T> retval;
+      ++scanned;
       if ((retval = ii->second->pop())) {
         p.current = ii->second;
         p.curIndex = ii->first;
         p.scanStart = ii->first;
-        return retval;
+        break;
       }
+      if (numDrained < maxRecycle)
+        drained[numDrained++] = *ii;
+    }
+    scanLength += scanned;
+    slowPops += 1;
+
+    if (retval) {
+      // Only bins below work that was found count as drained
+      if (numDrained)
+        recycle(p, drained, numDrained);
+      return retval;
     }
-    return Galois::optional<value_type>();
+
+    return popFreeBins(p);
+  }
+
+  //! Removes drained bins from the map and makes them available for reuse
+  GALOIS_ATTRIBUTE_NOINLINE
+  void recycle(perItem& p, std::pair<Index, CTy*>* drained, int num) {
+    if (!masterLock.try_lock())
+      return;
+    updateLocal(p);
+    unsigned int added = 0;
+    for (int i = 0; i < num; ++i) {
+      auto ii = p.local.find(drained[i].first);
+      // Another thread may have already recycled the bin
+      if (ii == p.local.end() || ii->second != drained[i].second || ii->second == p.current)
+        continue;
+      p.local.erase(ii);
+      masterLog.push_back(std::make_pair(drained[i].first, (CTy*) 0));
+      freeBins.push_back(std::make_pair(drained[i].second, 0U));
+      ++added;
+    }
+    unsigned int version = masterVersion.load(std::memory_order_relaxed) + added;
+    for (unsigned int i = 0; i < added; ++i)
+      freeBins[freeBins.size() - 1 - i].second = version;
+    liveBins -= added;
+    numRecycled.fetch_add(added, std::memory_order_relaxed);
+    p.lastMasterVersion = version;
+    masterVersion.fetch_add(added);
+    masterLock.unlock();
+  }
+
+  //! Finds work pushed to recycled bins. Once every thread has seen the
+  //! removal of every free bin and this thread finds them empty, it skips
+  //! the scan until more bins are recycled.
+  GALOIS_ATTRIBUTE_NOINLINE
+  Galois::optional<T> popFreeBins(perItem& p) {
+    Galois::optional<T> retval;
+    if (p.emptyRecycled == numRecycled.load(std::memory_order_relaxed))
+      return retval;
+    masterLock.lock();
+    size_t recycled = numRecycled.load(std::memory_order_relaxed);
+    // Read before checking bins so that no push can land in a bin after it
+    // was found empty
+    unsigned int seen = std::numeric_limits<unsigned int>::max();
+    for (unsigned i = 0; i < Runtime::activeThreads; ++i)
+      seen = std::min(seen, current.getRemote(i)->lastMasterVersion);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    bool settled = true;
+    for (auto ii = freeBins.begin(), ei = freeBins.end(); ii != ei; ++ii) {
+      if ((retval = ii->first->pop()))
+        break;
+      settled &= ii->second <= seen;
+    }
+    if (!retval && settled)
+      p.emptyRecycled = recycled;
+    masterLock.unlock();
+    return retval;
   }
 
   GALOIS_ATTRIBUTE_NOINLINE
@@ -179,7 +310,20 @@ private:
     updateLocal(p);
     CTy*& lC2 = p.local[i];
     if (!lC2) {
-      lC2 = new CTy();
+      if (freeBins.empty()) {
+        lC2 = new CTy();
+        allBins.push_back(lC2);
+      } else {
+        lC2 = freeBins.back().first;
+        freeBins.pop_back();
+      }
+      // Merge sparse bins by widening the range of indices of new bins. Give
+      // bins of the previous width a chance to drain before widening again.
+      if (++liveBins > MaxBins && MaxBins && ++createdSinceShift > MaxBins / 2 && shift + 1 < sizeof(Index) * 8) {
+        ++shift;
+        createdSinceShift = 0;
+      }
+      maxLiveBins = std::max(maxLiveBins, liveBins);
       p.lastMasterVersion = masterVersion.load(std::memory_order_relaxed) + 1;
       masterLog.push_back(std::make_pair(i, lC2));
       masterVersion.fetch_add(1);
@@ -198,18 +342,25 @@ private:
   }
 
 public:
-  OrderedByIntegerMetric(const Indexer& x = Indexer()): masterVersion(0), indexer(x) { }
+  OrderedByIntegerMetric(const Indexer& x = Indexer()):
+    liveBins(0), maxLiveBins(0), numRecycled(0), createdSinceShift(0),
+    masterVersion(0), indexer(x), shift(0),
+    scanLength("OBIMScanLength"), slowPops("OBIMSlowPops") { }
 
   ~OrderedByIntegerMetric() {
+    Runtime::reportStat(0, "OBIMBinsCreated", allBins.size());
+    Runtime::reportStat(0, "OBIMBinsRecycled", numRecycled);
+    Runtime::reportStat(0, "OBIMMaxLiveBins", maxLiveBins);
+    Runtime::reportStat(0, "OBIMBinShift", shift);
     // Deallocate in LIFO order to give opportunity for simple garbage
     // collection
-    for (auto ii = masterLog.rbegin(), ei = masterLog.rend(); ii != ei; ++ii) {
-      delete ii->second;
+    for (auto ii = allBins.rbegin(), ei = allBins.rend(); ii != ei; ++ii) {
+      delete *ii;
     }
   }
 
   void push(const value_type& val) {
-    Index index = indexer(val);
+    Index index = getIndex(val);
     perItem& p = *current.getLocal();
     // Fast path
     if (index == p.curIndex && p.current) {
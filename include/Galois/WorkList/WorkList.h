@@ -26,12 +26,14 @@
 #include "Galois/optional.h"
 
 #include "AltChunked.h"
+#include "AutoTune.h"
 #include "BulkSynchronous.h"
 #include "Chunked.h"
 #include "Fifo.h"
 #include "GFifo.h"
 #include "Lifo.h"
 #include "LocalQueue.h"
+#include "MultiQueue.h"
 #include "Obim.h"
 #include "OrderedList.h"
 #include "OwnerComputes.h"
@@ -42,8 +44,11 @@ namespace Galois {
  * Scheduling policies for Galois iterators. Unless you have very specific
  * scheduling requirement, {@link dChunkedLIFO} or {@link dChunkedFIFO} is a
  * reasonable scheduling policy. If you need approximate priority scheduling,
- * use {@link OrderedByIntegerMetric}. For debugging, you may be interested
+ * use {@link OrderedByIntegerMetric}; to order by a comparison instead of an
+ * integer metric, use {@link MultiQueue}. For debugging, you may be interested
  * in {@link FIFO} or {@link LIFO}, which try to follow serial order exactly.
+ * If the best choice depends on the input, {@link AutoTune} picks among
+ * several worklists based on previous executions of a loop.
  *
  * The way to use a worklist is to pass it as a template parameter to
  * {@link for_each()}. For example,
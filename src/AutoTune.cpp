@@ -0,0 +1,156 @@
+/** Worklist auto-tuning -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Records loop times for {@link Galois::WorkList::AutoTune}.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#include "Galois/WorkList/AutoTune.h"
+#include "Galois/Runtime/ll/SimpleLock.h"
+#include "Galois/Runtime/ll/StaticInstance.h"
+#include "Galois/Runtime/ll/gio.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+class TuneManager {
+  struct Entry {
+    unsigned long count;
+    unsigned long usec;
+    Entry(): count(0), usec(0) { }
+  };
+
+  //! Loops are told apart by name, thread count and log2 of the number of
+  //! initial items
+  struct Key {
+    std::string loopname;
+    unsigned numThreads;
+    unsigned sizeClass;
+    Key(const std::string& l, unsigned t, unsigned s): loopname(l), numThreads(t), sizeClass(s) { }
+    bool operator<(const Key& o) const {
+      if (numThreads != o.numThreads)
+        return numThreads < o.numThreads;
+      if (sizeClass != o.sizeClass)
+        return sizeClass < o.sizeClass;
+      return loopname < o.loopname;
+    }
+  };
+
+  typedef std::map<Key, std::vector<Entry> > History;
+
+  Galois::Runtime::LL::SimpleLock<true> lock;
+  History history;
+  const char* filename;
+
+  static unsigned sizeClass(size_t numItems) {
+    unsigned c = 0;
+    while (numItems >>= 1)
+      ++c;
+    return c;
+  }
+
+  //! File format is one line per candidate:
+  //! config count usec numThreads sizeClass loopname
+  void load() {
+    std::ifstream in(filename);
+    std::string loop;
+    unsigned config, numThreads, sc;
+    Entry e;
+    while (in >> config >> e.count >> e.usec >> numThreads >> sc && std::getline(in >> std::ws, loop)) {
+      std::vector<Entry>& v = history[Key(loop, numThreads, sc)];
+      if (v.size() <= config)
+        v.resize(config + 1);
+      v[config] = e;
+    }
+  }
+
+  void save() {
+    std::ofstream out(filename);
+    for (History::iterator ii = history.begin(), ei = history.end(); ii != ei; ++ii) {
+      for (unsigned x = 0; x < ii->second.size(); ++x) {
+        const Entry& e = ii->second[x];
+        out << x << " " << e.count << " " << e.usec << " " << ii->first.numThreads
+          << " " << ii->first.sizeClass << " " << ii->first.loopname << "\n";
+      }
+    }
+    if (!out)
+      Galois::Runtime::LL::gWarn("Unable to save tuning data to ", filename);
+  }
+
+  //! Forgets old data if the set of candidates changed
+  std::vector<Entry>& get(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs) {
+    std::vector<Entry>& v = history[Key(loopname, numThreads, sizeClass(numItems))];
+    if (v.size() != numConfigs)
+      v.assign(numConfigs, Entry());
+    return v;
+  }
+
+public:
+  TuneManager(): filename(getenv("GALOIS_AUTOTUNE_FILE")) {
+    if (filename)
+      load();
+  }
+
+  unsigned choose(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs) {
+    lock.lock();
+    std::vector<Entry>& v = get(loopname, numThreads, numItems, numConfigs);
+    unsigned best = 0;
+    for (unsigned x = 0; x < numConfigs; ++x) {
+      // Calibrate each candidate once
+      if (!v[x].count) {
+        best = x;
+        break;
+      }
+      if (v[x].usec * v[best].count < v[best].usec * v[x].count)
+        best = x;
+    }
+    lock.unlock();
+    return best;
+  }
+
+  void record(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs, unsigned config, unsigned long usec) {
+    lock.lock();
+    Entry& e = get(loopname, numThreads, numItems, numConfigs)[config];
+    e.count += 1;
+    e.usec += usec;
+    if (filename)
+      save();
+    lock.unlock();
+  }
+};
+
+static Galois::Runtime::LL::StaticInstance<TuneManager> TM;
+
+}
+
+unsigned Galois::Runtime::chooseTunedConfig(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs) {
+  return TM.get()->choose(loopname, numThreads, numItems, numConfigs);
+}
+
+void Galois::Runtime::recordTunedConfig(const char* loopname, unsigned numThreads, size_t numItems, unsigned numConfigs, unsigned config, unsigned long usec) {
+  TM.get()->record(loopname, numThreads, numItems, numConfigs, config, usec);
+}
@@ -34,6 +34,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <limits>
 
 class PthreadBarrier: public Galois::Runtime::Barrier {
   pthread_barrier_t bar;
@@ -48,8 +49,11 @@ class PthreadBarrier: public Galois::Runtime::Barrier {
 
 public:
   PthreadBarrier() {
-    //uninitialized barriers block a lot of threads to help with debugging
-    int rc = pthread_barrier_init(&bar, 0, ~0);
+    //uninitialized barriers block a lot of threads to help with debugging.
+    //glibc 2.23 and later return EINVAL for counts >= UINT_MAX/2, so the
+    //old ~0 made every default-constructed barrier abort; any count in the
+    //accepted range keeps the debugging behavior
+    int rc = pthread_barrier_init(&bar, 0, std::numeric_limits<int>::max() / 2);
     checkResults(rc);
   }
   
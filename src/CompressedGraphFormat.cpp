@@ -0,0 +1,109 @@
+/** Compressed graph file -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+#include "Galois/Graph/CompressedGraphFormat.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Galois::Graph;
+
+detail::CompressedGraphFile::~CompressedGraphFile() {
+  if (masterMapping)
+    munmap(masterMapping, masterLength);
+  if (masterFD != -1)
+    close(masterFD);
+}
+
+void detail::CompressedGraphFile::structureFromFile(const std::string& filename) {
+  masterFD = open(filename.c_str(), O_RDONLY);
+  if (masterFD == -1) {
+    GALOIS_SYS_DIE("failed opening ", filename);
+  }
+
+  struct stat buf;
+  if (fstat(masterFD, &buf) == -1) {
+    GALOIS_SYS_DIE("failed reading ", filename);
+  }
+  masterLength = buf.st_size;
+  if (masterLength < sizeof(header))
+    GALOIS_DIE("not a compressed graph: ", filename);
+
+  void* m = mmap(0, masterLength, PROT_READ, MAP_PRIVATE, masterFD, 0);
+  if (m == MAP_FAILED) {
+    GALOIS_SYS_DIE("failed reading ", filename);
+  }
+  masterMapping = m;
+
+  const uint64_t* fptr = reinterpret_cast<const uint64_t*>(m);
+  header.magic = convert_le64(*fptr++);
+  header.sizeofEdge = convert_le64(*fptr++);
+  header.numNodes = convert_le64(*fptr++);
+  header.numEdges = convert_le64(*fptr++);
+  header.numBytes = convert_le64(*fptr++);
+  if (header.magic != compressedGraphMagic)
+    GALOIS_DIE("not a compressed graph: ", filename);
+
+  size_t paddedBytes = header.numBytes + (8 - header.numBytes % 8) % 8;
+  size_t expected = sizeof(header) + 2 * header.numNodes * sizeof(uint64_t)
+    + paddedBytes + header.numEdges * header.sizeofEdge;
+  if (masterLength < expected)
+    GALOIS_DIE("failed reading ", filename, ": file is truncated");
+
+  edgeIdx = fptr;
+  fptr += header.numNodes;
+  byteIdx = fptr;
+  fptr += header.numNodes;
+  bytes = reinterpret_cast<const uint8_t*>(fptr);
+  edgeData = reinterpret_cast<const char*>(bytes + paddedBytes);
+}
+
+std::pair<uint64_t,uint64_t> detail::CompressedGraphFile::divideBy(size_t nodeSize, size_t edgeSize, unsigned tid, unsigned total) const {
+  uint64_t numNodes = header.numNodes;
+  uint64_t cost = numNodes * nodeSize + header.numEdges * edgeSize + header.numBytes;
+  uint64_t bounds[2];
+
+  for (unsigned i = 0; i < 2; ++i) {
+    uint64_t target = cost * (tid + i) / total;
+    // Find the first node whose preceding nodes cost at least target
+    uint64_t lb = 0;
+    uint64_t ub = numNodes;
+    while (lb < ub) {
+      uint64_t mid = lb + (ub - lb) / 2;
+      uint64_t size = mid * nodeSize + edgeBegin(mid) * edgeSize + byteBegin(mid);
+      if (size < target)
+        lb = mid + 1;
+      else
+        ub = mid;
+    }
+    bounds[i] = lb;
+  }
+
+  if (tid + 1 == total)
+    bounds[1] = numNodes;
+  return std::make_pair(bounds[0], bounds[1]);
+}
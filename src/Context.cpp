@@ -141,12 +141,17 @@ Galois::Runtime::LockManagerBase::AcquireStatus Galois::Runtime::LockManagerBase
 
 void Galois::Runtime::SimpleRuntimeContext::acquire(Galois::Runtime::Lockable* lockable) {
   AcquireStatus i;
-  if (customAcquire) {
+  if (conflicted) {
+    // Iteration will be aborted anyways; don't grow the neighborhood
+    return;
+  } else if (customAcquire) {
     subAcquire(lockable);
   } else if ((i = tryAcquire(lockable)) != AcquireStatus::FAIL) {
     if (i == AcquireStatus::NEW_OWNER) {
       addToNhood(lockable);
     }
+  } else if (cooperative) {
+    conflicted = true;
   } else {
     Galois::Runtime::signalConflict(lockable);
   }
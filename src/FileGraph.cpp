@@ -28,6 +28,8 @@
 #include "Galois/Runtime/mm/Mem.h"
 
 #include <cassert>
+#include <vector>
+#include <limits>
 
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -47,8 +49,12 @@ using namespace Galois::Graph;
 //potential padding (32bit max) to Re-Align to 64bits
 //EdgeType[numEdges] {EdgeType size}
 
+//File format V2:
+//Same as V1 except version (2) and outedges[numEdges] {uint64_t LE} and no
+//padding
+
 FileGraph::FileGraph()
-  : masterMapping(0), masterLength(0), masterFD(0),
+  : masterMapping(0), masterLength(0), masterFD(0), graphVersion(1),
     outIdx(0), outs(0), edgeData(0),
     numEdges(0), numNodes(0)
 {
@@ -61,23 +67,118 @@ FileGraph::~FileGraph() {
     close(masterFD);
 }
 
+#ifdef GALOIS_FORCE_NO_THREADS
+void Galois::Graph::detail::fileGraphOnEach(const std::function<void(unsigned,unsigned)>& fn) {
+  fn(0, 1);
+}
+#endif
+
+namespace {
+
+//! Number of blocks to divide node arrays into for parallel passes
+const uint64_t numPrefixBlocks = 1024;
+
+std::pair<uint64_t,uint64_t> prefixBlock(uint64_t n, uint64_t block) {
+  uint64_t per = (n + numPrefixBlocks - 1) / numPrefixBlocks;
+  return std::make_pair(std::min(per * block, n), std::min(per * (block + 1), n));
+}
+
+uint64_t convertLE(uint64_t x) { return Galois::convert_le64(x); }
+uint32_t convertLE(uint32_t x) { return Galois::convert_le32(x); }
+
+//! Copies an array converting to little endian
+template<typename T>
+struct CopyBlocks {
+  T* dst;
+  const T* src;
+  uint64_t size;
+
+  void operator()(unsigned tid, unsigned total) {
+    for (uint64_t b = tid; b < numPrefixBlocks; b += total) {
+      std::pair<uint64_t,uint64_t> r = prefixBlock(size, b);
+      for (uint64_t i = r.first; i < r.second; ++i)
+        dst[i] = convertLE(src[i]);
+    }
+  }
+};
+
+struct ZeroDegrees {
+  uint64_t* outIdx;
+  uint64_t numNodes;
+
+  void operator()(unsigned tid, unsigned total) {
+    for (uint64_t b = tid; b < numPrefixBlocks; b += total) {
+      std::pair<uint64_t,uint64_t> r = prefixBlock(numNodes, b);
+      std::fill(outIdx + r.first, outIdx + r.second, 0);
+    }
+  }
+};
+
+//! First pass of prefix sum: scan each block and record its total
+struct ScanBlocks {
+  uint64_t* outIdx;
+  uint64_t numNodes;
+  uint64_t* sums;
+
+  void operator()(unsigned tid, unsigned total) {
+    for (uint64_t b = tid; b < numPrefixBlocks; b += total) {
+      std::pair<uint64_t,uint64_t> r = prefixBlock(numNodes, b);
+      uint64_t sum = 0;
+      for (uint64_t i = r.first; i < r.second; ++i) {
+        sum += outIdx[i];
+        outIdx[i] = sum;
+      }
+      sums[b] = sum;
+    }
+  }
+};
+
+//! Second pass of prefix sum: add the total of preceding blocks
+struct OffsetBlocks {
+  uint64_t* outIdx;
+  uint32_t* starts;
+  uint64_t numNodes;
+  uint64_t* offsets;
+
+  void operator()(unsigned tid, unsigned total) {
+    for (uint64_t b = tid; b < numPrefixBlocks; b += total) {
+      std::pair<uint64_t,uint64_t> r = prefixBlock(numNodes, b);
+      uint64_t offset = offsets[b];
+      if (offset) {
+        for (uint64_t i = r.first; i < r.second; ++i)
+          outIdx[i] += offset;
+      }
+      std::fill(starts + r.first, starts + r.second, 0);
+    }
+  }
+};
+
+}
+
 void FileGraph::parse(void* m) {
   //parse file
   uint64_t* fptr = (uint64_t*)m;
   uint64_t version = convert_le64(*fptr++);
-  if (version != 1)
+  if (version != 1 && version != 2)
     GALOIS_DIE("unknown file version ", version);
+  graphVersion = version;
   sizeofEdge = convert_le64(*fptr++);
   numNodes = convert_le64(*fptr++);
   numEdges = convert_le64(*fptr++);
   outIdx = fptr;
   fptr += numNodes;
-  uint32_t* fptr32 = (uint32_t*)fptr;
-  outs = fptr32; 
-  fptr32 += numEdges;
-  if (numEdges % 2)
-    fptr32 += 1;
-  edgeData = (char*)fptr32;
+  if (version == 1) {
+    uint32_t* fptr32 = (uint32_t*)fptr;
+    outs = fptr32; 
+    fptr32 += numEdges;
+    if (numEdges % 2)
+      fptr32 += 1;
+    edgeData = (char*)fptr32;
+  } else {
+    outs = fptr;
+    fptr += numEdges;
+    edgeData = (char*)fptr;
+  }
 }
 
 void FileGraph::structureFromMem(void* mem, size_t len, bool clone) {
@@ -124,12 +225,26 @@ void* FileGraph::structureFromGraph(FileGraph& g, size_t sizeof_edge_data) {
 
 void* FileGraph::structureFromArrays(uint64_t* out_idx, uint64_t num_nodes,
       uint32_t* outs, uint64_t num_edges, size_t sizeof_edge_data) {
+  return structureFromArrays(out_idx, num_nodes, outs, num_edges, sizeof_edge_data, 1);
+}
+
+void* FileGraph::structureFromArrays(uint64_t* out_idx, uint64_t num_nodes,
+      uint64_t* outs, uint64_t num_edges, size_t sizeof_edge_data) {
+  return structureFromArrays(out_idx, num_nodes, outs, num_edges, sizeof_edge_data, 2);
+}
+
+void* FileGraph::structureFromArrays(uint64_t* out_idx, uint64_t num_nodes,
+      const void* outs, uint64_t num_edges, size_t sizeof_edge_data, uint64_t version) {
   uint64_t nBytes = sizeof(uint64_t) * 4; // version, sizeof_edge_data, numNodes, numEdges
 
   nBytes += sizeof(uint64_t) * num_nodes;
-  nBytes += sizeof(uint32_t) * num_edges;
-  if (num_edges % 2)
-    nBytes += sizeof(uint32_t); // padding
+  if (version == 1) {
+    nBytes += sizeof(uint32_t) * num_edges;
+    if (num_edges % 2)
+      nBytes += sizeof(uint32_t); // padding
+  } else {
+    nBytes += sizeof(uint64_t) * num_edges;
+  }
   nBytes += sizeof_edge_data * num_edges;
  
   int _MAP_BASE = MAP_ANONYMOUS | MAP_PRIVATE;
@@ -144,16 +259,20 @@ void* FileGraph::structureFromArrays(uint64_t* out_idx, uint64_t num_nodes,
   }
   
   uint64_t* fptr = (uint64_t*) base;
-  *fptr++ = convert_le64(1);
+  *fptr++ = convert_le64(version);
   *fptr++ = convert_le64(sizeof_edge_data);
   *fptr++ = convert_le64(num_nodes);
   *fptr++ = convert_le64(num_edges);
 
-  for (size_t i = 0; i < num_nodes; ++i)
-    *fptr++ = convert_le64(out_idx[i]);
-  uint32_t* fptr32 = (uint32_t*) fptr;
-  for (size_t i = 0; i < num_edges; ++i)
-    *fptr32++ = convert_le32(outs[i]);
+  CopyBlocks<uint64_t> copyIdx = { fptr, out_idx, num_nodes };
+  detail::fileGraphOnEach(copyIdx);
+  if (outs && version == 1) {
+    CopyBlocks<uint32_t> copyOuts = { (uint32_t*) (fptr + num_nodes), (const uint32_t*) outs, num_edges };
+    detail::fileGraphOnEach(copyOuts);
+  } else if (outs) {
+    CopyBlocks<uint64_t> copyOuts = { fptr + num_nodes, (const uint64_t*) outs, num_edges };
+    detail::fileGraphOnEach(copyOuts);
+  }
 
   structureFromMem(base, nBytes, false);
   return edgeData;
@@ -246,6 +365,7 @@ void FileGraph::swap(FileGraph& other) {
   std::swap(masterLength, other.masterLength);
   std::swap(sizeofEdge, other.sizeofEdge);
   std::swap(masterFD, other.masterFD);
+  std::swap(graphVersion, other.graphVersion);
   std::swap(outIdx, other.outIdx);
   std::swap(outs, other.outs);
   std::swap(edgeData, other.edgeData);
@@ -257,40 +377,31 @@ void FileGraph::cloneFrom(FileGraph& other) {
   structureFromMem(other.masterMapping, other.masterLength, true);
 }
 
-uint64_t FileGraph::getEdgeIdx(GraphNode src, GraphNode dst) const {
-  for (uint32_t* ii = raw_neighbor_begin(src),
-	 *ee = raw_neighbor_end(src); ii != ee; ++ii)
-    if (convert_le32(*ii) == dst)
-      return std::distance(outs, ii);
+uint64_t FileGraph::getEdgeIdx(LargeGraphNode src, LargeGraphNode dst) const {
+  for (edge_iterator ii = edge_begin(src), ee = edge_end(src); ii != ee; ++ii)
+    if (getEdgeDst(ii) == dst)
+      return *ii;
   return ~static_cast<uint64_t>(0);
 }
 
-uint32_t* FileGraph::raw_neighbor_begin(GraphNode N) const {
-  return (N == 0) ? &outs[0] : &outs[convert_le64(outIdx[N-1])];
-}
-
-uint32_t* FileGraph::raw_neighbor_end(GraphNode N) const {
-  return &outs[convert_le64(outIdx[N])];
-}
-
-FileGraph::edge_iterator FileGraph::edge_begin(GraphNode N) const {
+FileGraph::edge_iterator FileGraph::edge_begin(LargeGraphNode N) const {
   return edge_iterator(N == 0 ? 0 : convert_le64(outIdx[N-1]));
 }
 
-FileGraph::edge_iterator FileGraph::edge_end(GraphNode N) const {
+FileGraph::edge_iterator FileGraph::edge_end(LargeGraphNode N) const {
   return edge_iterator(convert_le64(outIdx[N]));
 }
 
-FileGraph::GraphNode FileGraph::getEdgeDst(edge_iterator it) const {
-  return convert_le32(outs[*it]);
+FileGraph::LargeGraphNode FileGraph::getEdgeDst(edge_iterator it) const {
+  return getEdgeDstAt(*it);
 }
 
 FileGraph::node_id_iterator FileGraph::node_id_begin() const {
-  return boost::make_transform_iterator(&outs[0], Convert32());
+  return boost::make_transform_iterator(edge_iterator(0), EdgeDst(this));
 }
 
 FileGraph::node_id_iterator FileGraph::node_id_end() const {
-  return boost::make_transform_iterator(&outs[numEdges], Convert32());
+  return boost::make_transform_iterator(edge_iterator(numEdges), EdgeDst(this));
 }
 
 FileGraph::edge_id_iterator FileGraph::edge_id_begin() const {
@@ -301,7 +412,7 @@ FileGraph::edge_id_iterator FileGraph::edge_id_end() const {
   return boost::make_transform_iterator(&outIdx[numNodes], Convert64());
 }
 
-bool FileGraph::hasNeighbor(GraphNode N1, GraphNode N2) const {
+bool FileGraph::hasNeighbor(LargeGraphNode N1, LargeGraphNode N2) const {
   return getEdgeIdx(N1,N2) != ~static_cast<uint64_t>(0);
 }
 
@@ -312,3 +423,37 @@ FileGraph::iterator FileGraph::begin() const {
 FileGraph::iterator FileGraph::end() const {
   return iterator(numNodes);
 }
+
+void FileGraphWriter::phase1() {
+  assert(!outIdx);
+  outIdx = new uint64_t[this->numNodes];
+  ZeroDegrees fn = { outIdx, this->numNodes };
+  detail::fileGraphOnEach(fn);
+}
+
+void FileGraphWriter::phase2() {
+  if (this->numNodes) {
+    // Turn counts into partial sums
+    std::vector<uint64_t> sums(numPrefixBlocks);
+    ScanBlocks scan = { outIdx, this->numNodes, &sums[0] };
+    detail::fileGraphOnEach(scan);
+
+    uint64_t offset = 0;
+    for (uint64_t b = 0; b < numPrefixBlocks; ++b) {
+      uint64_t sum = sums[b];
+      sums[b] = offset;
+      offset += sum;
+    }
+
+    starts = new uint32_t[this->numNodes];
+    OffsetBlocks fix = { outIdx, starts, this->numNodes, &sums[0] };
+    detail::fileGraphOnEach(fix);
+    assert(outIdx[this->numNodes-1] == this->numEdges);
+  }
+
+  // Neighbors are filled in by addNeighbor
+  if (this->numNodes > std::numeric_limits<uint32_t>::max())
+    structureFromArrays(outIdx, this->numNodes, (uint64_t*) 0, this->numEdges, sizeofEdgeData);
+  else
+    structureFromArrays(outIdx, this->numNodes, (uint32_t*) 0, this->numEdges, sizeofEdgeData);
+}
@@ -50,7 +50,7 @@ public:
     if (Galois::Runtime::LL::isPackageLeaderForSelf(tid)) {
       auto r = self->divideBy(
         sizeof(uint64_t),
-        sizeofEdgeData + sizeof(uint32_t),
+        sizeofEdgeData + self->sizeofEdgeDst(),
         Galois::Runtime::LL::getPackageForThread(tid), maxPackages);
       
       size_t edge_begin = *self->edge_begin(*r.first);
@@ -58,7 +58,7 @@ public:
       if (r.first != r.second)
         edge_end = *self->edge_end(*r.second - 1);
       Galois::Runtime::MM::pageIn(self->outIdx + *r.first, std::distance(r.first, r.second) * sizeof(*self->outIdx));
-      Galois::Runtime::MM::pageIn(self->outs + edge_begin, (edge_end - edge_begin) * sizeof(*self->outs));
+      Galois::Runtime::MM::pageIn(static_cast<char*>(self->outs) + edge_begin * self->sizeofEdgeDst(), (edge_end - edge_begin) * self->sizeofEdgeDst());
       Galois::Runtime::MM::pageIn(self->edgeData + edge_begin * sizeofEdgeData, (edge_end - edge_begin) * sizeofEdgeData);
       if (--count == 0) {
         if ((pret_t = pthread_cond_broadcast(&cond)))
@@ -76,6 +76,13 @@ public:
   }
 };
 
+void detail::fileGraphOnEach(const std::function<void(unsigned,unsigned)>& fn) {
+  if (Galois::Runtime::inGaloisForEach)
+    fn(0, 1);
+  else
+    Galois::Runtime::on_each_impl(fn);
+}
+
 void FileGraph::structureFromFileInterleaved(const std::string& filename, size_t sizeofEdgeData) {
   structureFromFile(filename, false);
 
@@ -0,0 +1,116 @@
+/** Nested parallel loops -*- C++ -*-
+ * @file
+ * @section License
+ *
+ * Galois, a framework to exploit amorphous data-parallelism in irregular
+ * programs.
+ *
+ * Copyright (C) 2013, The University of Texas at Austin. All rights reserved.
+ * UNIVERSITY EXPRESSLY DISCLAIMS ANY AND ALL WARRANTIES CONCERNING THIS
+ * SOFTWARE AND DOCUMENTATION, INCLUDING ANY WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR ANY PARTICULAR PURPOSE, NON-INFRINGEMENT AND WARRANTIES OF
+ * PERFORMANCE, AND ANY WARRANTY THAT MIGHT OTHERWISE ARISE FROM COURSE OF
+ * DEALING OR USAGE OF TRADE.  NO WARRANTY IS EITHER EXPRESS OR IMPLIED WITH
+ * RESPECT TO THE USE OF THE SOFTWARE OR DOCUMENTATION. Under no circumstances
+ * shall University be liable for incidental, special, indirect, direct or
+ * consequential damages or loss of profits, interruption of business, or
+ * related expenses which may arise from use of Software or Documentation,
+ * including but not limited to those resulting from defects in Software and/or
+ * Documentation, or loss or inaccuracy of data of any kind.
+ *
+ * @section Description
+ *
+ * Registry of published nested tasks, one slot per thread.
+ *
+ * @author Donald Nguyen <ddn@cs.utexas.edu>
+ */
+
+#include "Galois/Runtime/Nested.h"
+#include "Galois/Runtime/Context.h"
+#include "Galois/Runtime/PerThreadStorage.h"
+#include "Galois/Runtime/ll/CompilerSpecific.h"
+#include "Galois/Runtime/ll/TID.h"
+
+using namespace Galois::Runtime;
+
+namespace {
+
+struct Slot {
+  //! Protects task against being retired while a helper registers itself
+  LL::SimpleLock<true> lock;
+  std::atomic<NestedTask*> task;
+  Slot(): task(0) { }
+};
+
+struct Registry {
+  PerThreadStorage<Slot> slots;
+  //! Number of published tasks, lets idle threads skip scanning the slots
+  std::atomic<unsigned> numTasks;
+  Registry(): numTasks(0) { }
+};
+
+Registry& getRegistry() {
+  static Registry r;
+  return r;
+}
+
+}
+
+void Galois::Runtime::runNested(NestedTask& task) {
+  Registry& r = getRegistry();
+  Slot& s = *r.slots.getLocal();
+  SimpleRuntimeContext* ctx = getThreadContext();
+  setThreadContext(0);
+
+  // A task spawned while running a chunk of another task of this thread
+  // temporarily takes its place
+  s.lock.lock();
+  NestedTask* prev = s.task.load(std::memory_order_relaxed);
+  s.task.store(&task, std::memory_order_release);
+  s.lock.unlock();
+  if (!prev)
+    r.numTasks.fetch_add(1);
+
+  task.run();
+
+  s.lock.lock();
+  s.task.store(prev, std::memory_order_relaxed);
+  s.lock.unlock();
+  if (!prev)
+    r.numTasks.fetch_sub(1);
+
+  // Helpers publish their work on the task when they leave it
+  while (task.helpers.load(std::memory_order_acquire))
+    LL::asmPause();
+
+  setThreadContext(ctx);
+}
+
+bool Galois::Runtime::helpNested() {
+  Registry& r = getRegistry();
+  if (!r.numTasks.load(std::memory_order_relaxed))
+    return false;
+
+  unsigned myID = LL::getTID();
+  for (unsigned x = 1; x < activeThreads; ++x) {
+    Slot& s = *r.slots.getRemote((myID + x) % activeThreads);
+    if (!s.task.load(std::memory_order_relaxed))
+      continue;
+
+    s.lock.lock();
+    NestedTask* task = s.task.load(std::memory_order_acquire);
+    if (task)
+      task->helpers.fetch_add(1, std::memory_order_relaxed);
+    s.lock.unlock();
+    if (!task)
+      continue;
+
+    SimpleRuntimeContext* ctx = getThreadContext();
+    setThreadContext(0);
+    task->run();
+    setThreadContext(ctx);
+    task->helpers.fetch_sub(1, std::memory_order_release);
+    return true;
+  }
+  return false;
+}
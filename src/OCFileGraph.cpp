@@ -27,6 +27,7 @@
 #include "Galois/Runtime/ll/gio.h"
 
 #include <cassert>
+#include <limits>
 
 #include <fcntl.h>
 #include <unistd.h>
@@ -45,6 +46,9 @@ using namespace Galois::Graph;
 //outedges[numEdges] {uint32_t LE}
 //potential padding (32bit max) to Re-Align to 64bits
 //EdgeType[numEdges] {EdgeType size}
+//
+//File format V2 is the same except outedges are {uint64_t LE} and there is
+//no padding
 
 OCFileGraph::~OCFileGraph() {
   if (masterMapping)
@@ -101,28 +105,52 @@ void OCFileGraph::Block::load(int fd, off64_t offset, size_t begin, size_t len,
   m_sizeof_data = sizeof_data;
 }
 
+void OCFileGraph::Block::prefetch(int fd, off64_t offset, size_t begin, size_t len, size_t sizeof_data) {
+  off64_t start = offset + begin * sizeof_data;
+  // Only a hint; failure just means the later load reads synchronously
+  posix_fadvise64(fd, start, len * sizeof_data, POSIX_FADV_WILLNEED);
+}
+
 void OCFileGraph::load(segment_type& s, edge_iterator begin, edge_iterator end, size_t sizeof_data) {
   size_t bb = *begin;
   size_t len = *end - *begin;
   
-  off64_t outs = (4 + numNodes) * sizeof(uint64_t);
-  off64_t data = outs + (numEdges + (numEdges & 1)) * sizeof(uint32_t);
+  off64_t outs = outsOffset();
+  off64_t data = edgeDataOffset();
 
-  s.outs.load(masterFD, outs, bb, len, sizeof(uint32_t));
+  s.outs.load(masterFD, outs, bb, len, sizeofEdgeDst);
   if (sizeof_data)
     s.edgeData.load(masterFD, data, bb, len, sizeof_data);
   
   s.loaded = true;
 }
 
-static void readHeader(int fd, uint64_t& numNodes, uint64_t& numEdges) {
+void OCFileGraph::prefetch(edge_iterator begin, edge_iterator end, size_t sizeof_data) {
+  size_t bb = *begin;
+  size_t len = *end - *begin;
+
+  off64_t outs = outsOffset();
+  off64_t data = edgeDataOffset();
+
+  Block::prefetch(masterFD, outs, bb, len, sizeofEdgeDst);
+  if (sizeof_data)
+    Block::prefetch(masterFD, data, bb, len, sizeof_data);
+}
+
+off64_t OCFileGraph::edgeDataOffset() const {
+  if (sizeofEdgeDst == sizeof(uint32_t))
+    return outsOffset() + (numEdges + (numEdges & 1)) * sizeof(uint32_t);
+  return outsOffset() + numEdges * sizeof(uint64_t);
+}
+
+static void readHeader(int fd, uint64_t& version, uint64_t& numNodes, uint64_t& numEdges) {
   void* m = mmap(0, 4 * sizeof(uint64_t), PROT_READ, MAP_PRIVATE, fd, 0);
   if (m == MAP_FAILED) {
     GALOIS_SYS_DIE("failed reading ", fd);
   }
 
   uint64_t* ptr = reinterpret_cast<uint64_t*>(m);
-  assert(ptr[0] == 1);
+  version = ptr[0];
   numNodes = ptr[2];
   numEdges = ptr[3];
 
@@ -137,7 +165,14 @@ void OCFileGraph::structureFromFile(const std::string& filename) {
     GALOIS_SYS_DIE("failed opening ", filename);
   }
   
-  readHeader(masterFD, numNodes, numEdges);
+  uint64_t version;
+  readHeader(masterFD, version, numNodes, numEdges);
+  if (version != 1 && version != 2)
+    GALOIS_DIE("unknown file version ", version, " in ", filename);
+  if (numNodes > std::numeric_limits<GraphNode>::max())
+    GALOIS_DIE("out-of-core graphs support at most ", std::numeric_limits<GraphNode>::max(),
+        " nodes but ", filename, " has ", numNodes);
+  sizeofEdgeDst = version == 1 ? sizeof(uint32_t) : sizeof(uint64_t);
   masterLength = 4 * sizeof(uint64_t) + numNodes * sizeof(uint64_t);
   int _MAP_BASE = MAP_PRIVATE;
 #ifdef MAP_POPULATE
@@ -87,6 +87,23 @@ public:
     updateMax(Galois::Runtime::activeThreads);
   }
 
+  void addPageAllocStatsToStat() {
+    using Galois::Runtime::MM::PageAllocStats;
+    if (!Galois::Runtime::MM::numPageAllocTotal())
+      return;
+    for (unsigned x = 0; x < Galois::Runtime::activeThreads; ++x) {
+      PageAllocStats s = Galois::Runtime::MM::pageAllocStatsForThread(x);
+      std::map<KeyTy, unsigned long>& M = *Stats.getRemote(x);
+      M[mkKey("(NULL)", "PageCacheHits")] += s.hits;
+      M[mkKey("(NULL)", "PageCacheMisses")] += s.misses;
+      M[mkKey("(NULL)", "PageOSAllocs")] += s.osAllocs;
+      M[mkKey("(NULL)", "PageOSPages")] += s.osPages;
+      M[mkKey("(NULL)", "PageHugePages")] += s.hugePages;
+      M[mkKey("(NULL)", "PageRemoteFrees")] += s.remoteFrees;
+    }
+    updateMax(Galois::Runtime::activeThreads);
+  }
+
   void addNumaAllocToStat(const std::string& loop, const std::string& category) {
     int nodes = Galois::Runtime::MM::numNumaNodes();
     for (int x = 0; x < nodes; ++x)
@@ -150,6 +167,7 @@ void Galois::Runtime::reportStat(Galois::Statistic* value) {
 }
 
 void Galois::Runtime::printStats() {
+  SM.get()->addPageAllocStatsToStat();
   SM.get()->printStats();
 }
 
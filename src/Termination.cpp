@@ -22,7 +22,7 @@
  *
  * @section Description
  *
- * Implementation of Dikstra dual-ring Termination Detection
+ * Implementation of tree variants of Dikstra dual-ring Termination Detection
  *
  * @author Andrew Lenharth <andrewl@lenharth.org>
  */
@@ -30,85 +30,13 @@
 #include "Galois/Runtime/ActiveThreads.h"
 #include "Galois/Runtime/Termination.h"
 #include "Galois/Runtime/ll/CompilerSpecific.h"
+#include "Galois/Runtime/ll/HWTopo.h"
+
+#include <vector>
 
 using namespace Galois::Runtime;
 
 namespace {
-//Dijkstra style 2-pass ring termination detection
-class LocalTerminationDetection : public TerminationDetection {
-  struct TokenHolder {
-    friend class TerminationDetection;
-    volatile long tokenIsBlack;
-    volatile long hasToken;
-    long processIsBlack;
-    bool lastWasWhite; // only used by the master
-  };
-
-  PerThreadStorage<TokenHolder> data;
-  
-  //send token onwards
-  void propToken(bool isBlack) {
-    unsigned id = LL::getTID();
-    TokenHolder& th = *data.getRemote((id + 1) % activeThreads);
-    th.tokenIsBlack = isBlack;
-    LL::compilerBarrier();
-    th.hasToken = true;
-  }
-
-  void propGlobalTerm() {
-    globalTerm.data = true;
-  }
-
-  bool isSysMaster() const {
-    return LL::getTID() == 0;
-  }
-
-public:
-  LocalTerminationDetection() {}
-
-  virtual void initializeThread() {
-    TokenHolder& th = *data.getLocal();
-    th.hasToken = false;
-    th.tokenIsBlack = false;
-    th.processIsBlack = true;
-    th.lastWasWhite = true;
-    globalTerm.data = false;
-    if (isSysMaster()) {
-      th.hasToken = true;
-    }
-  }
-
-  virtual void localTermination(bool workHappened) {
-    assert(!(workHappened && globalTerm.data));
-    TokenHolder& th = *data.getLocal();
-    th.processIsBlack |= workHappened;
-    if (th.hasToken) {
-      if (isSysMaster()) {
-	bool failed = th.tokenIsBlack || th.processIsBlack;
-	th.tokenIsBlack = th.processIsBlack = false;
-	if (th.lastWasWhite && !failed) {
-	  //This was the second success
-	  propGlobalTerm();
-	  return;
-	}
-	th.lastWasWhite = !failed;
-      }
-      //Normal thread or recirc by master
-      assert (!globalTerm.data && "no token should be in progress after globalTerm");
-      bool taint = th.processIsBlack || th.tokenIsBlack;
-      th.processIsBlack = th.tokenIsBlack = false;
-      th.hasToken = false;
-      propToken(taint);
-    }
-  }
-};
-
-static LocalTerminationDetection& getLocalTermination() {
-  static LocalTerminationDetection term;
-  return term;
-}
-
-
 //Dijkstra style 2-pass tree termination detection
 class TreeTerminationDetection : public TerminationDetection {
   static const int num = 2;
@@ -221,10 +149,130 @@ static TreeTerminationDetection& getTreeTermination() {
   return term;
 }
 
+/**
+ * Dijkstra style 2-pass tree termination detection whose tree follows the
+ * package structure of the machine. Package leaders are the children of
+ * thread 0, and the other threads of a package are children of their
+ * leader, so a wave crosses between packages only once in each direction.
+ * A thread that receives the token while idle answers it in the same call,
+ * so threads that go idle together finish a wave without further rounds.
+ */
+class HierarchicalTerminationDetection : public TerminationDetection {
+  struct TokenHolder {
+    //! Set by the parent to start a wave
+    volatile long downToken;
+    //! Color reported to the parent; -1 while the wave is in progress
+    volatile long upToken;
+    long processIsBlack;
+    bool hasToken;
+    bool lastWasWhite; // only used by the master
+    unsigned numChildren;
+    unsigned builtFor;
+    std::vector<TokenHolder*> children;
+    TokenHolder(): builtFor(0) { }
+  };
+
+  PerThreadStorage<TokenHolder> data;
+
+  static unsigned parentOf(unsigned tid) {
+    return LL::isPackageLeader(tid) ? 0 : LL::getLeaderForThread(tid);
+  }
+
+  //! Tree only depends on the number of threads, so rebuild it lazily
+  void buildChildren(TokenHolder& th) {
+    unsigned myID = LL::getTID();
+    if (th.builtFor == activeThreads)
+      return;
+    th.children.clear();
+    for (unsigned i = 1; i < activeThreads; ++i) {
+      if (parentOf(i) == myID)
+        th.children.push_back(data.getRemote(i));
+    }
+    th.numChildren = th.children.size();
+    th.builtFor = activeThreads;
+  }
+
+  void processToken(TokenHolder& th) {
+    //received a down token, propagate
+    if (th.downToken) {
+      th.downToken = false;
+      th.hasToken = true;
+      for (unsigned i = 0; i < th.numChildren; ++i) {
+        th.children[i]->upToken = -1;
+        LL::compilerBarrier();
+        th.children[i]->downToken = true;
+      }
+    }
+
+    if (!th.hasToken)
+      return;
+
+    //have all up tokens?
+    bool black = th.processIsBlack;
+    for (unsigned i = 0; i < th.numChildren; ++i) {
+      long up = th.children[i]->upToken;
+      if (up == -1)
+        return;
+      black |= up;
+    }
+
+    //Have the tokens, propagate
+    th.processIsBlack = false;
+    th.hasToken = false;
+    if (isSysMaster()) {
+      if (th.lastWasWhite && !black) {
+        //This was the second success
+        propGlobalTerm();
+        return;
+      }
+      th.lastWasWhite = !black;
+      th.downToken = true;
+    } else {
+      th.upToken = black;
+    }
+  }
+
+  void propGlobalTerm() {
+    globalTerm.data = true;
+  }
+
+  bool isSysMaster() const {
+    return LL::getTID() == 0;
+  }
+
+public:
+  HierarchicalTerminationDetection() {}
+
+  virtual void initializeThread() {
+    TokenHolder& th = *data.getLocal();
+    buildChildren(th);
+    th.downToken = false;
+    th.upToken = -1;
+    th.processIsBlack = true;
+    th.hasToken = false;
+    th.lastWasWhite = false;
+    globalTerm.data = false;
+    if (isSysMaster()) {
+      th.downToken = true;
+    }
+  }
+
+  virtual void localTermination(bool workHappened) {
+    assert(!(workHappened && globalTerm.data));
+    TokenHolder& th = *data.getLocal();
+    th.processIsBlack |= workHappened;
+    processToken(th);
+  }
+};
+
+static HierarchicalTerminationDetection& getHierarchicalTermination() {
+  static HierarchicalTerminationDetection term;
+  return term;
+}
+
 } // namespace
 
 Galois::Runtime::TerminationDetection& Galois::Runtime::getSystemTermination() {
-  return getLocalTermination();
-  //return getTreeTermination();
+  return getHierarchicalTermination();
 }
 
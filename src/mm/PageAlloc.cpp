@@ -20,6 +20,14 @@
  *
  * @section Description
  *
+ * Each thread keeps a cache of free pages as a lock-free stack. Any thread
+ * may push a page back to the stack of the thread that obtained it from the
+ * OS, so pages stay on the NUMA node that first touched them. Threads not
+ * started by the runtime share thread id 0 and so pop from the same stack,
+ * which is why the stack head carries an ABA tag. The owner of a page is found in a
+ * two-level table indexed by page address, which is only written when pages
+ * are first obtained from the OS.
+ *
  * @author Andrew Lenharth <andrewl@lenharth.org>
  */
 
@@ -28,9 +36,8 @@
 #include "Galois/Runtime/ll/StaticInstance.h"
 
 #include <sys/mman.h>
-#include <map>
+#include <stdint.h>
 #include <vector>
-#include <numeric>
 
 // mmap flags
 static const int _PROT = PROT_READ | PROT_WRITE;
@@ -47,66 +54,173 @@ namespace {
 struct FreeNode {
   FreeNode* next;
 };
- 
-typedef Galois::Runtime::LL::PtrLock<FreeNode, true> HeadPtr;
-typedef Galois::Runtime::LL::CacheLineStorage<HeadPtr> HeadPtrStorage;
+
+//! Most pages obtained from the OS by one refill
+static const unsigned maxRefill = 4;
+
+/**
+ * Stack head: a free page address with a modification count in the low
+ * bits, which are otherwise zero because pages are pageSize aligned.
+ * Bumping the count on every update keeps a pop from succeeding against a
+ * head that was popped and pushed again in between (ABA).
+ */
+typedef uintptr_t TaggedHead;
+static const uintptr_t tagMask = Galois::Runtime::MM::pageSize - 1;
+
+struct ThreadState {
+  volatile TaggedHead head;
+  //! Pages per refill; a hint, so racing updates only change its growth
+  volatile unsigned refill;
+  //! Updated atomically since threads sharing an id share this state
+  Galois::Runtime::MM::PageAllocStats stats;
+  ThreadState(): head(0), refill(1), stats() { }
+};
 
 // Tracks pages allocated
 struct PAState {
-  std::vector<int> counts;
-  std::map<void*, HeadPtr*> ownerMap;
-  PAState() { 
-    counts.resize(Galois::Runtime::LL::getMaxThreads(), 0);
-  }
+  std::vector<Galois::Runtime::LL::CacheLineStorage<ThreadState> > threads;
+  //! Set once huge page mappings fail so that they are not tried again
+  volatile bool noHuge;
+  PAState(): threads(Galois::Runtime::LL::getMaxThreads()), noHuge(false) { }
 };
 
 static Galois::Runtime::LL::StaticInstance<PAState> PA;
 
+/**
+ * Maps page numbers (address / pageSize) to owning thread id + 1. Covers
+ * 48-bit virtual addresses; leaves are allocated on first use.
+ */
+static const unsigned leafBits = 14;
+static const unsigned rootBits = 48 - 21 - leafBits;
+static uint16_t* volatile ownerTable[1 << rootBits];
+
 #ifdef __linux__
 #define DoAllocLock true
 #else
 #define DoAllocLock false
 #endif
 static Galois::Runtime::LL::SimpleLock<DoAllocLock> allocLock;
-static Galois::Runtime::LL::SimpleLock<true> dataLock;
-static __thread HeadPtr* head = 0;
 
-void* allocFromOS() {
-  //linux mmap can introduce unbounded sleep!
-  allocLock.lock();
+uint16_t& ownerOf(void* page) {
+  uintptr_t n = reinterpret_cast<uintptr_t>(page) / Galois::Runtime::MM::pageSize;
+  uintptr_t r = n >> leafBits;
+  assert(r < (1 << rootBits));
+  uint16_t* leaf = ownerTable[r];
+  if (!leaf) {
+    uint16_t* l = static_cast<uint16_t*>(calloc(1 << leafBits, sizeof(*l)));
+    if (!l)
+      GALOIS_SYS_DIE("Out of Memory");
+    if (__sync_bool_compare_and_swap(&ownerTable[r], (uint16_t*) 0, l))
+      leaf = l;
+    else {
+      free(l);
+      leaf = ownerTable[r];
+    }
+  }
+  return leaf[n & ((1 << leafBits) - 1)];
+}
+
+ThreadState& getThread(unsigned tid) {
+  return PA.get()->threads[tid].data;
+}
+
+FreeNode* untag(TaggedHead h) {
+  return reinterpret_cast<FreeNode*>(h & ~tagMask);
+}
+
+TaggedHead retag(FreeNode* n, TaggedHead old) {
+  return reinterpret_cast<uintptr_t>(n) | ((old + 1) & tagMask);
+}
 
+void addStat(unsigned long& stat, unsigned long v) {
+  __sync_fetch_and_add(&stat, v);
+}
+
+void push(ThreadState& t, void* m) {
+  FreeNode* nh = reinterpret_cast<FreeNode*>(m);
+  TaggedHead h;
+  do {
+    h = t.head;
+    nh->next = untag(h);
+  } while (!__sync_bool_compare_and_swap(&t.head, h, retag(nh, h)));
+}
+
+//! Pages are never returned to the OS, so reading next from a page that
+//! another thread popped first is safe; the tag makes the CAS fail then
+void* pop(ThreadState& t) {
+  TaggedHead h;
+  FreeNode* n;
+  do {
+    h = t.head;
+    n = untag(h);
+    if (!n)
+      return 0;
+  } while (!__sync_bool_compare_and_swap(&t.head, h, retag(n->next, h)));
+  return n;
+}
+
+//! Maps num pages, all pageSize aligned
+void* mapPages(size_t num, bool& huge) {
+  PAState& p = *PA.get();
+  size_t len = num * Galois::Runtime::MM::pageSize;
   void* ptr = 0;
+  huge = false;
+
+  //linux mmap can introduce unbounded sleep!
+  allocLock.lock();
 #ifdef MAP_HUGETLB
   //First try huge
-  ptr = mmap(0, Galois::Runtime::MM::pageSize, _PROT, _MAP_HUGE_POP, -1, 0);
+  if (!p.noHuge) {
+    ptr = mmap(0, len, _PROT, _MAP_HUGE_POP, -1, 0);
+    if (!ptr || ptr == MAP_FAILED)
+      p.noHuge = true;
+    else
+      huge = true;
+  }
 #endif
-
-  //FIXME: improve failure case to ensure pageSize alignment
-#ifdef MAP_POPULATE
-  //Then try populate
-  if (!ptr || ptr == MAP_FAILED)
-    ptr = mmap(0, Galois::Runtime::MM::pageSize, _PROT, _MAP_POP, -1, 0);
+  //Then map one extra page and trim the ends to get alignment, which lets
+  //the kernel back the pages with transparent huge pages
+  if (!huge) {
+    size_t extra = len + Galois::Runtime::MM::pageSize;
+    char* base = static_cast<char*>(mmap(0, extra, _PROT, _MAP_BASE, -1, 0));
+    if (!base || base == MAP_FAILED) {
+      allocLock.unlock();
+      GALOIS_SYS_DIE("Out of Memory");
+    }
+    uintptr_t mask = Galois::Runtime::MM::pageSize - 1;
+    char* aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(base) + mask) & ~mask);
+    if (aligned != base)
+      munmap(base, aligned - base);
+    if (base + extra != aligned + len)
+      munmap(aligned + len, base + extra - (aligned + len));
+    ptr = aligned;
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, len, MADV_HUGEPAGE);
 #endif
-  //Then try normal
-  if (!ptr || ptr == MAP_FAILED) {
-    ptr = mmap(0, Galois::Runtime::MM::pageSize, _PROT, _MAP_BASE, -1, 0);
   }
-  
   allocLock.unlock();
-  if (!ptr || ptr == MAP_FAILED) {
-    GALOIS_SYS_DIE("Out of Memory");
-  }
 
-  //protect the tracking structures
-  dataLock.lock();
-  HeadPtr*& h = head;
-  if (!h) { //first allocation
-    h = &((new HeadPtrStorage())->data);
+  if (!huge) {
+    // Prefault by writing, as MAP_POPULATE would
+    volatile char* c = static_cast<volatile char*>(ptr);
+    for (size_t i = 0; i < len; i += Galois::Runtime::MM::smallPageSize)
+      c[i] = 0;
   }
-  PAState& p = *PA.get();
-  p.ownerMap[ptr] = h;
-  p.counts[Galois::Runtime::LL::getTID()] += 1;
-  dataLock.unlock();
+  return ptr;
+}
+
+//! Obtains num pages from the OS for thread tid
+char* allocFromOS(unsigned tid, size_t num) {
+  bool huge;
+  char* ptr = static_cast<char*>(mapPages(num, huge));
+
+  ThreadState& t = getThread(tid);
+  addStat(t.stats.osAllocs, 1);
+  addStat(t.stats.osPages, num);
+  if (huge)
+    addStat(t.stats.hugePages, num);
+  for (size_t i = 0; i < num; ++i)
+    ownerOf(ptr + i * Galois::Runtime::MM::pageSize) = tid + 1;
   return ptr;
 }
 
@@ -119,42 +233,58 @@ void Galois::Runtime::MM::pageIn(void* buf, size_t len) {
 }
 
 void* Galois::Runtime::MM::pageAlloc() {
-  HeadPtr* phead = head;
-  if (phead) {
-    phead->lock();
-    FreeNode* h = phead->getValue();
-    if (h) {
-      phead->unlock_and_set(h->next);
-      return h;
-    }
-    phead->unlock();
+  unsigned tid = LL::getTID();
+  ThreadState& t = getThread(tid);
+  void* m = pop(t);
+  if (m) {
+    addStat(t.stats.hits, 1);
+    return m;
   }
-  return allocFromOS();
+
+  // Refill with exponentially more pages while the thread keeps missing
+  addStat(t.stats.misses, 1);
+  size_t num = t.refill;
+  if (num < maxRefill)
+    t.refill = num * 2;
+  char* ptr = allocFromOS(tid, num);
+  for (size_t i = 1; i < num; ++i)
+    push(t, ptr + i * pageSize);
+  return ptr;
 }
 
 void Galois::Runtime::MM::pageFree(void* m) {
-  dataLock.lock();
-  HeadPtr* phead = PA.get()->ownerMap[m];
-  dataLock.unlock();
-  assert(phead);
-  phead->lock();
-  FreeNode* nh = reinterpret_cast<FreeNode*>(m);
-  nh->next = phead->getValue();
-  phead->unlock_and_set(nh);
+  unsigned owner = ownerOf(m);
+  assert(owner);
+  unsigned tid = LL::getTID();
+  if (owner - 1 != tid)
+    addStat(getThread(tid).stats.remoteFrees, 1);
+  push(getThread(owner - 1), m);
 }
 
 void Galois::Runtime::MM::pagePreAlloc(int numPages) {
-  while (numPages--)
-    Galois::Runtime::MM::pageFree(allocFromOS());
+  if (numPages <= 0)
+    return;
+  unsigned tid = LL::getTID();
+  char* ptr = allocFromOS(tid, numPages);
+  ThreadState& t = getThread(tid);
+  for (int i = 0; i < numPages; ++i)
+    push(t, ptr + i * pageSize);
 }
 
 int Galois::Runtime::MM::numPageAllocTotal() {
   PAState& p = *PA.get();
-  return std::accumulate(p.counts.begin(), p.counts.end(), 0);
+  int total = 0;
+  for (unsigned i = 0; i < p.threads.size(); ++i)
+    total += p.threads[i].data.stats.osPages;
+  return total;
 }
 
 int Galois::Runtime::MM::numPageAllocForThread(unsigned tid) {
-  return PA.get()->counts[tid];
+  return getThread(tid).stats.osPages;
+}
+
+Galois::Runtime::MM::PageAllocStats Galois::Runtime::MM::pageAllocStatsForThread(unsigned tid) {
+  return getThread(tid).stats;
 }
 
 void* Galois::Runtime::MM::largeAlloc(size_t len, bool preFault) {
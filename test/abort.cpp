@@ -0,0 +1,151 @@
+#include "Galois/Timer.h"
+#include "Galois/Galois.h"
+#include "Galois/Runtime/Context.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+const unsigned numItems = 1 << 16;
+const unsigned neighborhood = 4;
+const unsigned depth = 8;
+
+//! Context that owns a lock for the duration of the test so that every
+//! iteration that touches it conflicts
+struct HoldingContext: public Galois::Runtime::SimpleRuntimeContext {
+  void hold(Galois::Runtime::Lockable* l) { acquire(l); }
+};
+
+struct State {
+  std::vector<Galois::Runtime::Lockable> locks;
+  std::vector<char> tried;
+  Galois::Runtime::Lockable held;
+  State(): locks(numItems * neighborhood), tried(numItems) { }
+};
+
+//! Acquires the neighborhood of an item from a few frames deep, the first
+//! time through also acquiring the held lock
+template<bool Cooperative>
+struct Process {
+  typedef int tt_does_not_need_push;
+
+  State* s;
+  Process(State* _s): s(_s) { }
+
+  void visit(unsigned item, unsigned level) {
+    if (level) {
+      visit(item, level - 1);
+      return;
+    }
+    for (unsigned i = 0; i < neighborhood; ++i)
+      Galois::Runtime::acquire(&s->locks[item * neighborhood + i], Galois::MethodFlag::ALL);
+    if (!s->tried[item]) {
+      s->tried[item] = 1;
+      Galois::Runtime::acquire(&s->held, Galois::MethodFlag::ALL);
+    }
+  }
+
+  void operator()(unsigned item, Galois::UserContext<unsigned>& ctx) {
+    visit(item, depth);
+    if (Cooperative && ctx.isConflicted())
+      return;
+    s->tried[item] = 2;
+  }
+};
+
+namespace Galois {
+template<>
+struct needs_cooperative_aborts<Process<true> >: public boost::true_type { };
+}
+
+//! Runs iterations the way the executor does so that abort latency can be
+//! measured even when for_each skips conflict detection (e.g., one thread)
+template<bool Cooperative>
+unsigned long latency(State& s, bool conflicts) {
+  std::fill(s.tried.begin(), s.tried.end(), conflicts ? 0 : 1);
+  Galois::Runtime::SimpleRuntimeContext ctx;
+  ctx.setCooperativeAborts(Cooperative);
+  Galois::Runtime::setThreadContext(&ctx);
+  Process<Cooperative> fn(&s);
+
+  Galois::Timer t;
+  t.start();
+  for (unsigned item = 0; item < numItems; ++item) {
+    ctx.startIteration();
+    if (Cooperative) {
+      fn.visit(item, depth);
+    } else {
+#ifdef GALOIS_USE_LONGJMP
+      if (setjmp(Galois::Runtime::hackjmp) == 0)
+        fn.visit(item, depth);
+      else
+        Galois::Runtime::clearReleasable();
+#else
+      try {
+        fn.visit(item, depth);
+      } catch (Galois::Runtime::ConflictFlag const&) {
+        Galois::Runtime::clearReleasable();
+      }
+#endif
+    }
+    ctx.cancelIteration();
+  }
+  t.stop();
+
+  Galois::Runtime::setThreadContext(0);
+  return t.get_usec();
+}
+
+//! Runs the loop through for_each and checks that every item committed
+template<bool Cooperative>
+bool run(State& s) {
+  std::fill(s.tried.begin(), s.tried.end(), 0);
+  Galois::for_each(boost::counting_iterator<unsigned>(0), boost::counting_iterator<unsigned>(numItems),
+      Process<Cooperative>(&s));
+  return std::count(s.tried.begin(), s.tried.end(), 2) == numItems;
+}
+
+template<bool Cooperative>
+bool t_abort(const char* name) {
+  State s;
+  HoldingContext holder;
+  holder.hold(&s.held);
+
+  std::cout << name << ":\n";
+
+  // Warm up
+  latency<Cooperative>(s, true);
+  unsigned long base = latency<Cooperative>(s, false);
+  unsigned long withAborts = latency<Cooperative>(s, true);
+  std::cout << "Latency(" << numItems << " aborts): " << withAborts
+    << " us, no aborts: " << base
+    << " us, ns per abort: " << ((double) withAborts - base) * 1e3 / numItems << "\n";
+
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    Galois::Timer t;
+    t.start();
+    bool eq = run<Cooperative>(s);
+    t.stop();
+    std::cout << "Galois(" << numItems << "): " << t.get() << " Equal: " << eq << "\n";
+    ok &= eq;
+
+    M >>= 1;
+  }
+
+  holder.commitIteration();
+  return ok;
+}
+
+int main() {
+  int ret = 0;
+  ret |= t_abort<false>("signal") ? 0 : 1;
+  ret |= t_abort<true>("cooperative") ? 0 : 1;
+  return ret;
+}
@@ -0,0 +1,114 @@
+#include "Galois/Galois.h"
+#include "Galois/Accumulator.h"
+#include "Galois/Graph/FileGraph.h"
+#include "Galois/Graph/LCGraph.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+typedef Galois::Graph::LC_CSR_Graph<int,void> Graph;
+typedef Graph::GraphNode GNode;
+typedef Galois::Runtime::EdgeBalancedRange<Graph> Range;
+
+//! Power-law-ish graph: a few hubs, many small nodes and some nodes without
+//! edges
+void makeGraph(Graph& graph) {
+  const size_t numNodes = 1 << 12;
+  std::vector<uint64_t> outIdx(numNodes);
+  std::vector<uint32_t> outs;
+  for (size_t i = 0; i < numNodes; ++i) {
+    size_t degree;
+    if (i % 1024 == 1)
+      degree = numNodes * 4;
+    else if (i % 3 == 0)
+      degree = 0;
+    else
+      degree = rand() % 8;
+    for (size_t j = 0; j < degree; ++j)
+      outs.push_back(rand() % numNodes);
+    outIdx[i] = outs.size();
+  }
+
+  Galois::Graph::FileGraph g;
+  g.structureFromArrays<void>(&outIdx[0], numNodes, &outs[0], outs.size());
+  Galois::Graph::readGraph(graph, g);
+}
+
+//! Checks that the parts for each number of threads cover every edge once and
+//! every node at least once, and that the work of each part is balanced
+bool checkParts(Graph& graph, bool split) {
+  Range range(graph, split);
+  size_t numWork = graph.size() + graph.sizeEdges();
+
+  for (unsigned total = 1; total <= 64; total *= 2) {
+    std::vector<unsigned> nodes(graph.size());
+    std::vector<unsigned> edges(graph.sizeEdges());
+    size_t maxWork = 0;
+    for (unsigned tid = 0; tid < total; ++tid) {
+      std::pair<Range::iterator, Range::iterator> p = range.thread_pair(tid, total);
+      size_t work = 0;
+      for (; p.first != p.second; ++p.first) {
+        Galois::Runtime::EdgeRangeItem<Graph> item = *p.first;
+        nodes[item.node] += 1;
+        work += 1;
+        for (Graph::edge_iterator ii = item.begin; ii != item.end; ++ii) {
+          edges[*ii] += 1;
+          work += 1;
+        }
+        if (split && item.begin == item.end && graph.edge_begin(item.node) != graph.edge_end(item.node))
+          return false;
+      }
+      maxWork = std::max(maxWork, work);
+    }
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+      if (nodes[i] == 0 || (!split && nodes[i] != 1))
+        return false;
+    }
+    for (size_t i = 0; i < edges.size(); ++i) {
+      if (edges[i] != 1)
+        return false;
+    }
+    // Split parts may repeat a node unit at each boundary
+    if (split && maxWork > numWork / total + 2)
+      return false;
+    std::cout << (split ? "edges" : "balanced") << " parts: " << total
+      << " max work: " << maxWork << " ideal: " << numWork / total << "\n";
+  }
+  return true;
+}
+
+struct CountNodes {
+  Galois::GAccumulator<size_t>& nodes;
+  void operator()(GNode n) { nodes += 1; }
+};
+
+struct CountEdges {
+  Galois::GAccumulator<size_t>& edges;
+  void operator()(GNode n, Graph::edge_iterator ii, Graph::edge_iterator ei) {
+    edges += std::distance(ii, ei);
+  }
+};
+
+int main() {
+  Graph graph;
+  makeGraph(graph);
+
+  bool ok = checkParts(graph, false) && checkParts(graph, true);
+
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  while (ok && M) {
+    Galois::setActiveThreads(M);
+    Galois::GAccumulator<size_t> nodes, edges;
+    CountNodes cn = { nodes };
+    CountEdges ce = { edges };
+    Galois::do_all_balanced(graph, cn);
+    Galois::do_all_edges(graph, ce);
+    ok = nodes.reduce() == graph.size() && edges.reduce() == graph.sizeEdges();
+    std::cout << "Using " << M << " threads Equal: " << ok << "\n";
+    M >>= 1;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+#include "Galois/Galois.h"
+#include "Galois/Graph/FileGraph.h"
+#include "Galois/Graph/LCGraph.h"
+#include "Galois/Graph/OCGraph.h"
+#include "Galois/Timer.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unistd.h>
+
+typedef Galois::Graph::FileGraph::GraphNode GNode;
+typedef std::pair<GNode,GNode> Edge;
+
+struct CountDegree {
+  Galois::Graph::FileGraphWriter& g;
+  void operator()(const Edge& e) const { g.incrementDegree(e.first); }
+};
+
+struct AddNeighbor {
+  Galois::Graph::FileGraphWriter& g;
+  void operator()(const Edge& e) const { g.addNeighbor(e.first, e.second); }
+};
+
+std::vector<GNode> sortedNeighbors(Galois::Graph::FileGraph& g, GNode n) {
+  std::vector<GNode> v(g.neighbor_begin(n), g.neighbor_end(n));
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+bool sameGraph(Galois::Graph::FileGraph& a, Galois::Graph::FileGraph& b) {
+  if (a.size() != b.size() || a.sizeEdges() != b.sizeEdges())
+    return false;
+  for (Galois::Graph::FileGraph::iterator ii = a.begin(), ei = a.end(); ii != ei; ++ii) {
+    if (sortedNeighbors(a, *ii) != sortedNeighbors(b, *ii))
+      return false;
+  }
+  return true;
+}
+
+int do_writer() {
+  const size_t numNodes = 1 << 16;
+  const size_t numEdges = numNodes * 16;
+
+  std::vector<Edge> edges;
+  for (size_t i = 0; i < numEdges; ++i)
+    edges.push_back(Edge(rand() % numNodes, rand() % numNodes));
+
+  Galois::Graph::FileGraph expected;
+  {
+    Galois::Graph::FileGraphWriter g;
+    g.setNumNodes(numNodes);
+    g.setNumEdges(numEdges);
+    g.setSizeofEdgeData(0);
+    g.phase1();
+    for (std::vector<Edge>::iterator ii = edges.begin(), ei = edges.end(); ii != ei; ++ii)
+      g.incrementDegree(ii->first);
+    g.phase2();
+    for (std::vector<Edge>::iterator ii = edges.begin(), ei = edges.end(); ii != ei; ++ii)
+      g.addNeighbor(ii->first, ii->second);
+    g.finish<void>();
+    expected.swap(g);
+  }
+
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  std::cout << "writer:\n";
+
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    Galois::Timer t;
+    t.start();
+    Galois::Graph::FileGraphWriter g;
+    g.setNumNodes(numNodes);
+    g.setNumEdges(numEdges);
+    g.setSizeofEdgeData(0);
+    g.phase1();
+    CountDegree count = { g };
+    Galois::do_all(edges.begin(), edges.end(), count);
+    g.phase2();
+    AddNeighbor add = { g };
+    Galois::do_all(edges.begin(), edges.end(), add);
+    g.finish<void>();
+    t.stop();
+
+    bool eq = sameGraph(expected, g);
+    std::cout << "Galois: " << t.get() << " Equal: " << eq << "\n";
+    if (!eq)
+      return 1;
+
+    M >>= 1;
+  }
+
+  return 0;
+}
+
+//! Checks that every edge of a appears in b with its endpoints mapped by p.
+//! Edge data only depends on the endpoints so multi-edges are not ambiguous.
+template<typename PTy>
+bool checkMapped(Galois::Graph::FileGraph& a, Galois::Graph::FileGraph& b, const PTy& p, bool reverse) {
+  for (Galois::Graph::FileGraph::iterator ii = a.begin(), ei = a.end(); ii != ei; ++ii) {
+    for (Galois::Graph::FileGraph::edge_iterator jj = a.edge_begin(*ii), ej = a.edge_end(*ii); jj != ej; ++jj) {
+      GNode src = p[*ii];
+      GNode dst = p[a.getEdgeDst(jj)];
+      if (reverse)
+        std::swap(src, dst);
+      if (!b.hasNeighbor(src, dst))
+        return false;
+      if (b.getEdgeData<int>(src, dst) != a.getEdgeData<int>(jj))
+        return false;
+    }
+  }
+  return true;
+}
+
+//! Checks that two graphs have the same edges, data and neighbor order
+bool sameOrder(Galois::Graph::FileGraph& a, Galois::Graph::FileGraph& b) {
+  if (a.size() != b.size() || a.sizeEdges() != b.sizeEdges())
+    return false;
+  for (Galois::Graph::FileGraph::iterator ii = a.begin(), ei = a.end(); ii != ei; ++ii) {
+    if (*a.edge_begin(*ii) != *b.edge_begin(*ii) || *a.edge_end(*ii) != *b.edge_end(*ii))
+      return false;
+    for (Galois::Graph::FileGraph::edge_iterator jj = a.edge_begin(*ii), ej = a.edge_end(*ii); jj != ej; ++jj) {
+      if (a.getEdgeDst(jj) != b.getEdgeDst(jj) || a.getEdgeData<int>(jj) != b.getEdgeData<int>(jj))
+        return false;
+    }
+  }
+  return true;
+}
+
+//! Transposes a graph with a serial pass, which fixes the order of neighbors
+void serialTranspose(Galois::Graph::FileGraph& g, Galois::Graph::FileGraph& out) {
+  Galois::Graph::FileGraphWriter w;
+  w.setNumNodes(g.size());
+  w.setNumEdges(g.sizeEdges());
+  w.setSizeofEdgeData(sizeof(int));
+  w.phase1();
+  for (Galois::Graph::FileGraph::iterator ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
+    for (Galois::Graph::FileGraph::edge_iterator jj = g.edge_begin(*ii), ej = g.edge_end(*ii); jj != ej; ++jj)
+      w.incrementDegree(g.getEdgeDst(jj));
+  }
+  w.phase2();
+  int* data = w.edge_data_begin<int>();
+  for (Galois::Graph::FileGraph::iterator ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
+    for (Galois::Graph::FileGraph::edge_iterator jj = g.edge_begin(*ii), ej = g.edge_end(*ii); jj != ej; ++jj)
+      data[w.addNeighbor(g.getEdgeDst(jj), *ii)] = g.getEdgeData<int>(jj);
+  }
+  w.finish<int>();
+  out.swap(w);
+}
+
+struct Identity {
+  GNode operator[](GNode n) const { return n; }
+};
+
+int do_transforms() {
+  const size_t numNodes = 1 << 14;
+  const size_t numEdges = numNodes * 16;
+
+  Galois::Graph::FileGraph g;
+  {
+    Galois::Graph::FileGraphWriter w;
+    w.setNumNodes(numNodes);
+    w.setNumEdges(numEdges);
+    w.setSizeofEdgeData(sizeof(int));
+    w.phase1();
+    std::vector<Edge> edges;
+    for (size_t i = 0; i < numEdges; ++i) {
+      edges.push_back(Edge(rand() % numNodes, rand() % numNodes));
+      w.incrementDegree(edges.back().first);
+    }
+    w.phase2();
+    int* data = w.edge_data_begin<int>();
+    for (size_t i = 0; i < numEdges; ++i)
+      data[w.addNeighbor(edges[i].first, edges[i].second)] = (edges[i].first + edges[i].second) % 1000;
+    w.finish<int>();
+    g.swap(w);
+  }
+
+  std::vector<GNode> perm;
+  for (size_t i = 0; i < numNodes; ++i)
+    perm.push_back(i);
+  std::random_shuffle(perm.begin(), perm.end());
+
+  Galois::Graph::FileGraph expectedTrans;
+  serialTranspose(g, expectedTrans);
+  Galois::Graph::FileGraph firstSym, firstPerm;
+
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  std::cout << "transforms:\n";
+
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    Galois::Graph::FileGraph sym, trans, perm_g;
+    Galois::Timer t;
+    t.start();
+    Galois::Graph::makeSymmetric<int>(g, sym);
+    Galois::Graph::transpose<int>(g, trans);
+    Galois::Graph::permute<int>(g, perm, perm_g);
+    t.stop();
+
+    bool eq = sym.sizeEdges() == 2 * numEdges
+      && checkMapped(g, sym, Identity(), false)
+      && checkMapped(g, sym, Identity(), true)
+      && trans.sizeEdges() == numEdges
+      && checkMapped(g, trans, Identity(), true)
+      && perm_g.sizeEdges() == numEdges
+      && checkMapped(g, perm_g, perm, false);
+    // Neighbor order does not depend on the number of threads
+    if (firstSym.size()) {
+      eq = eq && sameOrder(firstSym, sym) && sameOrder(firstPerm, perm_g);
+    } else {
+      firstSym.swap(sym);
+      firstPerm.swap(perm_g);
+    }
+    eq = eq && sameOrder(expectedTrans, trans);
+    std::cout << "Galois: " << t.get() << " Equal: " << eq << "\n";
+    if (!eq)
+      return 1;
+
+    M >>= 1;
+  }
+
+  return 0;
+}
+
+//! Checks that a graph with 64-bit destinations survives a round trip to
+//! disk and into an LC_CSR_Graph with 64-bit node ids
+int do_version2() {
+  const uint64_t numNodes = 1 << 10;
+  const uint64_t numEdges = numNodes * 4;
+
+  std::vector<uint64_t> outIdx(numNodes);
+  std::vector<uint64_t> outs(numEdges);
+  for (uint64_t i = 0; i < numNodes; ++i)
+    outIdx[i] = (i + 1) * 4;
+  for (uint64_t i = 0; i < numEdges; ++i)
+    outs[i] = rand() % numNodes;
+
+  Galois::Graph::FileGraph g;
+  int* data = g.structureFromArrays<int>(&outIdx[0], numNodes, &outs[0], numEdges);
+  for (uint64_t i = 0; i < numEdges; ++i)
+    data[i] = i;
+
+  std::string filename("filegraph-v2.gr");
+  g.structureToFile(filename);
+
+  Galois::Graph::FileGraph f;
+  f.structureFromFile(filename);
+
+  typedef Galois::Graph::LC_CSR_Graph<int,int>::with_node_id<uint64_t>::type Graph;
+  Graph lc;
+  Galois::Graph::readGraph(lc, filename);
+
+  typedef Galois::Graph::OCImmutableEdgeGraph<int,int> OCGraph;
+  OCGraph oc;
+  Galois::Graph::readGraph(oc, filename);
+  OCGraph::segment_type seg = oc.nextSegment(numEdges);
+  oc.load(seg);
+  unlink(filename.c_str());
+
+  bool eq = g.version() == 2 && f.version() == 2 && lc.size() == numNodes && lc.sizeEdges() == numEdges;
+  for (uint64_t i = 0; eq && i < numNodes; ++i) {
+    Graph::edge_iterator jj = lc.edge_begin(i);
+    for (Galois::Graph::FileGraph::edge_iterator ii = f.edge_begin(i), ei = f.edge_end(i); ii != ei; ++ii, ++jj) {
+      eq = eq && f.getEdgeDst(ii) == outs[*ii] && lc.getEdgeDst(jj) == outs[*ii];
+      eq = eq && f.getEdgeData<int>(ii) == (int) *ii && lc.getEdgeData(jj) == (int) *ii;
+    }
+    for (OCGraph::edge_iterator ii = oc.edge_begin(seg, i), ei = oc.edge_end(seg, i); ii != ei; ++ii)
+      eq = eq && oc.getEdgeDst(seg, ii) == outs[*ii] && oc.getEdgeData(seg, ii) == (int) *ii;
+  }
+  oc.unload(seg);
+
+  // Sorting a version 2 graph moves 64-bit destinations with their data
+  for (uint64_t i = 0; i < numNodes; ++i)
+    g.sortEdgesByEdgeData<int>(i, std::greater<int>());
+  for (uint64_t i = 0; eq && i < numNodes; ++i) {
+    for (Galois::Graph::FileGraph::edge_iterator ii = g.edge_begin(i), ei = g.edge_end(i); ii != ei; ++ii) {
+      int d = g.getEdgeData<int>(ii);
+      eq = eq && g.getEdgeDst(ii) == outs[d];
+      eq = eq && (ii + 1 == ei || d > g.getEdgeData<int>(ii + 1));
+    }
+  }
+
+  std::cout << "version2: Equal: " << eq << "\n";
+  return eq ? 0 : 1;
+}
+
+//! Checks that a compressed graph has the same neighbors and edge data as the
+//! graph it was built from
+template<typename Graph>
+bool sameCompressed(Galois::Graph::FileGraph& g, Graph& c) {
+  if (g.size() != c.size() || g.sizeEdges() != c.sizeEdges())
+    return false;
+  for (Galois::Graph::FileGraph::iterator ii = g.begin(), ei = g.end(); ii != ei; ++ii) {
+    std::vector<std::pair<GNode,int> > expected, actual;
+    for (Galois::Graph::FileGraph::edge_iterator jj = g.edge_begin(*ii), ej = g.edge_end(*ii); jj != ej; ++jj)
+      expected.push_back(std::make_pair(g.getEdgeDst(jj), g.getEdgeData<int>(jj)));
+    for (typename Graph::edge_iterator jj = c.edge_begin(*ii), ej = c.edge_end(*ii); jj != ej; ++jj)
+      actual.push_back(std::make_pair(c.getEdgeDst(jj), c.getEdgeData(jj)));
+    std::sort(expected.begin(), expected.end());
+    if (expected != actual)
+      return false;
+  }
+  return true;
+}
+
+int do_compressed() {
+  const size_t numNodes = 1 << 14;
+  const size_t numEdges = numNodes * 16;
+
+  Galois::Graph::FileGraph g;
+  {
+    Galois::Graph::FileGraphWriter w;
+    w.setNumNodes(numNodes);
+    w.setNumEdges(numEdges);
+    w.setSizeofEdgeData(sizeof(int));
+    w.phase1();
+    std::vector<Edge> edges;
+    for (size_t i = 0; i < numEdges; ++i) {
+      // Mix of near and far neighbors to exercise all value lengths
+      GNode src = rand() % numNodes;
+      GNode dst = i % 2 ? (src + rand() % 16) % numNodes : rand() % numNodes;
+      edges.push_back(Edge(src, dst));
+      w.incrementDegree(src);
+    }
+    w.phase2();
+    int* data = w.edge_data_begin<int>();
+    for (size_t i = 0; i < numEdges; ++i)
+      data[w.addNeighbor(edges[i].first, edges[i].second)] = (edges[i].first + edges[i].second) % 1000;
+    w.finish<int>();
+    g.swap(w);
+  }
+
+  typedef Galois::Graph::LC_Compressed_Graph<int,int> Graph;
+  Graph fromGraph;
+  Galois::Graph::readGraph(fromGraph, g);
+
+  std::string filename("filegraph-compressed.cgr");
+  Galois::Graph::writeCompressedGraph<int>(g, filename);
+  // Each thread copies its part of the file
+  Galois::setActiveThreads(Galois::Runtime::LL::getMaxThreads());
+  Graph fromFile;
+  Galois::Graph::readGraph(fromFile, filename);
+  Graph::with_numa_alloc<true>::type fromFileLocal;
+  Galois::Graph::readGraph(fromFileLocal, filename);
+  unlink(filename.c_str());
+
+  bool eq = sameCompressed(g, fromGraph) && sameCompressed(g, fromFile) && sameCompressed(g, fromFileLocal)
+    && fromGraph.sizeEdgeBytes() == fromFile.sizeEdgeBytes();
+  std::cout << "compressed: Bytes per edge: " << fromGraph.sizeEdgeBytes() / (double) numEdges
+    << " Equal: " << eq << "\n";
+  return eq ? 0 : 1;
+}
+
+int main() {
+  int ret = 0;
+  ret |= do_writer();
+  ret |= do_transforms();
+  ret |= do_version2();
+  ret |= do_compressed();
+  return ret;
+}
@@ -0,0 +1,114 @@
+#include "Galois/Galois.h"
+#include "Galois/Graph/Graph.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <vector>
+
+const unsigned numNodes = 1000;
+
+//! Checks the edges of a hub node against a reference set of destinations
+template<typename Graph>
+bool same(Graph& g, typename Graph::GraphNode hub, const std::vector<typename Graph::GraphNode>& nodes, const std::set<unsigned>& ref) {
+  std::set<unsigned> found;
+  size_t count = 0;
+  for (typename Graph::edge_iterator ii = g.edge_begin(hub), ei = g.edge_end(hub); ii != ei; ++ii, ++count)
+    found.insert(g.getData(g.getEdgeDst(ii)));
+  if (count != ref.size() || found != ref)
+    return false;
+  for (unsigned i = 0; i < numNodes; ++i) {
+    bool has = g.findEdge(hub, nodes[i]) != g.edge_end(hub);
+    if (has != (ref.count(i) > 0))
+      return false;
+  }
+  return true;
+}
+
+template<bool Directed>
+bool run() {
+  typedef Galois::Graph::FirstGraph<unsigned, int, Directed> Graph;
+  typedef typename Graph::GraphNode GNode;
+
+  Graph g;
+  std::vector<GNode> nodes;
+  for (unsigned i = 0; i < numNodes; ++i) {
+    nodes.push_back(g.createNode(i));
+    g.addNode(nodes.back());
+  }
+  GNode hub = g.createNode(numNodes);
+  g.addNode(hub);
+
+  std::set<unsigned> ref;
+  bool ok = true;
+  srand(0);
+  for (unsigned round = 0; round < 8; ++round) {
+    // Adding an existing edge is a no-op
+    for (unsigned i = 0; i < numNodes / 2; ++i) {
+      unsigned n = rand() % numNodes;
+      if (!g.containsNode(nodes[n]))
+        continue;
+      g.getEdgeData(g.addEdge(hub, nodes[n])) = n;
+      ref.insert(n);
+    }
+    ok &= same(g, hub, nodes, ref);
+
+    for (unsigned i = 0; i < numNodes / 8; ++i) {
+      unsigned n = rand() % numNodes;
+      typename Graph::edge_iterator ii = g.findEdge(hub, nodes[n]);
+      if (ii == g.edge_end(hub))
+        continue;
+      ok &= g.getEdgeData(ii) == (int) n;
+      g.removeEdge(hub, ii);
+      ref.erase(n);
+    }
+    ok &= same(g, hub, nodes, ref);
+
+    // Removing the edge from the other end keeps the order of the hub's edges
+    if (!Directed) {
+      std::vector<unsigned> order;
+      for (typename Graph::edge_iterator ii = g.edge_begin(hub), ei = g.edge_end(hub); ii != ei; ++ii)
+        order.push_back(g.getData(g.getEdgeDst(ii)));
+      for (unsigned i = 0; i < numNodes / 8; ++i) {
+        unsigned n = rand() % numNodes;
+        if (!g.containsNode(nodes[n]))
+          continue;
+        typename Graph::edge_iterator ii = g.findEdge(nodes[n], hub);
+        if (ii == g.edge_end(nodes[n]))
+          continue;
+        g.removeEdge(nodes[n], ii);
+        ref.erase(n);
+        order.erase(std::find(order.begin(), order.end(), n));
+      }
+      std::vector<unsigned> after;
+      for (typename Graph::edge_iterator ii = g.edge_begin(hub), ei = g.edge_end(hub); ii != ei; ++ii)
+        after.push_back(g.getData(g.getEdgeDst(ii)));
+      ok &= after == order;
+      ok &= same(g, hub, nodes, ref);
+    }
+
+    // Edges to removed nodes become tombstones that later insertions compact
+    for (unsigned i = 0; i < numNodes / 64; ++i) {
+      unsigned n = rand() % numNodes;
+      if (!g.containsNode(nodes[n]))
+        continue;
+      g.removeNode(nodes[n]);
+      ref.erase(n);
+    }
+    ok &= same(g, hub, nodes, ref);
+  }
+
+  if (!Directed) {
+    for (std::set<unsigned>::iterator ii = ref.begin(), ei = ref.end(); ii != ei; ++ii)
+      ok &= g.findEdge(nodes[*ii], hub) != g.edge_end(nodes[*ii]);
+  }
+  return ok;
+}
+
+int main() {
+  bool directed = run<true>();
+  bool undirected = run<false>();
+  std::cout << "directed: " << directed << " undirected: " << undirected << "\n";
+  return directed && undirected ? 0 : 1;
+}
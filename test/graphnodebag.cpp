@@ -0,0 +1,79 @@
+#include "Galois/Galois.h"
+#include "Galois/Graph/GraphNodeBag.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+const size_t numNodes = 1 << 16;
+
+//! Every node is pushed several times by different items
+struct Push {
+  Galois::GraphNodeBag<>& bag;
+  bool bitOnly;
+  void operator()(size_t i) {
+    size_t n = (i * 7) % numNodes;
+    if (n % 3 == 0)
+      return;
+    if (bitOnly)
+      bag.pushBit(n, 1);
+    else
+      bag.pushDense(n, 1);
+  }
+};
+
+//! Checks that the bag holds exactly the nodes not divisible by 3
+bool check(Galois::GraphNodeBag<>& bag) {
+  std::vector<size_t> nodes(bag.begin(), bag.end());
+  std::sort(nodes.begin(), nodes.end());
+  size_t expected = numNodes - (numNodes + 2) / 3;
+  if (nodes.size() != expected || bag.getSize() != expected || bag.getCount() != 2 * expected)
+    return false;
+  if (std::adjacent_find(nodes.begin(), nodes.end()) != nodes.end())
+    return false;
+  for (size_t n = 0; n < numNodes; ++n) {
+    if (bag.contains(n) != (n % 3 != 0))
+      return false;
+  }
+  return true;
+}
+
+int main() {
+  Galois::GraphNodeBag<> bag(numNodes);
+  typedef boost::counting_iterator<size_t> Iter;
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+
+  while (M) {
+    Galois::setActiveThreads(M);
+
+    bag.densify();
+    Push pushDense = { bag, false };
+    Galois::do_all(Iter(0), Iter(4 * numNodes), pushDense);
+    bool dense = check(bag);
+    bag.clear();
+
+    bag.densify();
+    Push pushBit = { bag, true };
+    Galois::do_all(Iter(0), Iter(4 * numNodes), pushBit);
+    bag.sparsify();
+    bool sparse = check(bag);
+    bag.clear();
+
+    bag.densify();
+    bool cleared = bag.empty();
+    for (size_t n = 0; n < numNodes; ++n)
+      cleared &= !bag.contains(n);
+    bag.clear();
+
+    std::cout << "Using " << M << " threads pushDense: " << dense
+      << " pushBit: " << sparse << " cleared: " << cleared << "\n";
+    ok &= dense && sparse && cleared;
+
+    M >>= 1;
+  }
+
+  return ok ? 0 : 1;
+}
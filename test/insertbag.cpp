@@ -0,0 +1,64 @@
+#include "Galois/Galois.h"
+#include "Galois/Bag.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+const unsigned numItems = 1 << 18;
+const unsigned numParts = 7;
+
+typedef Galois::InsertBag<unsigned> Bag;
+
+struct Count {
+  std::vector<unsigned>& counts;
+  void operator()(unsigned i) { __sync_fetch_and_add(&counts[i], 1); }
+  void operator()(unsigned i, Galois::UserContext<unsigned>&) { (*this)(i); }
+};
+
+bool once(const std::vector<unsigned>& counts) {
+  return std::count(counts.begin(), counts.end(), 1) == (ptrdiff_t) counts.size();
+}
+
+int main() {
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  Galois::setActiveThreads(M);
+
+  // Pushed by one thread, so the thread-local ranges of the bag are as
+  // skewed as possible
+  Bag bag;
+  for (unsigned i = 0; i < numItems; ++i)
+    bag.push(i);
+
+  // Parts of the range for any number of threads cover every item once and
+  // differ in size by at most a chunk
+  Bag::ChunkedRange range = bag.chunked_range();
+  std::vector<unsigned> counts(numItems);
+  size_t minSize = numItems, maxSize = 0;
+  for (unsigned tid = 0; tid < numParts; ++tid) {
+    std::pair<Bag::ChunkedRange::iterator, Bag::ChunkedRange::iterator> p = range.thread_pair(tid, numParts);
+    size_t size = std::distance(p.first, p.second);
+    minSize = std::min(minSize, size);
+    maxSize = std::max(maxSize, size);
+    for (; p.first != p.second; ++p.first)
+      counts[*p.first] += 1;
+  }
+  size_t perChunk = (numItems + range.num_chunks() - 1) / range.num_chunks();
+  bool parts = once(counts) && maxSize - minSize <= 2 * perChunk
+    && (size_t) std::distance(range.begin(), range.end()) == numItems;
+
+  std::fill(counts.begin(), counts.end(), 0);
+  Count count = { counts };
+  Galois::do_all_chunked(bag, count);
+  bool doall = once(counts);
+
+  std::fill(counts.begin(), counts.end(), 0);
+  Galois::for_each_chunked(bag, count);
+  bool foreach = once(counts);
+
+  Bag empty;
+  bool none = empty.chunked_range().begin() == empty.chunked_range().end();
+
+  std::cout << "parts: " << parts << " do_all: " << doall << " for_each: " << foreach << " empty: " << none << "\n";
+  return parts && doall && foreach && none ? 0 : 1;
+}
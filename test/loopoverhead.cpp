@@ -1,5 +1,6 @@
 #include "Galois/Timer.h"
 #include "Galois/Galois.h"
+#include "Galois/Accumulator.h"
 
 #include <iostream>
 #include <cstdlib>
@@ -78,9 +79,100 @@ void t_foreach() {
   }
 }
 
+struct sum {
+  unsigned long value;
+  sum(): value(0) { }
+  void operator()(unsigned x) { value += x; }
+  void operator()(sum& lhs, sum& rhs) { lhs.value += rhs.value; }
+};
+
+bool t_doall_reduce() {
+  std::vector<unsigned> V(1024, 1);
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+
+  std::cout << "doall reduce:\nIterxSize\n";
+
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    Galois::Timer t;
+    t.start();
+    for (unsigned x = 0; x < iter; ++x) {
+      sum s = Galois::Runtime::do_all_impl(Galois::Runtime::makeStandardRange(V.begin(), V.end()), sum(), sum());
+      ok &= s.value == V.size();
+    }
+    t.stop();
+
+    std::cout << "Galois(" << iter << "x" << V.size() << "): " << t.get() << "\n";
+
+    M >>= 1;
+  }
+  return ok;
+}
+
+template<typename AccumTy, typename T>
+struct update {
+  AccumTy& accum;
+  const T& one;
+  void operator()(unsigned, unsigned) { accum.update(one); }
+};
+
+template<typename AccumTy, typename T>
+bool t_reduce(const char* name, const T& one, bool (*check)(const T&, unsigned)) {
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+
+  std::cout << name << ":\nIter\n";
+
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    AccumTy accum;
+    update<AccumTy,T> u = { accum, one };
+    Galois::Timer serial;
+    serial.start();
+    for (unsigned x = 0; x < iter; ++x) {
+      Galois::on_each(u);
+      ok &= check(accum.reduceSerial(), (x + 1) * M);
+    }
+    serial.stop();
+    accum.reset();
+
+    Galois::Timer tree;
+    tree.start();
+    for (unsigned x = 0; x < iter; ++x) {
+      Galois::on_each(u);
+      ok &= check(accum.reduceParallel(), (x + 1) * M);
+    }
+    tree.stop();
+
+    std::cout << "Serial(" << iter << "): " << serial.get() << "\n";
+    std::cout << "Tree(" << iter << "): " << tree.get() << "\n";
+
+    M >>= 1;
+  }
+  return ok;
+}
+
+typedef Galois::GAccumulator<unsigned> ScalarAccum;
+typedef Galois::GReducible<std::vector<unsigned>,
+  Galois::ReduceVectorWrap<Galois::ReduceAssignWrap<std::plus<unsigned> > > > VectorAccum;
+
+bool checkScalar(const unsigned& v, unsigned expected) { return v == expected; }
+
+bool checkVector(const std::vector<unsigned>& v, unsigned expected) {
+  return v.size() == 64 && v[0] == expected && v[63] == expected;
+}
+
 int main() {
   t_stl();
   t_doall();
   t_foreach();
-  return 0;
+  bool ok = t_doall_reduce();
+  ok &= t_reduce<ScalarAccum>("reduce scalar", 1u, checkScalar);
+  ok &= t_reduce<VectorAccum>("reduce vector", std::vector<unsigned>(64, 1), checkVector);
+  return ok ? 0 : 1;
 }
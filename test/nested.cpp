@@ -0,0 +1,162 @@
+#include "Galois/Galois.h"
+#include "Galois/Timer.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <iostream>
+#include <vector>
+
+const unsigned numOuter = 64;
+const unsigned numInner = 1 << 12;
+
+typedef boost::counting_iterator<unsigned> Iter;
+
+struct Inner {
+  std::vector<unsigned>& counts;
+  unsigned outer;
+  Inner(std::vector<unsigned>& c, unsigned o): counts(c), outer(o) { }
+  void operator()(unsigned i) const {
+    __sync_fetch_and_add(&counts[outer * numInner + i], 1);
+  }
+};
+
+//! Expands the implicit binary tree over [0, numInner) from its root
+struct InnerPush {
+  typedef int tt_does_not_need_aborts;
+
+  std::vector<unsigned>& counts;
+  unsigned outer;
+  InnerPush(std::vector<unsigned>& c, unsigned o): counts(c), outer(o) { }
+  void operator()(unsigned i, Galois::UserContext<unsigned>& ctx) const {
+    __sync_fetch_and_add(&counts[outer * numInner + i], 1);
+    for (unsigned c = 2 * i + 1; c <= 2 * i + 2 && c < numInner; ++c)
+      ctx.push(c);
+  }
+};
+
+//! Counts the items each copy sees; copies are combined by Sum
+struct InnerCount {
+  unsigned count;
+  InnerCount(): count(0) { }
+  void operator()(unsigned) { ++count; }
+};
+
+struct Sum {
+  void operator()(InnerCount& a, const InnerCount& b) const { a.count += b.count; }
+};
+
+//! Spawns a nested for_each from every iteration
+struct OuterForEach {
+  typedef int tt_does_not_need_aborts;
+  typedef int tt_does_not_need_push;
+
+  std::vector<unsigned>& counts;
+  OuterForEach(std::vector<unsigned>& c): counts(c) { }
+
+  void operator()(unsigned outer, Galois::UserContext<unsigned>&) const {
+    Galois::for_each(0U, InnerPush(counts, outer));
+  }
+};
+
+//! Spawns a nested do_all with a reduction from every iteration
+struct OuterReduce {
+  typedef int tt_does_not_need_aborts;
+  typedef int tt_does_not_need_push;
+
+  std::vector<unsigned>& counts;
+  OuterReduce(std::vector<unsigned>& c): counts(c) { }
+
+  void operator()(unsigned outer, Galois::UserContext<unsigned>&) const {
+    InnerCount r = Galois::Runtime::do_all_impl(Galois::Runtime::makeStandardRange(Iter(0), Iter(numInner)),
+        InnerCount(), Sum(), 0, false, true);
+    counts[outer] = r.count;
+  }
+};
+
+//! Spawns a nested loop from every iteration; some outer iterations spawn a
+//! loop that itself spawns loops
+struct Outer {
+  typedef int tt_does_not_need_aborts;
+  typedef int tt_does_not_need_push;
+
+  std::vector<unsigned>& counts;
+  Outer(std::vector<unsigned>& c): counts(c) { }
+
+  void operator()(unsigned outer) const {
+    if (outer % 8 == 0) {
+      Galois::do_all(Iter(0), Iter(1), Outer2(counts, outer), Galois::do_all_nested(true));
+    } else {
+      Galois::do_all(Iter(0), Iter(numInner), Inner(counts, outer), Galois::do_all_nested(true));
+    }
+  }
+
+  void operator()(unsigned outer, Galois::UserContext<unsigned>&) const {
+    (*this)(outer);
+  }
+
+  struct Outer2 {
+    std::vector<unsigned>& counts;
+    unsigned outer;
+    Outer2(std::vector<unsigned>& c, unsigned o): counts(c), outer(o) { }
+    void operator()(unsigned) const {
+      Galois::do_all(Iter(0), Iter(numInner), Inner(counts, outer), Galois::do_all_nested(true));
+    }
+  };
+};
+
+bool check(std::vector<unsigned>& counts) {
+  bool ok = true;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    ok &= counts[i] == 1;
+    counts[i] = 0;
+  }
+  return ok;
+}
+
+int main() {
+  std::vector<unsigned> counts(numOuter * numInner);
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    Galois::Timer t;
+    t.start();
+    Galois::do_all(Iter(0), Iter(numOuter), Outer(counts));
+    t.stop();
+    bool eq = check(counts);
+    std::cout << "do_all: " << t.get() << " Equal: " << eq << "\n";
+    ok &= eq;
+
+    t.start();
+    Galois::for_each(Iter(0), Iter(numOuter), Outer(counts));
+    t.stop();
+    eq = check(counts);
+    std::cout << "for_each: " << t.get() << " Equal: " << eq << "\n";
+    ok &= eq;
+
+    t.start();
+    Galois::for_each(Iter(0), Iter(numOuter), OuterForEach(counts));
+    t.stop();
+    eq = check(counts);
+    std::cout << "nested for_each: " << t.get() << " Equal: " << eq << "\n";
+    ok &= eq;
+
+    t.start();
+    Galois::for_each(Iter(0), Iter(numOuter), OuterReduce(counts));
+    t.stop();
+    eq = true;
+    for (unsigned i = 0; i < numOuter; ++i) {
+      eq &= counts[i] == numInner;
+      counts[i] = 0;
+    }
+    std::cout << "nested reduce: " << t.get() << " Equal: " << eq << "\n";
+    ok &= eq;
+
+    M >>= 1;
+  }
+
+  return ok ? 0 : 1;
+}
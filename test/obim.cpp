@@ -0,0 +1,81 @@
+#include "Galois/Galois.h"
+#include "Galois/WorkList/WorkList.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+//! Number of bins ever constructed by any OBIM in this test
+static unsigned binsCreated = 0;
+
+//! FIFO that counts its instances
+template<typename T = int, bool Concurrent = true>
+struct CountedFIFO: public Galois::WorkList::FIFO<T, Concurrent> {
+  template<bool _concurrent>
+  struct rethread { typedef CountedFIFO<T, _concurrent> type; };
+
+  template<typename _T>
+  struct retype { typedef CountedFIFO<_T, Concurrent> type; };
+
+  CountedFIFO() { ++binsCreated; }
+};
+
+struct Indexer {
+  int operator()(int i) const { return i; }
+};
+
+typedef Galois::WorkList::OrderedByIntegerMetric<Indexer, CountedFIFO<> > OBIM;
+
+//! Moves through many indices, one live bin at a time; drained bins should
+//! be reused rather than allocated anew
+bool checkRecycle() {
+  const int numIndices = 10000;
+  binsCreated = 0;
+  bool ok = true;
+  {
+    OBIM wl;
+    for (int i = 0; i < numIndices; ++i) {
+      wl.push(i);
+      Galois::optional<int> p = wl.pop();
+      ok &= p && *p == i;
+    }
+    ok &= !wl.pop();
+  }
+  std::cout << "recycle: " << binsCreated << " bins for " << numIndices << " indices\n";
+  return ok && binsCreated < 8;
+}
+
+//! Pushes many indices at once; returns true if every item comes out once
+//! and sets bins to the number of bins created
+template<typename WL>
+bool pushAll(int numIndices, unsigned& bins) {
+  binsCreated = 0;
+  std::vector<int> seen(numIndices);
+  {
+    WL wl;
+    for (int i = numIndices - 1; i >= 0; --i)
+      wl.push(i);
+    Galois::optional<int> p;
+    while ((p = wl.pop()))
+      seen[*p] += 1;
+  }
+  bins = binsCreated;
+  return std::count(seen.begin(), seen.end(), 1) == numIndices;
+}
+
+//! Live bins beyond MaxBins merge indices into wider bins
+bool checkCap() {
+  const int numIndices = 1024;
+  unsigned unbounded, capped;
+  bool ok = pushAll<OBIM>(numIndices, unbounded);
+  ok &= pushAll<OBIM::with_max_bins<8>::type>(numIndices, capped);
+  std::cout << "cap: " << unbounded << " bins without cap, " << capped << " bins with cap 8\n";
+  return ok && unbounded == (unsigned) numIndices && capped < (unsigned) numIndices / 8;
+}
+
+int main() {
+  bool ok = true;
+  ok &= checkRecycle();
+  ok &= checkCap();
+  return ok ? 0 : 1;
+}
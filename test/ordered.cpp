@@ -0,0 +1,127 @@
+#include "Galois/Galois.h"
+#include "Galois/Accumulator.h"
+#include "Galois/Graph/Graph.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+const unsigned numTasks = 4096;
+const unsigned nhoodSize = 4;
+const unsigned endTime = 64;
+
+typedef Galois::Graph::FirstGraph<unsigned,void,true> Graph;
+typedef Graph::GraphNode GNode;
+
+//! A task repeatedly updates the same nodes at increasing times
+struct Task {
+  unsigned id;
+  unsigned time;
+};
+
+struct Cmp {
+  bool operator()(const Task& a, const Task& b) const {
+    return a.time < b.time || (a.time == b.time && a.id < b.id);
+  }
+};
+
+//! Leaves tasks at the same time unordered
+struct TimeLess {
+  bool operator()(const Task& a, const Task& b) const { return a.time < b.time; }
+};
+
+//! Less than or equal comparator, as allowed by for_each_ordered
+struct TimeLessEqual {
+  bool operator()(const Task& a, const Task& b) const { return a.time <= b.time; }
+};
+
+struct Problem {
+  Graph graph;
+  std::vector<GNode> nodes;
+  std::vector<unsigned> nhoods;
+  std::vector<unsigned> steps;
+  Galois::GAccumulator<unsigned> errors;
+  Galois::GAccumulator<unsigned> iterations;
+};
+
+template<bool Fixed>
+struct NhoodVisit;
+
+template<>
+struct NhoodVisit<false> {
+  Problem* p;
+  template<typename C>
+  void operator()(const Task& t, C&) {
+    for (unsigned i = 0; i < nhoodSize; ++i)
+      p->graph.getData(p->nodes[p->nhoods[t.id * nhoodSize + i]]);
+  }
+};
+
+template<>
+struct NhoodVisit<true>: public NhoodVisit<false> {
+  typedef int tt_has_fixed_neighborhood;
+};
+
+//! Checks that each node sees tasks in order and reschedules the task
+struct Process {
+  Problem* p;
+  void operator()(const Task& t, Galois::UserContext<Task>& ctx) {
+    p->iterations += 1;
+    for (unsigned i = 0; i < nhoodSize; ++i) {
+      unsigned& last = p->graph.getData(p->nodes[p->nhoods[t.id * nhoodSize + i]], Galois::MethodFlag::NONE);
+      if (last > t.time)
+        p->errors += 1;
+      last = t.time;
+    }
+    Task next = { t.id, t.time + p->steps[t.id] };
+    if (next.time < endTime)
+      ctx.push(next);
+  }
+};
+
+//! Tasks start at times below maxStart and touch nodes below numNodes
+template<bool Fixed, typename C>
+bool run(unsigned numNodes, unsigned maxStart) {
+  Problem p;
+  for (unsigned i = 0; i < numNodes; ++i) {
+    p.nodes.push_back(p.graph.createNode(0));
+    p.graph.addNode(p.nodes.back());
+  }
+
+  srand(0);
+  std::vector<Task> initial;
+  unsigned expected = 0;
+  for (unsigned i = 0; i < numTasks; ++i) {
+    for (unsigned j = 0; j < nhoodSize; ++j)
+      p.nhoods.push_back(rand() % numNodes);
+    p.steps.push_back(1 + rand() % 8);
+    Task t = { i, static_cast<unsigned>(rand()) % maxStart };
+    initial.push_back(t);
+    expected += (endTime - t.time + p.steps[i] - 1) / p.steps[i];
+  }
+
+  NhoodVisit<Fixed> nhVisit;
+  nhVisit.p = &p;
+  Process process = { &p };
+  Galois::for_each_ordered(initial.begin(), initial.end(), C(), nhVisit, process);
+
+  return p.errors.reduce() == 0 && p.iterations.reduce() == expected;
+}
+
+int main() {
+  bool ok = true;
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  while (M) {
+    Galois::setActiveThreads(M);
+    bool fixed = run<true, Cmp>(1024, 8);
+    bool twoPhase = run<false, Cmp>(1024, 8);
+    // Overlapping neighborhoods with many equal keys
+    bool fixedTies = run<true, TimeLess>(256, 1) && run<true, TimeLessEqual>(256, 1);
+    bool twoPhaseTies = run<false, TimeLess>(1024, 1);
+    std::cout << "Using " << M << " threads, fixed: " << fixed << " two-phase: " << twoPhase
+      << " fixed with ties: " << fixedTies << " two-phase with ties: " << twoPhaseTies << "\n";
+    ok &= fixed && twoPhase && fixedTies && twoPhaseTies;
+    M >>= 1;
+  }
+  return ok ? 0 : 1;
+}
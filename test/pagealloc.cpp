@@ -0,0 +1,123 @@
+#include "Galois/Galois.h"
+#include "Galois/Runtime/mm/Mem.h"
+
+#include <pthread.h>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+
+using namespace Galois::Runtime::MM;
+
+const unsigned numPages = 16;
+
+typedef std::vector<std::vector<void*> > Pages;
+
+//! Each thread allocates pages and marks them with its id
+struct Alloc {
+  Pages& pages;
+  void operator()(unsigned tid, unsigned) {
+    for (unsigned i = 0; i < numPages; ++i) {
+      void* p = pageAlloc();
+      *static_cast<unsigned*>(p) = tid;
+      pages[tid].push_back(p);
+    }
+  }
+};
+
+//! Each thread frees the pages of the next thread
+struct Free {
+  Pages& pages;
+  void operator()(unsigned tid, unsigned total) {
+    std::vector<void*>& v = pages[(tid + 1) % total];
+    for (unsigned i = 0; i < v.size(); ++i)
+      pageFree(v[i]);
+  }
+};
+
+//! Checks that no page was handed out twice and that marks were not clobbered
+bool check(Pages& pages, unsigned M) {
+  std::vector<void*> all;
+  bool ok = true;
+  for (unsigned t = 0; t < M; ++t) {
+    for (unsigned i = 0; i < pages[t].size(); ++i)
+      ok &= *static_cast<unsigned*>(pages[t][i]) == t;
+    all.insert(all.end(), pages[t].begin(), pages[t].end());
+  }
+  std::sort(all.begin(), all.end());
+  return ok && std::adjacent_find(all.begin(), all.end()) == all.end();
+}
+
+const unsigned churnRounds = 20000;
+const unsigned churnPages = 4;
+
+//! Allocates, marks, checks and frees pages; returns false if a mark was clobbered
+bool churn(unsigned mark) {
+  bool ok = true;
+  void* p[churnPages];
+  for (unsigned r = 0; r < churnRounds; ++r) {
+    for (unsigned i = 0; i < churnPages; ++i) {
+      p[i] = pageAlloc();
+      *static_cast<unsigned*>(p[i]) = mark;
+    }
+    for (unsigned i = 0; i < churnPages; ++i) {
+      ok &= *static_cast<unsigned*>(p[i]) == mark;
+      pageFree(p[i]);
+    }
+  }
+  return ok;
+}
+
+void* churnForeign(void* ok) {
+  *static_cast<bool*>(ok) = churn(~0U);
+  return 0;
+}
+
+//! A thread not started by the runtime shares thread id 0 with the main thread
+bool checkForeignThread() {
+  PageAllocStats before = pageAllocStatsForThread(0);
+  bool foreignOk = false;
+  pthread_t t;
+  pthread_create(&t, 0, churnForeign, &foreignOk);
+  bool ok = churn(0);
+  pthread_join(t, 0);
+  PageAllocStats s = pageAllocStatsForThread(0);
+  unsigned long allocs = (s.hits - before.hits) + (s.misses - before.misses);
+  return ok && foreignOk && allocs == 2 * churnRounds * churnPages;
+}
+
+int main() {
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  Galois::setActiveThreads(M);
+  Pages pages(M);
+
+  Alloc alloc = { pages };
+  Free freeNext = { pages };
+  Galois::on_each(alloc);
+  bool first = check(pages, M);
+  Galois::on_each(freeNext);
+
+  std::vector<PageAllocStats> before(M);
+  for (unsigned t = 0; t < M; ++t) {
+    before[t] = pageAllocStatsForThread(t);
+    pages[t].clear();
+  }
+
+  // Freed pages went back to their owners, so these allocations all hit
+  Galois::on_each(alloc);
+  bool second = check(pages, M);
+  bool hits = true;
+  unsigned long remote = 0;
+  for (unsigned t = 0; t < M; ++t) {
+    PageAllocStats s = pageAllocStatsForThread(t);
+    hits &= s.hits - before[t].hits == numPages && s.osPages == before[t].osPages;
+    remote += s.remoteFrees;
+  }
+  bool remoteOk = remote == (M > 1 ? M * numPages : 0);
+  Galois::on_each(freeNext);
+  bool foreign = checkForeignThread();
+
+  std::cout << "Using " << M << " threads unique: " << (first && second)
+    << " hits: " << hits << " remote frees: " << remoteOk
+    << " foreign thread: " << foreign << "\n";
+  return first && second && hits && remoteOk && foreign ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#include "Galois/Galois.h"
+#include "Galois/Graph/FileGraph.h"
+#include "Galois/Graph/LCGraph.h"
+#include "Galois/Graph/PropertyMap.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <vector>
+
+const size_t numNodes = 1 << 12;
+
+void makeGraph(Galois::Graph::FileGraph& g) {
+  std::vector<uint64_t> outIdx(numNodes);
+  std::vector<uint32_t> outs;
+  for (size_t i = 0; i < numNodes; ++i) {
+    size_t degree = rand() % 8;
+    for (size_t j = 0; j < degree; ++j)
+      outs.push_back(rand() % numNodes);
+    outIdx[i] = outs.size();
+  }
+  g.structureFromArrays<void>(&outIdx[0], numNodes, &outs[0], outs.size());
+}
+
+//! Counts in-degrees into a property map
+template<typename Graph>
+struct InDegree {
+  typedef Galois::Graph::NodePropertyMap<Graph, unsigned> Map;
+  Graph& graph;
+  Map& degree;
+  void operator()(typename Graph::GraphNode n) {
+    for (typename Graph::edge_iterator ii = graph.edge_begin(n), ei = graph.edge_end(n); ii != ei; ++ii)
+      __sync_fetch_and_add(&degree[graph.getEdgeDst(ii)], 1);
+  }
+};
+
+template<typename Graph>
+bool check(Galois::Graph::FileGraph& file) {
+  typedef typename InDegree<Graph>::Map Map;
+  Graph graph;
+  Galois::Graph::readGraph(graph, file);
+
+  std::vector<unsigned> expected(graph.size());
+  for (typename Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii)
+    for (typename Graph::edge_iterator jj = graph.edge_begin(*ii), ej = graph.edge_end(*ii); jj != ej; ++jj)
+      expected[graph.idFromNode(graph.getEdgeDst(jj))] += 1;
+
+  Map degree(graph, 0);
+  InDegree<Graph> fn = { graph, degree };
+  Galois::do_all_local(graph, fn);
+  bool ok = degree.size() == graph.size() && std::equal(degree.begin(), degree.end(), expected.begin());
+
+  // Reattach after detaching and after filling
+  degree.detach();
+  ok &= !degree.isAttached();
+  degree.attach(graph, 7);
+  for (typename Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii)
+    ok &= degree[*ii] == 7;
+  degree.fill(0);
+  Galois::do_all_local(graph, fn);
+  ok &= std::equal(degree.begin(), degree.end(), expected.begin());
+  return ok;
+}
+
+int main() {
+  Galois::Graph::FileGraph file;
+  makeGraph(file);
+  Galois::setActiveThreads(Galois::Runtime::LL::getMaxThreads());
+
+  bool csr = check<Galois::Graph::LC_CSR_Graph<void, void> >(file);
+  bool inlineEdge = check<Galois::Graph::LC_InlineEdge_Graph<void, void> >(file);
+  std::cout << "LC_CSR_Graph: " << csr << " LC_InlineEdge_Graph: " << inlineEdge << "\n";
+  return csr && inlineEdge ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+#include "Galois/SparseBitVector.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <vector>
+
+const unsigned numSets = 64;
+const unsigned maxBit = 1 << 14;
+
+//! Checks that a bit vector holds exactly the elements of a reference set
+bool same(const Galois::SparseBitVector& v, const std::set<unsigned>& s) {
+  std::vector<unsigned> bits;
+  v.getAllSetBits(bits);
+  if (v.count() != s.size())
+    return false;
+  return std::vector<unsigned>(s.begin(), s.end()) == bits;
+}
+
+int main() {
+  std::vector<Galois::SparseBitVector> vs(numSets);
+  std::vector<std::set<unsigned> > ss(numSets);
+  bool ok = true;
+
+  srand(0);
+  for (unsigned i = 0; i < numSets; ++i) {
+    // Mix of clustered and scattered bits
+    unsigned n = rand() % 200;
+    for (unsigned j = 0; j < n; ++j) {
+      unsigned bit = (j % 2) ? rand() % maxBit : (i * 300 + j) % maxBit;
+      ok &= vs[i].set(bit) == ss[i].insert(bit).second;
+    }
+    ok &= same(vs[i], ss[i]);
+  }
+  std::cout << "set: " << ok << "\n";
+
+  for (unsigned k = 0; k < 4 * numSets; ++k) {
+    unsigned a = rand() % numSets;
+    unsigned b = rand() % numSets;
+    bool subset = std::includes(ss[b].begin(), ss[b].end(), ss[a].begin(), ss[a].end());
+    ok &= vs[a].isSubsetEq(vs[b]) == subset;
+
+    size_t before = ss[a].size();
+    ss[a].insert(ss[b].begin(), ss[b].end());
+    ok &= vs[a].unify(vs[b]) == ss[a].size() - before;
+    ok &= same(vs[a], ss[a]) && vs[b].isSubsetEq(vs[a]);
+  }
+  std::cout << "unify: " << ok << "\n";
+
+  Galois::SparseBitVector copy(vs[0]);
+  ok &= copy.equals(vs[0]) && copy.hash() == vs[0].hash() && same(copy, ss[0]);
+  copy.set(maxBit);
+  ok &= !copy.equals(vs[0]) && copy.test(maxBit) && !vs[0].test(maxBit);
+  std::cout << "copy: " << ok << "\n";
+
+  return ok ? 0 : 1;
+}
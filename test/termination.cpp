@@ -0,0 +1,62 @@
+#include "Galois/Galois.h"
+#include "Galois/Timer.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <iostream>
+
+const unsigned iter = 16*1024;
+const unsigned chainLength = 64;
+
+typedef boost::counting_iterator<unsigned> Iter;
+
+//! Does no work, so a loop is dominated by detecting its termination
+struct Empty {
+  typedef int tt_does_not_need_aborts;
+  typedef int tt_does_not_need_push;
+  void operator()(unsigned, Galois::UserContext<unsigned>&) { }
+};
+
+//! Each item spawns a chain of items one after another, so threads keep going
+//! idle while others still have work
+struct Chain {
+  typedef int tt_does_not_need_aborts;
+  unsigned* count;
+  unsigned stride;
+  void operator()(unsigned n, Galois::UserContext<unsigned>& ctx) {
+    __sync_fetch_and_add(count, 1);
+    if (n + stride < stride * chainLength)
+      ctx.push(n + stride);
+  }
+};
+
+int main() {
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+
+  std::cout << "Iter: " << iter << "\n";
+
+  while (M) {
+    Galois::setActiveThreads(M);
+    std::cout << "Using " << M << " threads\n";
+
+    Galois::Timer t;
+    t.start();
+    for (unsigned x = 0; x < iter; ++x)
+      Galois::for_each(Iter(0), Iter(M), Empty());
+    t.stop();
+    std::cout << "Termination latency (us): " << t.get_usec() / (double) iter << "\n";
+
+    unsigned count = 0;
+    Chain chain = { &count, M };
+    for (unsigned x = 0; x < iter / 64; ++x)
+      Galois::for_each(Iter(0), Iter(M), chain);
+    bool eq = count == (iter / 64) * M * chainLength;
+    std::cout << "Chains complete: " << eq << "\n";
+    ok &= eq;
+
+    M >>= 1;
+  }
+
+  return ok ? 0 : 1;
+}
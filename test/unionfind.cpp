@@ -0,0 +1,73 @@
+#include "Galois/Galois.h"
+#include "Galois/UnionFind.h"
+
+#include <boost/iterator/counting_iterator.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+const unsigned numGroups = 37;
+const unsigned numIds = numGroups * 2048;
+
+typedef Galois::UnionFind<> UnionFind;
+
+//! Merges ids a fixed number of groups apart, so ids with equal id % numGroups end up together
+struct Merge {
+  UnionFind& uf;
+  void operator()(unsigned i) {
+    uf.merge(i, (i + numGroups * (1 + i % 5)) % numIds);
+  }
+};
+
+bool check(UnionFind& uf) {
+  std::vector<unsigned> reps(numGroups, ~0U);
+  size_t numReps = 0;
+  for (unsigned i = 0; i < numIds; ++i) {
+    unsigned r = uf.find(i);
+    if (reps[i % numGroups] == ~0U)
+      reps[i % numGroups] = r;
+    if (reps[i % numGroups] != r || r % numGroups != i % numGroups)
+      return false;
+    if (uf.isRep(i))
+      ++numReps;
+  }
+  return numReps == numGroups;
+}
+
+int main() {
+  unsigned M = Galois::Runtime::LL::getMaxThreads();
+  bool ok = true;
+
+  std::vector<UnionFind::Edge> edges;
+  srand(0);
+  for (unsigned i = 0; i < 8 * numIds; ++i) {
+    unsigned a = rand() % numIds;
+    unsigned b = (a + numGroups * (rand() % 100)) % numIds;
+    edges.push_back(UnionFind::Edge(a, b));
+  }
+  // Ensure every group is connected
+  for (unsigned i = 0; i + numGroups < numIds; ++i)
+    edges.push_back(UnionFind::Edge(i + numGroups, i));
+
+  while (M) {
+    Galois::setActiveThreads(M);
+
+    UnionFind uf(numIds);
+    Merge merge = { uf };
+    Galois::do_all(boost::counting_iterator<unsigned>(0), boost::counting_iterator<unsigned>(numIds), merge);
+    uf.mergeEdges(edges.begin(), edges.end());
+    bool merged = check(uf) && uf.sameSet(0, numGroups) && !uf.sameSet(0, 1);
+
+    UnionFind batch(numIds);
+    size_t merges = batch.mergeEdges(edges.begin(), edges.end());
+    bool batched = check(batch) && merges == numIds - numGroups;
+
+    std::cout << "Using " << M << " threads merge: " << merged << " mergeEdges: " << batched << "\n";
+    ok &= merged && batched;
+
+    M >>= 1;
+  }
+
+  return ok ? 0 : 1;
+}
@@ -24,6 +24,10 @@
 #include "Galois/config.h"
 #include "Galois/LargeArray.h"
 #include "Galois/Graph/FileGraph.h"
+#include "Galois/Graph/CompressedGraphFormat.h"
+#ifndef GALOIS_FORCE_NO_THREADS
+#include "Galois/Threads.h"
+#endif
 
 #include "llvm/Support/CommandLine.h"
 
@@ -50,6 +54,7 @@ enum ConvertMode {
   gr2doublemtx,
   gr2floatmtx,
   gr2floatpbbsedges,
+  gr2intcgr,
   gr2intpbbs,
   gr2intpbbsedges,
   gr2lowdegreeintgr,
@@ -80,6 +85,7 @@ enum ConvertMode {
   vgr2treevgr,
   vgr2trivgr,
   vgr2tvgr,
+  vgr2vcgr,
   vgr2vbinpbbs32,
   vgr2vbinpbbs64
 };
@@ -98,6 +104,7 @@ static cll::opt<ConvertMode> convertMode(cll::desc("Choose a conversion mode:"),
       clEnumVal(gr2doublemtx, "Convert binary gr to matrix market format"),
       clEnumVal(gr2floatmtx, "Convert binary gr to matrix market format"),
       clEnumVal(gr2floatpbbsedges, "Convert binary gr to weighted (float) pbbs edge list"),
+      clEnumVal(gr2intcgr, "Convert binary weighted (int) gr to compressed cgr"),
       clEnumVal(gr2intpbbs, "Convert binary gr to weighted (int) pbbs graph"),
       clEnumVal(gr2intpbbsedges, "Convert binary gr to weighted (int) pbbs edge list"),
       clEnumVal(gr2lowdegreeintgr, "Remove high degree nodes from binary gr"),
@@ -128,6 +135,7 @@ static cll::opt<ConvertMode> convertMode(cll::desc("Choose a conversion mode:"),
       clEnumVal(vgr2treevgr, "Convert binary gr to strongly connected graph by adding tree overlay"),
       clEnumVal(vgr2trivgr, "Convert symmetric binary void gr to triangular form by removing reverse edges"),
       clEnumVal(vgr2tvgr, "Transpose binary gr"),
+      clEnumVal(vgr2vcgr, "Convert binary void gr to compressed cgr"),
       clEnumVal(vgr2vbinpbbs32, "Convert binary gr to unweighted binary pbbs graph"),
       clEnumVal(vgr2vbinpbbs64, "Convert binary gr to unweighted binary pbbs graph"),
       clEnumValEnd), cll::Required);
@@ -137,6 +145,9 @@ static cll::opt<int> maxValue("maxValue",
     cll::desc("maximum weight to add (tree/ring edges are maxValue + 1)"), cll::init(100));
 static cll::opt<int> maxDegree("maxDegree",
     cll::desc("maximum degree to keep"), cll::init(2*1024));
+#ifndef GALOIS_FORCE_NO_THREADS
+static cll::opt<int> numThreads("t", cll::desc("Number of threads"), cll::init(1));
+#endif
 
 static void printStatus(size_t in_nodes, size_t in_edges, size_t out_nodes, size_t out_edges) {
   std::cout << "InGraph : |V| = " << in_nodes << ", |E| = " << in_edges << "\n";
@@ -1030,52 +1041,25 @@ void partition_by_destination(const std::string& infilename, const std::string&
 template<typename EdgeTy>
 void transpose(const std::string& infilename, const std::string& outfilename) {
   typedef Galois::Graph::FileGraph Graph;
-  typedef Graph::GraphNode GNode;
-  typedef Galois::Graph::FileGraphWriter Writer;
-  typedef Galois::LargeArray<EdgeTy> EdgeData;
-  typedef typename EdgeData::value_type edge_value_type;
   
-  Graph graph;
+  Graph graph, outgraph;
   graph.structureFromFile(infilename);
 
-  Writer p;
-  EdgeData edgeData;
-
-  p.setNumNodes(graph.size());
-  p.setNumEdges(graph.sizeEdges());
-  p.setSizeofEdgeData(EdgeData::size_of::value);
-  edgeData.create(graph.sizeEdges());
-
-  p.phase1();
-  for (Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-    GNode src = *ii;
-
-    for (Graph::edge_iterator jj = graph.edge_begin(src), ej = graph.edge_end(src); jj != ej; ++jj) {
-      GNode dst = graph.getEdgeDst(jj);
-      p.incrementDegree(dst);
-    }
-  }
+  Galois::Graph::transpose<EdgeTy>(graph, outgraph);
+  outgraph.structureToFile(outfilename);
+  printStatus(graph.size(), graph.sizeEdges(), outgraph.size(), outgraph.sizeEdges());
+}
 
-  p.phase2();
-  for (Graph::iterator ii = graph.begin(), ei = graph.end(); ii != ei; ++ii) {
-    GNode src = *ii;
+//! Compress adjacency lists with group varint encoding
+template<typename EdgeTy>
+void compress_graph(const std::string& infilename, const std::string& outfilename) {
+  typedef Galois::Graph::FileGraph Graph;
 
-    for (Graph::edge_iterator jj = graph.edge_begin(src), ej = graph.edge_end(src); jj != ej; ++jj) {
-      GNode dst = graph.getEdgeDst(jj);
-      if (EdgeData::has_value) {
-        edgeData.set(p.addNeighbor(dst, src), graph.getEdgeData<edge_value_type>(jj));
-      } else {
-        p.addNeighbor(dst, src);
-      }
-    }
-  }
+  Graph graph;
+  graph.structureFromFile(infilename);
 
-  edge_value_type* rawEdgeData = p.finish<edge_value_type>();
-  if (EdgeData::has_value)
-    std::copy(edgeData.begin(), edgeData.end(), rawEdgeData);
-  
-  p.structureToFile(outfilename);
-  printStatus(graph.size(), graph.sizeEdges(), p.size(), p.sizeEdges());
+  Galois::Graph::writeCompressedGraph<EdgeTy>(graph, outfilename);
+  printStatus(graph.size(), graph.sizeEdges());
 }
 
 template<typename GraphNode,typename EdgeTy>
@@ -1736,6 +1720,9 @@ void convert_gr2bsml(const std::string& infilename, const std::string& outfilena
 
 int main(int argc, char** argv) {
   llvm::cl::ParseCommandLineOptions(argc, argv);
+#ifndef GALOIS_FORCE_NO_THREADS
+  Galois::setActiveThreads(numThreads);
+#endif
   switch (convertMode) {
     case dimacs2gr: convert_dimacs2gr(inputfilename, outputfilename); break;
     case edgelist2vgr: convert_edgelist2gr<void>(inputfilename, outputfilename); break;
@@ -1747,6 +1734,7 @@ int main(int argc, char** argv) {
     case gr2doublemtx: convert_gr2mtx<double>(inputfilename, outputfilename); break;
     case gr2floatmtx: convert_gr2mtx<float>(inputfilename, outputfilename); break;
     case gr2floatpbbsedges: convert_gr2pbbsedges<float>(inputfilename, outputfilename); break;
+    case gr2intcgr: compress_graph<int32_t>(inputfilename, outputfilename); break;
 #if !defined(__IBMCPP__) || __IBMCPP__ > 1210
     case gr2intpbbs: convert_gr2pbbs<int32_t,int32_t>(inputfilename, outputfilename); break;
 #endif
@@ -1784,6 +1772,7 @@ int main(int argc, char** argv) {
     case vgr2treevgr: add_tree<void>(inputfilename, outputfilename, maxValue); break;
     case vgr2trivgr: convert_sgr2gr<void>(inputfilename, outputfilename); break;
     case vgr2tvgr: transpose<void>(inputfilename, outputfilename); break;
+    case vgr2vcgr: compress_graph<void>(inputfilename, outputfilename); break;
 #if !defined(__IBMCPP__) || __IBMCPP__ > 1210
     case vgr2vbinpbbs32: convert_gr2vbinpbbs<uint32_t,uint32_t>(inputfilename, outputfilename); break;
     case vgr2vbinpbbs64: convert_gr2vbinpbbs<uint32_t,uint64_t>(inputfilename, outputfilename); break;